@@ -0,0 +1,481 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "benchmark.h"
+
+//the number of back-to-back clock readings the overhead of reading the clock is measured from
+#define TIMER_CALIBRATION_READS 1000
+
+double benchNow()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+//measures the overhead of reading the clock once, the smallest difference of two back-to-back readings
+//returns: the overhead in nanoseconds
+static double timerOverhead()
+{
+	static double overhead = -1.0;
+
+	if (overhead < 0.0)
+	{
+		overhead = 1e9;
+		for (int i = 0; i < TIMER_CALIBRATION_READS; ++i)
+		{
+			double start = benchNow();
+			double end = benchNow();
+			if (end - start < overhead)
+			{
+				overhead = end - start;
+			}
+		}
+	}
+
+	return overhead;
+}
+
+//compares two times for sorting with qsort
+//a: pointer to the first time
+//b: pointer to the second time
+//returns: a negative number, zero or a positive number if the first time is smaller, equal or greater
+static int compareTimes(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+//runs an operation a number of times and measures the time it took
+//without a setup all the runs are timed together, with one every run is timed on its own and the overhead of reading the clock is subtracted
+//function: the measured operation
+//setup: the preparation of every run, NULL if the runs need none
+//context: the data passed to the functions
+//repeats: the number of runs
+//counters: pointer to the hardware counters that run while the runs are timed, NULL if they are not counted
+//nanoseconds: pointer to where the total time of the runs is saved
+//returns: 0 on success, -1 if a run or its preparation failed
+static int timeRuns(BenchFunction function, BenchFunction setup, void* context, long long repeats, PerfCounters* counters, double* nanoseconds)
+{
+	if (setup == NULL)
+	{
+		if (counters != NULL)
+		{
+			startPerfCounters(counters);
+		}
+		double start = benchNow();
+		int failed = 0;
+		for (long long i = 0; i < repeats && !failed; ++i)
+		{
+			failed = function(context) == -1;
+			benchEscape(context);
+		}
+		*nanoseconds = benchNow() - start;
+		if (counters != NULL)
+		{
+			stopPerfCounters(counters);
+		}
+
+		return failed ? -1 : 0;
+	}
+
+	double overhead = timerOverhead();
+	double total = 0.0;
+	for (long long i = 0; i < repeats; ++i)
+	{
+		if (setup(context) == -1)
+		{
+			return -1;
+		}
+		benchEscape(context);
+
+		if (counters != NULL)
+		{
+			startPerfCounters(counters);
+		}
+		double start = benchNow();
+		int failed = function(context) == -1;
+		benchEscape(context);
+		double time = benchNow() - start - overhead;
+		if (counters != NULL)
+		{
+			stopPerfCounters(counters);
+		}
+
+		if (failed)
+		{
+			return -1;
+		}
+		total += time > 0.0 ? time : 0.0;
+	}
+	*nanoseconds = total;
+
+	return 0;
+}
+
+void initBenchOptions(BenchOptions* options)
+{
+	options->numWarmups = BENCH_DEFAULT_WARMUPS;
+	options->numTrials = BENCH_DEFAULT_TRIALS;
+	options->reportFile = NULL;
+	options->reportFormat = BENCH_CSV;
+	options->perfCounters = 0;
+}
+
+int parseBenchOption(int argc, char* argv[], int* i, BenchOptions* options)
+{
+	if (strcmp(argv[*i], "--perf") == 0)
+	{
+		options->perfCounters = 1;
+		return 1;
+	}
+
+	if (strcmp(argv[*i], "--warmup") != 0 && strcmp(argv[*i], "--trials") != 0 && strcmp(argv[*i], "--report") != 0
+		&& strcmp(argv[*i], "--report-format") != 0)
+	{
+		return 0;
+	}
+
+	if (*i + 1 >= argc)
+	{
+		printf("Error: option %s requires a value!\n", argv[*i]);
+		return -1;
+	}
+
+	char* option = argv[*i];
+	char* value = argv[++*i];
+	if (strcmp(option, "--warmup") == 0)
+	{
+		options->numWarmups = atoi(value);
+		if (options->numWarmups < 0)
+		{
+			printf("Error: the number of warm-up trials must not be negative!\n");
+			return -1;
+		}
+	}
+	else if (strcmp(option, "--trials") == 0)
+	{
+		options->numTrials = atoi(value);
+		if (options->numTrials < 1)
+		{
+			printf("Error: the number of trials must be greater than 0!\n");
+			return -1;
+		}
+	}
+	else if (strcmp(option, "--report") == 0)
+	{
+		options->reportFile = value;
+	}
+	else if (strcmp(value, "csv") == 0)
+	{
+		options->reportFormat = BENCH_CSV;
+	}
+	else if (strcmp(value, "json") == 0)
+	{
+		options->reportFormat = BENCH_JSON;
+	}
+	else
+	{
+		printf("Error: unknown report format %s!\n", value);
+		return -1;
+	}
+
+	return 1;
+}
+
+int runBenchmark(BenchResult* result, const char* name, BenchFunction function, BenchFunction setup, void* context, long long opsPerRun,
+	const BenchOptions* options)
+{
+	double* times = (double*)malloc(sizeof(double) * options->numTrials);
+	if (times == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	result->name = name;
+	result->numTrials = options->numTrials;
+	result->opsPerRun = opsPerRun;
+	result->totalRuns = 0;
+	result->counts.measured = 0;
+
+	//double the number of repeats until a trial is long enough, these runs warm up the caches and the branch predictors too
+	long long repeats = 1;
+	double time;
+	while (1)
+	{
+		if (timeRuns(function, setup, context, repeats, NULL, &time) == -1)
+		{
+			free(times);
+			return -1;
+		}
+		result->totalRuns += repeats;
+
+		if (time >= BENCH_MIN_TRIAL_TIME * 1e9 || repeats >= BENCH_MAX_REPEATS)
+		{
+			break;
+		}
+		repeats *= 2;
+	}
+	result->repeats = repeats;
+
+	//the counters run only during the timed trials, a counter that cannot be opened is left out
+	PerfCounters counters;
+	if (options->perfCounters)
+	{
+		openPerfCounters(&counters);
+	}
+
+	for (int i = 0; i < options->numWarmups + options->numTrials; ++i)
+	{
+		PerfCounters* trialCounters = options->perfCounters && i >= options->numWarmups ? &counters : NULL;
+		if (timeRuns(function, setup, context, repeats, trialCounters, &time) == -1)
+		{
+			if (options->perfCounters)
+			{
+				closePerfCounters(&counters);
+			}
+			free(times);
+			return -1;
+		}
+		result->totalRuns += repeats;
+
+		if (i >= options->numWarmups)
+		{
+			times[i - options->numWarmups] = time / ((double)repeats * opsPerRun);
+		}
+	}
+
+	int numTrials = options->numTrials;
+	if (options->perfCounters)
+	{
+		readPerfCounters(&counters, &result->counts);
+		scalePerfCounts(&result->counts, (double)numTrials * repeats * opsPerRun);
+		closePerfCounters(&counters);
+	}
+
+	qsort(times, numTrials, sizeof(double), compareTimes);
+
+	double total = 0.0;
+	for (int i = 0; i < numTrials; ++i)
+	{
+		total += times[i];
+	}
+
+	//the 99th percentile is taken by the nearest rank, with fewer than 100 trials it is the slowest trial
+	int p99Rank = (numTrials * 99 + 99) / 100;
+	result->min = times[0];
+	result->median = numTrials % 2 == 1 ? times[numTrials / 2] : (times[numTrials / 2 - 1] + times[numTrials / 2]) / 2;
+	result->p99 = times[p99Rank - 1];
+	result->mean = total / numTrials;
+
+	free(times);
+
+	return 0;
+}
+
+void singleBenchResult(BenchResult* result, const char* name, double nanoseconds, long long opsPerRun)
+{
+	result->name = name;
+	result->numTrials = 1;
+	result->repeats = 1;
+	result->opsPerRun = opsPerRun;
+	result->totalRuns = 1;
+	result->min = nanoseconds;
+	result->median = nanoseconds;
+	result->p99 = nanoseconds;
+	result->mean = nanoseconds;
+	result->counts.measured = 0;
+}
+
+void printBenchResult(const char* name, const BenchResult* result, const char* note)
+{
+	if (note != NULL)
+	{
+		printf("  Time to %s: %f ms (%s)\n", name, result->median / 1e6, note);
+	}
+	else if (result->numTrials > 1)
+	{
+		printf("  Time to %s: %f ms (median of %d trials of %lld runs, min %f ms, p99 %f ms)\n", name, result->median / 1e6, result->numTrials,
+			result->repeats, result->min / 1e6, result->p99 / 1e6);
+	}
+	else
+	{
+		printf("  Time to %s: %f ms\n", name, result->median / 1e6);
+	}
+}
+
+void printBenchCounters(const BenchResult** results, int count)
+{
+	int measured = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		measured |= results[i]->counts.measured;
+	}
+	if (!measured)
+	{
+		return;
+	}
+
+	printf("Hardware counters per operation:\n\n");
+	printf("  %-26s", "");
+	for (int i = 0; i < count; ++i)
+	{
+		printf("%14s", results[i]->name);
+	}
+	printf("\n");
+
+	for (int event = 0; event < PERF_NUM_EVENTS; ++event)
+	{
+		printf("  %-26s", perfEventName((PerfEvent)event));
+		for (int i = 0; i < count; ++i)
+		{
+			const PerfCounts* counts = &results[i]->counts;
+			if (counts->measured && counts->available[event])
+			{
+				printf("%14.2f", counts->values[event]);
+			}
+			else
+			{
+				printf("%14s", counts->measured ? "n/a" : "-");
+			}
+		}
+		printf("\n");
+	}
+
+	//the reason why counters are missing, typically a virtual machine without a PMU or a restrictive perf_event_paranoid
+	for (int i = 0; i < count; ++i)
+	{
+		if (results[i]->counts.measured && results[i]->counts.error != 0)
+		{
+			printf("  (n/a: perf_event_open failed: %s)\n", strerror(results[i]->counts.error));
+			break;
+		}
+	}
+	printf("\n");
+}
+
+//writes a string as a JSON string, escaping the quotes, backslashes and control characters
+//file: the file the string is written to
+//string: the string
+static void writeJsonString(FILE* file, const char* string)
+{
+	fputc('"', file);
+	for (const char* c = string; *c != '\0'; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			fprintf(file, "\\%c", *c);
+		}
+		else if ((unsigned char)*c < 0x20)
+		{
+			fprintf(file, "\\u%04x", (unsigned char)*c);
+		}
+		else
+		{
+			fputc(*c, file);
+		}
+	}
+	fputc('"', file);
+}
+
+int writeBenchReport(const BenchOptions* options, const BenchRun* run, const BenchResult* results, int count)
+{
+	FILE* file = fopen(options->reportFile, "a");
+	if (file == NULL)
+	{
+		printf("Error: cannot open report file %s!\n", options->reportFile);
+		return -1;
+	}
+
+	//a new CSV report starts with the names of the columns
+	fseek(file, 0, SEEK_END);
+	if (options->reportFormat == BENCH_CSV && ftell(file) == 0)
+	{
+		fprintf(file, "program,method,input_file,input_size,table_size,search_size,phase,trials,repeats,ops_per_run,min_ns,median_ns,p99_ns,mean_ns");
+		for (int event = 0; event < PERF_NUM_EVENTS; ++event)
+		{
+			fprintf(file, ",%s", perfEventColumn((PerfEvent)event));
+		}
+		fprintf(file, "\n");
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		const BenchResult* result = &results[i];
+		if (options->reportFormat == BENCH_CSV)
+		{
+			//the file name is the only field that may contain a comma
+			fprintf(file, "%s,%s,", run->program, run->method);
+			if (strpbrk(run->inputFile, ",\"\n") != NULL)
+			{
+				fputc('"', file);
+				for (const char* c = run->inputFile; *c != '\0'; ++c)
+				{
+					if (*c == '"')
+					{
+						fputc('"', file);
+					}
+					fputc(*c, file);
+				}
+				fputc('"', file);
+			}
+			else
+			{
+				fprintf(file, "%s", run->inputFile);
+			}
+			fprintf(file, ",%lld,%lld,%lld,%s,%d,%lld,%lld,%.3f,%.3f,%.3f,%.3f", run->inputSize, run->tableSize, run->searchSize, result->name,
+				result->numTrials, result->repeats, result->opsPerRun, result->min, result->median, result->p99, result->mean);
+
+			//the events that were not counted are left empty
+			for (int event = 0; event < PERF_NUM_EVENTS; ++event)
+			{
+				if (result->counts.measured && result->counts.available[event])
+				{
+					fprintf(file, ",%.3f", result->counts.values[event]);
+				}
+				else
+				{
+					fprintf(file, ",");
+				}
+			}
+			fprintf(file, "\n");
+		}
+		else
+		{
+			fprintf(file, "{\"program\":\"%s\",\"method\":\"%s\",\"input_file\":", run->program, run->method);
+			writeJsonString(file, run->inputFile);
+			fprintf(file, ",\"input_size\":%lld,\"table_size\":%lld,\"search_size\":%lld,\"phase\":\"%s\",\"trials\":%d,\"repeats\":%lld,"
+				"\"ops_per_run\":%lld,\"min_ns\":%.3f,\"median_ns\":%.3f,\"p99_ns\":%.3f,\"mean_ns\":%.3f", run->inputSize, run->tableSize,
+				run->searchSize, result->name, result->numTrials, result->repeats, result->opsPerRun, result->min, result->median, result->p99,
+				result->mean);
+
+			//the events that were not counted are null
+			for (int event = 0; event < PERF_NUM_EVENTS; ++event)
+			{
+				if (result->counts.measured && result->counts.available[event])
+				{
+					fprintf(file, ",\"%s\":%.3f", perfEventColumn((PerfEvent)event), result->counts.values[event]);
+				}
+				else
+				{
+					fprintf(file, ",\"%s\":null", perfEventColumn((PerfEvent)event));
+				}
+			}
+			fprintf(file, "}\n");
+		}
+	}
+
+	if (fclose(file) != 0)
+	{
+		printf("Error: cannot write report file %s!\n", options->reportFile);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "perfcounters.h"
+
+//the benchmark harness of both programs, it measures the storage and retrieval phases instead of timing every call with clock()
+//time is read from the monotonic clock, which has nanosecond resolution and on x86 is read from the TSC without a system call
+//a measured operation is first repeated until one trial takes at least BENCH_MIN_TRIAL_TIME, so that reading the clock
+//costs nothing next to it, then it runs a number of untimed warm-up trials and a number of timed trials,
+//and the result is the minimum, median and 99th percentile of the time of one operation over the trials
+//the results can be appended to a report file as CSV or JSON lines, so that runs of both programs collect into one table
+//with --perf the hardware counters of perfcounters.h run during the timed trials and their counts per operation are reported too
+
+//the minimum time of one trial in seconds, the operation is repeated within a trial until it takes this long
+#define BENCH_MIN_TRIAL_TIME 0.01
+
+//the maximum number of times an operation is repeated within one trial
+#define BENCH_MAX_REPEATS (1LL << 30)
+
+//the default number of untimed warm-up trials
+#define BENCH_DEFAULT_WARMUPS 2
+
+//the default number of timed trials
+#define BENCH_DEFAULT_TRIALS 15
+
+//the formats of the report file
+typedef enum BenchFormat BenchFormat;
+enum BenchFormat
+{
+	BENCH_CSV, //a header line if the file is empty, then one line of comma-separated values per result
+	BENCH_JSON //one JSON object per result and line (JSON lines)
+};
+
+//the settings of the benchmark, set by the command line options of both programs
+typedef struct BenchOptions BenchOptions;
+struct BenchOptions
+{
+	int numWarmups; //the number of untimed warm-up trials (--warmup)
+	int numTrials; //the number of timed trials (--trials)
+	char* reportFile; //the file the results are appended to, NULL without a report (--report)
+	BenchFormat reportFormat; //the format of the report file (--report-format)
+	int perfCounters; //whether the hardware counters are read during the timed trials, 1 with --perf
+};
+
+//the result of measuring one operation
+typedef struct BenchResult BenchResult;
+struct BenchResult
+{
+	const char* name; //the name of the measured phase, such as "store" or "retrieve"
+	int numTrials; //the number of timed trials
+	long long repeats; //the number of times the operation ran in every trial
+	long long opsPerRun; //the number of operations, such as lookups, done by one run of the operation
+	long long totalRuns; //the number of times the operation ran, including the calibration and the warm-up
+	double min; //the time of one operation in the fastest trial, in nanoseconds
+	double median; //the median time of one operation over the trials, in nanoseconds
+	double p99; //the 99th percentile of the time of one operation over the trials, in nanoseconds
+	double mean; //the mean time of one operation over the trials, in nanoseconds
+	PerfCounts counts; //the counts of the hardware events per operation over the timed trials, measured only with --perf
+};
+
+//describes the run of a program a report line belongs to
+typedef struct BenchRun BenchRun;
+struct BenchRun
+{
+	const char* program; //"hash" or "sorted"
+	const char* method; //the engines that stored and searched the data
+	const char* inputFile; //the path to the input file
+	long long inputSize; //the number of stored values
+	long long tableSize; //the size of the hash table after storing, which it may have grown to, 0 for the sorted program
+	long long searchSize; //the number of searched values
+};
+
+//a measured operation, or the preparation of one run of it
+//context: the data of the operation
+//returns: 0 on success, -1 if the operation failed, which ends the benchmark
+typedef int (*BenchFunction)(void* context);
+
+//returns the time of the monotonic clock
+//returns: the time in nanoseconds
+double benchNow();
+
+//keeps the compiler from removing the computation of a value that is never used, the memory it points to counts as read and written
+//pointer: pointer to the value
+static inline void benchEscape(void* pointer)
+{
+	__asm__ volatile("" : : "g"(pointer) : "memory");
+}
+
+//sets the default settings of the benchmark
+//options: pointer to the settings
+void initBenchOptions(BenchOptions* options);
+
+//parses one command line option of the benchmark, --perf takes no value, the other options take one
+//argc: the number of arguments
+//argv: the arguments
+//i: pointer to the index of the option, it is moved to its value if the option has one
+//options: pointer to the settings that are changed
+//returns: 1 if the option was parsed, 0 if it is not an option of the benchmark, -1 if its value is missing or invalid
+int parseBenchOption(int argc, char* argv[], int* i, BenchOptions* options);
+
+//measures an operation: calibrates the number of repeats per trial, runs the warm-up trials and then the timed trials
+//result: pointer to the structure where the result is saved
+//name: the name of the measured phase
+//function: the measured operation, the context is escaped after every run so its results are never optimized away
+//setup: the preparation of every run, such as restoring the unsorted data, it is not timed, NULL if the runs need none
+//context: the data passed to the functions
+//opsPerRun: the number of operations one run does, the times are divided by it
+//options: pointer to the settings of the benchmark
+//returns: 0 on success, -1 if the operation or its preparation failed or the memory could not be allocated, which is reported
+int runBenchmark(BenchResult* result, const char* name, BenchFunction function, BenchFunction setup, void* context, long long opsPerRun,
+	const BenchOptions* options);
+
+//records a single measurement as the result of one trial, for phases that can only run once, such as mapping a snapshot
+//the hardware events are not counted, the caller may set the counts afterwards
+//result: pointer to the structure where the result is saved
+//name: the name of the measured phase
+//nanoseconds: the time of one operation
+//opsPerRun: the number of operations the measurement covered
+void singleBenchResult(BenchResult* result, const char* name, double nanoseconds, long long opsPerRun);
+
+//prints a line with the time of one operation in miliseconds and its spread over the trials
+//name: what was measured, it is printed after "Time to"
+//result: pointer to the result
+//note: printed in brackets instead of the spread, NULL to print the spread of a result of more than one trial
+void printBenchResult(const char* name, const BenchResult* result, const char* note);
+
+//prints the section with the counts of the hardware events per operation, one column per result, nothing if no result has counts
+//results: array of pointers to the results
+//count: the number of results
+void printBenchCounters(const BenchResult** results, int count);
+
+//appends the results of a run to the report file
+//options: pointer to the settings of the benchmark with the name and format of the report file
+//run: pointer to the description of the run
+//results: array of the results
+//count: the number of results
+//returns: 0 on success, -1 if the file could not be written
+int writeBenchReport(const BenchOptions* options, const BenchRun* run, const BenchResult* results, int count);
+
+#endif
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bloomfilter.h"
+
+#define BLOOM_ALIGNMENT 64 //the alignment of the blocks, a block never crosses a cache line
+
+void initBloomFilter(BloomFilter* filter)
+{
+	filter->blocks = NULL;
+	filter->numBlocks = 0;
+	filter->numKeys = 0;
+	filter->bitsPerKey = 0;
+}
+
+int createBloomFilter(BloomFilter* filter, int count, int bitsPerKey)
+{
+	deleteBloomFilter(filter);
+
+	//at least one block, the number of blocks fits into an unsigned int since count and bitsPerKey are ints
+	unsigned long long numBits = (unsigned long long)(count > 0 ? count : 1) * (unsigned long long)bitsPerKey;
+	unsigned long long blockBits = BLOOM_BLOCK_WORDS * 32;
+	unsigned int numBlocks = (unsigned int)((numBits + blockBits - 1) / blockBits);
+
+	//aligned_alloc requires the size to be a multiple of the alignment
+	size_t bytes = (size_t)numBlocks * BLOOM_BLOCK_WORDS * sizeof(unsigned int);
+	bytes = (bytes + BLOOM_ALIGNMENT - 1) / BLOOM_ALIGNMENT * BLOOM_ALIGNMENT;
+	filter->blocks = (unsigned int*)aligned_alloc(BLOOM_ALIGNMENT, bytes);
+	if (filter->blocks == NULL)
+	{
+		return -1;
+	}
+	memset(filter->blocks, 0, bytes);
+
+	filter->numBlocks = numBlocks;
+	filter->bitsPerKey = bitsPerKey;
+
+	return 0;
+}
+
+void bloomAdd(BloomFilter* filter, int key)
+{
+	unsigned long long hash = bloomHash(key);
+	unsigned int* block = (unsigned int*)bloomBlock(filter, hash);
+	unsigned int low = (unsigned int)hash;
+
+	for (int i = 0; i < BLOOM_BLOCK_WORDS; ++i)
+	{
+		block[i] |= 1u << ((low * BLOOM_SALTS[i]) >> 27);
+	}
+	filter->numKeys++;
+}
+
+size_t bloomFilterBytes(const BloomFilter* filter)
+{
+	return (size_t)filter->numBlocks * BLOOM_BLOCK_WORDS * sizeof(unsigned int);
+}
+
+void printBloomFilter(const BloomFilter* filter, double buildTime, long long numMisses, long long numFalsePositives)
+{
+	printf("\nFilter details:\n\n");
+	printf("  Split block Bloom filter of %zu bytes in %u blocks of %d bits, %.2f bits per item, built in %f ms\n", bloomFilterBytes(filter),
+		filter->numBlocks, BLOOM_BLOCK_WORDS * 32, filter->numKeys > 0 ? bloomFilterBytes(filter) * 8.0 / filter->numKeys : 0.0, buildTime);
+	if (numMisses > 0)
+	{
+		printf("  %lld of %lld searches of items not found were rejected by the filter, false positive rate %.3f%%\n", numMisses - numFalsePositives,
+			numMisses, numFalsePositives * 100.0 / numMisses);
+	}
+	else
+	{
+		printf("  Every searched item was found, the false positive rate was not measured\n");
+	}
+}
+
+void deleteBloomFilter(BloomFilter* filter)
+{
+	free(filter->blocks);
+	initBloomFilter(filter);
+}
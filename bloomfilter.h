@@ -0,0 +1,112 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <stddef.h>
+
+//split block Bloom filter, an approximate membership filter that is checked before the stored structure is searched
+//the filter is an array of blocks of BLOOM_BLOCK_WORDS 32-bit words, every key selects one block by its hash
+//and sets one bit in every word of the block, so a check reads a single block, which never crosses a cache line
+//a key that was added is always found, a key that was not added is rejected unless all its bits happen to be set (a false positive)
+//with 10 bits per key about 1% of the keys that were not added pass
+
+//the number of 32-bit words of a block, the number of bits set per key
+#define BLOOM_BLOCK_WORDS 8
+
+//the default number of bits of the filter per key
+#define BLOOM_DEFAULT_BITS 10
+
+//the Bloom filter
+typedef struct BloomFilter BloomFilter;
+struct BloomFilter
+{
+	unsigned int* blocks; //the words of all the blocks, aligned to a cache line, NULL if there is no filter
+	unsigned int numBlocks; //the number of blocks
+	int numKeys; //the number of keys added to the filter
+	int bitsPerKey; //the number of bits per key the filter was sized for
+};
+
+//the multipliers selecting the bit of a key in every word of a block
+static const unsigned int BLOOM_SALTS[BLOOM_BLOCK_WORDS] =
+{
+	0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+};
+
+//computes the 64-bit hash of a key, the high half selects the block and the low half the bits
+//key: the key
+//returns: the hash of the key
+static inline unsigned long long bloomHash(int key)
+{
+	unsigned long long x = (unsigned int)key;
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+
+	return x;
+}
+
+//returns the block of a key
+//filter: pointer to the filter
+//hash: the hash of the key
+//returns: pointer to the first word of the block
+static inline const unsigned int* bloomBlock(const BloomFilter* filter, unsigned long long hash)
+{
+	unsigned int block = (unsigned int)(((hash >> 32) * filter->numBlocks) >> 32);
+
+	return &filter->blocks[(size_t)block * BLOOM_BLOCK_WORDS];
+}
+
+//checks whether a key may have been added to the filter
+//the bits of all the words are combined without a branch, so the check is a fixed sequence of operations on one block
+//filter: pointer to the filter
+//key: the key to check
+//returns: 1 if the key may have been added, 0 if it certainly was not
+static inline int bloomMayContain(const BloomFilter* filter, int key)
+{
+	unsigned long long hash = bloomHash(key);
+	const unsigned int* block = bloomBlock(filter, hash);
+	unsigned int low = (unsigned int)hash;
+
+	unsigned int found = 1;
+	for (int i = 0; i < BLOOM_BLOCK_WORDS; ++i)
+	{
+		found &= block[i] >> ((low * BLOOM_SALTS[i]) >> 27);
+	}
+
+	return (int)(found & 1);
+}
+
+//initializes an empty filter, without any memory
+//filter: pointer to the filter
+void initBloomFilter(BloomFilter* filter);
+
+//allocates an empty filter for a number of keys, the previous memory of the filter is freed
+//filter: pointer to the filter
+//count: the number of keys that will be added
+//bitsPerKey: the number of bits per key, greater than 0
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createBloomFilter(BloomFilter* filter, int count, int bitsPerKey);
+
+//adds a key to the filter
+//filter: pointer to the filter
+//key: the key to add
+void bloomAdd(BloomFilter* filter, int key);
+
+//returns the memory of the filter
+//filter: pointer to the filter
+//returns: the number of bytes of the blocks
+size_t bloomFilterBytes(const BloomFilter* filter);
+
+//prints the details of the filter: its size, its build time and its measured false positive rate
+//filter: pointer to the filter
+//buildTime: the time in miliseconds that building the filter took
+//numMisses: the number of searched keys that were not stored
+//numFalsePositives: the number of those keys the filter passed
+void printBloomFilter(const BloomFilter* filter, double buildTime, long long numMisses, long long numFalsePositives);
+
+//frees the dynamically allocated memory associated with the filter
+//filter: pointer to the filter
+void deleteBloomFilter(BloomFilter* filter);
+
+#endif
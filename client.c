@@ -0,0 +1,232 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "loader.h"
+#include "server.h"
+
+//client of the query server of both programs (--serve): sends the values of a search file in batches,
+//prints where every value was found and measures the round trip of every batch
+//the server is reached on its Unix domain socket, or started by the client and served over its standard input and output
+
+const int DEFAULT_CLIENT_BATCH = 1000; //the default number of values of a request
+
+//optional command line settings, given after the two required arguments
+typedef struct ClientOptions ClientOptions;
+struct ClientOptions
+{
+	int batchSize; //the number of values of a request (--batch)
+	int quiet; //whether the results of the values are not printed, 1 with --quiet
+	int shutdown; //whether the server is stopped after the search file, 1 with --shutdown
+	char* command; //the command starting a server on the standard input and output, NULL for a socket (--exec)
+};
+
+//parses the optional arguments
+//argc: the number of arguments
+//argv: the arguments, the options start after the two required arguments
+//options: pointer to the structure where the settings are saved, options that are not given keep their default values
+//returns: 0 on success, -1 if an option is unknown or has an invalid value
+int parseClientOptions(int argc, char* argv[], ClientOptions* options)
+{
+	options->batchSize = DEFAULT_CLIENT_BATCH;
+	options->quiet = 0;
+	options->shutdown = 0;
+	options->command = NULL;
+
+	for (int i = 3; i < argc; ++i)
+	{
+		//options without a value
+		if (strcmp(argv[i], "--quiet") == 0)
+		{
+			options->quiet = 1;
+			continue;
+		}
+		if (strcmp(argv[i], "--shutdown") == 0)
+		{
+			options->shutdown = 1;
+			continue;
+		}
+
+		//all the other options take a value
+		if (i + 1 >= argc)
+		{
+			printf("Error: option %s requires a value!\n", argv[i]);
+			return -1;
+		}
+
+		if (strcmp(argv[i], "--batch") == 0)
+		{
+			options->batchSize = atoi(argv[++i]);
+			if (options->batchSize < 1 || options->batchSize > SERVER_MAX_BATCH)
+			{
+				printf("Error: the batch size must be from 1 to %d!\n", SERVER_MAX_BATCH);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--exec") == 0)
+		{
+			options->command = argv[++i];
+		}
+		else
+		{
+			printf("Error: unknown option %s!\n", argv[i]);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	//check the number of arguments
+	if (argc < 3)
+	{
+		printf("Error: 2 arguments required!\n");
+		return -1;
+	}
+
+	ClientOptions options;
+	if (parseClientOptions(argc, argv, &options) == -1)
+	{
+		return -1;
+	}
+
+	//"-" talks to a server started with --exec over its standard input and output
+	int pipeMode = strcmp(argv[1], "-") == 0;
+	if (pipeMode != (options.command != NULL))
+	{
+		printf("Error: --exec is required with the server \"-\" and only allowed with it!\n");
+		return -1;
+	}
+
+	int* values = (int*)malloc((size_t)options.batchSize * sizeof(int));
+	int* positions = (int*)malloc((size_t)options.batchSize * sizeof(int));
+	if (values == NULL || positions == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		free(values);
+		free(positions);
+		return -1;
+	}
+
+	IntReader reader;
+	if (openIntReader(&reader, argv[2]) == -1)
+	{
+		printf("Error: cannot open file %s!\n", argv[2]);
+		free(values);
+		free(positions);
+		return -1;
+	}
+
+	int requestFd;
+	int responseFd;
+	pid_t pid = -1;
+	if (pipeMode)
+	{
+		if (spawnServer(options.command, &requestFd, &responseFd, &pid) == -1)
+		{
+			closeIntReader(&reader, NULL);
+			free(values);
+			free(positions);
+			return -1;
+		}
+	}
+	else
+	{
+		requestFd = connectServer(argv[1]);
+		responseFd = requestFd;
+		if (requestFd == -1)
+		{
+			closeIntReader(&reader, NULL);
+			free(values);
+			free(positions);
+			return -1;
+		}
+	}
+
+	//every batch is sent once its predecessor is answered, so its round trip is measured alone
+	LatencyHistogram latencies;
+	initLatencyHistogram(&latencies);
+	long long numSearched = 0;
+	long long numFound = 0;
+	int result = 0;
+	int count;
+	double start = serverNow();
+	while ((count = readInts(&reader, values, options.batchSize)) > 0)
+	{
+		double sent = serverNow();
+		if (sendRequest(requestFd, values, (unsigned int)count) == -1 || receiveResponse(responseFd, positions, count) == -1)
+		{
+			printf("Error: the server didn't answer!\n");
+			result = -1;
+			break;
+		}
+		addLatency(&latencies, (serverNow() - sent) * 1e6);
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (positions[i] != -1)
+			{
+				numFound++;
+			}
+			if (options.quiet)
+			{
+				continue;
+			}
+			if (positions[i] != -1)
+			{
+				printf("  Value %d found at position %d\n", values[i], positions[i]);
+			}
+			else
+			{
+				printf("  Value %d not found\n", values[i]);
+			}
+		}
+		numSearched += count;
+	}
+	double seconds = serverNow() - start;
+
+	if (count == -1)
+	{
+		printf("Error: cannot read file %s!\n", argv[2]);
+		result = -1;
+	}
+	closeIntReader(&reader, NULL);
+
+	if (options.shutdown && sendRequest(requestFd, NULL, SERVER_SHUTDOWN) == -1)
+	{
+		printf("Error: cannot stop the server!\n");
+		result = -1;
+	}
+
+	//closing the pipe ends a server on the standard input and output
+	close(requestFd);
+	if (pipeMode)
+	{
+		close(responseFd);
+		waitpid(pid, NULL, 0);
+	}
+
+	if (result == 0)
+	{
+		printf("\nQuery client:\n");
+		printf("================================\n\n");
+		printf("Server: %s\n", pipeMode ? options.command : argv[1]);
+		printf("Retrieval data loaded from file %s\n", argv[2]);
+		printf("Number of items searched: %lld\n", numSearched);
+		printf("Number of items found: %lld\n\n", numFound);
+		printf("  %lld batches of up to %d items in %.3f s, %.0f items per second\n", latencies.count, options.batchSize, seconds,
+			seconds > 0.0 ? numSearched / seconds : 0.0);
+		printLatencyHistogram("Round trip of a batch", &latencies);
+		printf("\n================================\n\n");
+	}
+
+	free(values);
+	free(positions);
+
+	return result;
+}
@@ -0,0 +1,430 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "concurrenttable.h"
+#include "hashpolicy.h"
+
+//the concurrent hash table under many threads:
+//the benchmark measures the lookup throughput with 1 to N reader threads while a loader thread keeps inserting,
+//the stress test checks with several writer threads inserting the same keys that every key published by a writer is found by the readers
+
+const double BENCH_MAX_LOAD = 0.75; //the maximum load factor of the table
+const int LOOKUPS_PER_READER = 4000000; //the number of lookups every reader thread does in a benchmark round
+const int STRESS_WRITERS = 4; //the number of writer threads of the stress test
+const int MAX_READERS = 256; //the maximum number of reader threads
+
+//the arguments and the results of one thread
+typedef struct BenchThread BenchThread;
+struct BenchThread
+{
+	pthread_t thread; //the thread
+	int id; //the number of the thread among the threads with the same role
+	ConcurrentTable* table; //the shared table
+	int numKeys; //the number of keys of the run
+	atomic_int* done; //set to 1 when the threads this thread works alongside have finished, shared by all threads
+	atomic_int* progress; //the number of keys every writer has inserted, shared by all threads
+	long long numOps; //the number of lookups or inserts the thread did
+	long long numFound; //the number of lookups that found their key
+	long long numErrors; //the number of lookups that gave a wrong result, stress test only
+	double seconds; //the time the thread ran
+};
+
+//returns the current time of the monotonic clock
+//returns: the time in seconds
+double now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+//advances a xorshift random number generator
+//state: pointer to the state of the generator, not 0
+//returns: the next random number
+unsigned int nextRandom(unsigned int* state)
+{
+	unsigned int x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+
+	return x;
+}
+
+//the key number i of a run, all the keys are different
+//i: the number of the key, 0 is mapped to CONCURRENT_EMPTY so that the key stored outside of the slots is exercised too
+//returns: the key
+int keyAt(int i)
+{
+	return i == 0 ? CONCURRENT_EMPTY : 2 * i + 1;
+}
+
+//a key that is never inserted, keyAt only gives odd keys and CONCURRENT_EMPTY
+//i: any number
+//returns: the key, an even number other than CONCURRENT_EMPTY
+int missingKeyAt(int i)
+{
+	return (int)(((unsigned int)i << 2) | 2);
+}
+
+//inserts the second half of the keys of the run, the first half was inserted before the readers started
+//arg: pointer to the BenchThread
+//returns: NULL
+void* loaderWork(void* arg)
+{
+	BenchThread* bench = (BenchThread*)arg;
+	double start = now();
+
+	bench->numOps = 0;
+	for (int i = bench->numKeys / 2; i < bench->numKeys && !atomic_load_explicit(bench->done, memory_order_relaxed); ++i)
+	{
+		insertConcurrent(bench->table, keyAt(i));
+		bench->numOps++;
+	}
+
+	bench->seconds = now() - start;
+
+	return NULL;
+}
+
+//looks up LOOKUPS_PER_READER random keys, half of them from the keys of the run and half of them keys that are never inserted
+//arg: pointer to the BenchThread
+//returns: NULL
+void* readerWork(void* arg)
+{
+	BenchThread* bench = (BenchThread*)arg;
+	unsigned int state = 2463534242u + bench->id;
+	double start = now();
+
+	bench->numFound = 0;
+	for (int i = 0; i < LOOKUPS_PER_READER; ++i)
+	{
+		unsigned int r = nextRandom(&state);
+		int key = (r & 1) ? keyAt((int)((r >> 1) % bench->numKeys)) : missingKeyAt((int)(r >> 1));
+		if (searchConcurrent(bench->table, key) != -1)
+		{
+			bench->numFound++;
+		}
+	}
+	bench->numOps = LOOKUPS_PER_READER;
+
+	bench->seconds = now() - start;
+
+	return NULL;
+}
+
+//inserts all the keys of the run, every writer starts at a different key and wraps around, so every key is inserted by every writer
+//after every insert the number of inserted keys is published with a release store for the readers of the stress test
+//arg: pointer to the BenchThread
+//returns: NULL
+void* writerWork(void* arg)
+{
+	BenchThread* bench = (BenchThread*)arg;
+	int offset = (int)(((long long)bench->id * bench->numKeys) / STRESS_WRITERS);
+
+	bench->numErrors = 0;
+	for (int i = 0; i < bench->numKeys; ++i)
+	{
+		if (insertConcurrent(bench->table, keyAt((offset + i) % bench->numKeys)) == -1)
+		{
+			bench->numErrors++;
+		}
+		atomic_store_explicit(&bench->progress[bench->id], i + 1, memory_order_release);
+	}
+
+	return NULL;
+}
+
+//checks the keys published by the writers until they finish: a key a writer has inserted must be found, a key that is never inserted must not
+//arg: pointer to the BenchThread
+//returns: NULL
+void* checkerWork(void* arg)
+{
+	BenchThread* bench = (BenchThread*)arg;
+	unsigned int state = 88675123u + bench->id;
+
+	bench->numOps = 0;
+	bench->numErrors = 0;
+	while (!atomic_load_explicit(bench->done, memory_order_acquire))
+	{
+		unsigned int r = nextRandom(&state);
+		int writer = (int)(r % STRESS_WRITERS);
+		int inserted = atomic_load_explicit(&bench->progress[writer], memory_order_acquire);
+
+		if (inserted > 0)
+		{
+			int offset = (int)(((long long)writer * bench->numKeys) / STRESS_WRITERS);
+			int i = (offset + (int)(nextRandom(&state) % inserted)) % bench->numKeys;
+			if (searchConcurrent(bench->table, keyAt(i)) == -1)
+			{
+				bench->numErrors++;
+			}
+		}
+
+		if (searchConcurrent(bench->table, missingKeyAt((int)r)) != -1)
+		{
+			bench->numErrors++;
+		}
+		bench->numOps += 2;
+	}
+
+	return NULL;
+}
+
+//runs the benchmark: for 1, 2, 4, ... up to numReaders reader threads, the table is filled with half of the keys,
+//then the readers do their lookups while a loader thread inserts the other half
+//numKeys: the number of keys
+//numReaders: the maximum number of reader threads
+//returns: 0 on success, -1 if it was not possible to allocate the memory or start the threads
+int runBenchmark(int numKeys, int numReaders)
+{
+	ConcurrentTable table;
+	BenchThread* threads = (BenchThread*)malloc((size_t)(numReaders + 1) * sizeof(BenchThread));
+	if (threads == NULL || initConcurrent(&table, 1, BENCH_MAX_LOAD) == -1)
+	{
+		free(threads);
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	printf("Concurrent hash table benchmark: %d keys, %d lookups per reader, 1 loader thread\n\n", numKeys, LOOKUPS_PER_READER);
+	printf("  Readers   Lookups (M/s)   Per reader (M/s)   Found   Loader inserts (M/s)   Lost claims\n");
+
+	int result = 0;
+	for (int readers = 1; ; readers = readers * 2 < numReaders ? readers * 2 : numReaders)
+	{
+		if (resetConcurrent(&table, numKeys) == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			result = -1;
+			break;
+		}
+		for (int i = 0; i < numKeys / 2; ++i)
+		{
+			insertConcurrent(&table, keyAt(i));
+		}
+
+		atomic_int done;
+		atomic_init(&done, 0);
+		for (int t = 0; t <= readers; ++t)
+		{
+			threads[t].id = t;
+			threads[t].table = &table;
+			threads[t].numKeys = numKeys;
+			threads[t].done = &done;
+		}
+
+		//threads[0] is the loader, the rest are the readers
+		double start = now();
+		int numStarted = 0;
+		for (; numStarted <= readers; ++numStarted)
+		{
+			if (pthread_create(&threads[numStarted].thread, NULL, numStarted == 0 ? loaderWork : readerWork, &threads[numStarted]) != 0)
+			{
+				break;
+			}
+		}
+		for (int t = 1; t < numStarted; ++t)
+		{
+			pthread_join(threads[t].thread, NULL);
+		}
+		double elapsed = now() - start;
+		atomic_store(&done, 1);
+		if (numStarted > 0)
+		{
+			pthread_join(threads[0].thread, NULL);
+		}
+		if (numStarted <= readers)
+		{
+			printf("Error: couldn't start the threads!\n");
+			result = -1;
+			break;
+		}
+
+		long long numLookups = 0;
+		long long numFound = 0;
+		for (int t = 1; t <= readers; ++t)
+		{
+			numLookups += threads[t].numOps;
+			numFound += threads[t].numFound;
+		}
+
+		printf("  %7d   %13.2f   %16.2f   %4.0f%%   %20.2f   %11lld\n", readers, numLookups / elapsed / 1e6, numLookups / elapsed / 1e6 / readers,
+			numFound * 100.0 / numLookups, threads[0].seconds > 0 ? threads[0].numOps / threads[0].seconds / 1e6 : 0.0,
+			(long long)atomic_load(&table.numClaimConflicts));
+
+		if (readers == numReaders)
+		{
+			break;
+		}
+	}
+
+	printf("\n");
+
+	deleteConcurrent(&table);
+	free(threads);
+
+	return result;
+}
+
+//runs the stress test: STRESS_WRITERS writer threads insert all the keys, each in a different order, while numReaders threads check them,
+//then the table must contain every key exactly once
+//numKeys: the number of keys
+//numReaders: the number of reader threads
+//returns: 0 if the test passed, -1 if it failed
+int runStressTest(int numKeys, int numReaders)
+{
+	ConcurrentTable table;
+	BenchThread* threads = (BenchThread*)malloc((size_t)(numReaders + STRESS_WRITERS) * sizeof(BenchThread));
+	atomic_int* progress = (atomic_int*)malloc((size_t)STRESS_WRITERS * sizeof(atomic_int));
+	if (threads == NULL || progress == NULL || initConcurrent(&table, 1, BENCH_MAX_LOAD) == -1 || resetConcurrent(&table, numKeys) == -1)
+	{
+		free(threads);
+		free(progress);
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	atomic_int done;
+	atomic_init(&done, 0);
+	for (int w = 0; w < STRESS_WRITERS; ++w)
+	{
+		atomic_init(&progress[w], 0);
+	}
+
+	//the writers are the first STRESS_WRITERS threads, the readers follow
+	int numThreads = numReaders + STRESS_WRITERS;
+	for (int t = 0; t < numThreads; ++t)
+	{
+		threads[t].id = t < STRESS_WRITERS ? t : t - STRESS_WRITERS;
+		threads[t].table = &table;
+		threads[t].numKeys = numKeys;
+		threads[t].done = &done;
+		threads[t].progress = progress;
+		threads[t].numOps = 0;
+		threads[t].numErrors = 0;
+	}
+
+	double start = now();
+	int numStarted = 0;
+	for (; numStarted < numThreads; ++numStarted)
+	{
+		if (pthread_create(&threads[numStarted].thread, NULL, numStarted < STRESS_WRITERS ? writerWork : checkerWork, &threads[numStarted]) != 0)
+		{
+			break;
+		}
+	}
+	for (int t = 0; t < numStarted && t < STRESS_WRITERS; ++t)
+	{
+		pthread_join(threads[t].thread, NULL);
+	}
+	atomic_store_explicit(&done, 1, memory_order_release);
+	for (int t = STRESS_WRITERS; t < numStarted; ++t)
+	{
+		pthread_join(threads[t].thread, NULL);
+	}
+	double elapsed = now() - start;
+
+	long long numWriteErrors = 0;
+	long long numReadErrors = 0;
+	long long numChecks = 0;
+	for (int t = 0; t < numThreads; ++t)
+	{
+		if (t < STRESS_WRITERS)
+		{
+			numWriteErrors += threads[t].numErrors;
+		}
+		else
+		{
+			numReadErrors += threads[t].numErrors;
+			numChecks += threads[t].numOps;
+		}
+	}
+
+	//every key must be in the table exactly once, count the copies of every key found in the slots
+	int numMissing = 0;
+	int numDuplicates = 0;
+	for (int i = 0; i < numKeys; ++i)
+	{
+		int key = keyAt(i);
+		int copies = 0;
+		if (key == CONCURRENT_EMPTY)
+		{
+			copies = searchConcurrent(&table, key) != -1;
+		}
+		else
+		{
+			unsigned int mask = (unsigned int)table.size - 1;
+			unsigned int index = hashMurmur(key) & mask;
+			for (int j = 0; j < table.size; ++j)
+			{
+				int current = atomic_load(&table.slots[index]);
+				if (current == CONCURRENT_EMPTY)
+				{
+					break;
+				}
+				copies += current == key;
+				index = (index + 1) & mask;
+			}
+		}
+
+		numMissing += copies == 0;
+		numDuplicates += copies > 1;
+	}
+
+	int passed = numStarted == numThreads && numWriteErrors == 0 && numReadErrors == 0 && numMissing == 0 && numDuplicates == 0
+		&& concurrentOccupied(&table) == numKeys;
+
+	printf("Concurrent hash table stress test: %d keys, %d writer threads, %d reader threads\n\n", numKeys, STRESS_WRITERS, numReaders);
+	printf("  Time: %f s\n", elapsed);
+	printf("  Items stored: %d of %d, table size %d\n", concurrentOccupied(&table), numKeys, table.size);
+	printf("  Inserts that lost an empty slot to another thread: %lld\n", (long long)atomic_load(&table.numClaimConflicts));
+	printf("  Inserts that found the table full: %lld\n", numWriteErrors);
+	printf("  Lookups checked by the readers: %lld, wrong results: %lld\n", numChecks, numReadErrors);
+	printf("  Keys missing from the table: %d, keys stored more than once: %d\n", numMissing, numDuplicates);
+	printf("\nStress test %s\n\n", passed ? "passed" : "FAILED");
+
+	deleteConcurrent(&table);
+	free(threads);
+	free(progress);
+
+	return passed ? 0 : -1;
+}
+
+int main(int argc, char* argv[])
+{
+	//check the number of arguments
+	if (argc < 3)
+	{
+		printf("Error: 2 arguments required!\n");
+		printf("Usage: %s <number of keys> <maximum number of reader threads> [--stress]\n", argv[0]);
+		return -1;
+	}
+
+	int numKeys = atoi(argv[1]);
+	int numReaders = atoi(argv[2]);
+	int stress = argc > 3 && strcmp(argv[3], "--stress") == 0;
+
+	if (argc > 3 && !stress)
+	{
+		printf("Error: unknown option %s!\n", argv[3]);
+		return -1;
+	}
+	if (numKeys < 2 || numKeys > 0x7fffffff / 4)
+	{
+		printf("Error: the number of keys must be from 2 to %d!\n", 0x7fffffff / 4);
+		return -1;
+	}
+	if (numReaders < 1 || numReaders > MAX_READERS)
+	{
+		printf("Error: the number of reader threads must be from 1 to %d!\n", MAX_READERS);
+		return -1;
+	}
+
+	return stress ? runStressTest(numKeys, numReaders) : runBenchmark(numKeys, numReaders);
+}
@@ -0,0 +1,192 @@
+#include <stdlib.h>
+
+#include "concurrenttable.h"
+#include "hashpolicy.h"
+
+//rounds a size up to a power of two
+//size: the size
+//returns: the smallest power of two not smaller than the size, -1 if it would not fit into an int
+static int roundUpPowerOfTwo(int size)
+{
+	int rounded = 1;
+	while (rounded < size)
+	{
+		if (rounded > 0x7fffffff / 2)
+		{
+			return -1;
+		}
+		rounded *= 2;
+	}
+
+	return rounded;
+}
+
+//allocates the slots of the concurrent table and sets all of them to empty
+//table: pointer to the concurrent table
+//size: the number of slots, a power of two
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+static int allocateSlots(ConcurrentTable* table, int size)
+{
+	table->slots = (_Atomic int*)malloc((size_t)size * sizeof(_Atomic int));
+	table->size = table->slots == NULL ? 0 : size;
+
+	for (int i = 0; i < table->size; ++i)
+	{
+		atomic_init(&table->slots[i], CONCURRENT_EMPTY);
+	}
+
+	table->maxOccupied = (int)(table->maxLoad * table->size);
+	if (table->maxOccupied > table->size - 1)
+	{
+		table->maxOccupied = table->size - 1;
+	}
+
+	return table->slots == NULL ? -1 : 0;
+}
+
+int initConcurrent(ConcurrentTable* table, int size, double maxLoad)
+{
+	table->maxLoad = maxLoad;
+	table->initialSize = roundUpPowerOfTwo(size);
+	atomic_init(&table->numOccupied, 0);
+	atomic_init(&table->hasEmptyKey, 0);
+	atomic_init(&table->numClaimConflicts, 0);
+
+	if (table->initialSize == -1)
+	{
+		table->slots = NULL;
+		table->size = 0;
+		return -1;
+	}
+
+	return allocateSlots(table, table->initialSize);
+}
+
+int resetConcurrent(ConcurrentTable* table, int numKeys)
+{
+	atomic_store_explicit(&table->numOccupied, 0, memory_order_relaxed);
+	atomic_store_explicit(&table->hasEmptyKey, 0, memory_order_relaxed);
+	atomic_store_explicit(&table->numClaimConflicts, 0, memory_order_relaxed);
+
+	//the smallest power of two that keeps the keys within the maximum load factor
+	int size = table->initialSize;
+	while ((size - 1 < numKeys || table->maxLoad * size < numKeys) && size <= 0x7fffffff / 2)
+	{
+		size *= 2;
+	}
+
+	if (size != table->size)
+	{
+		free((void*)table->slots);
+		return allocateSlots(table, size);
+	}
+
+	for (int i = 0; i < table->size; ++i)
+	{
+		atomic_store_explicit(&table->slots[i], CONCURRENT_EMPTY, memory_order_relaxed);
+	}
+
+	return 0;
+}
+
+int insertConcurrent(ConcurrentTable* table, int key)
+{
+	if (key == CONCURRENT_EMPTY)
+	{
+		if (atomic_exchange_explicit(&table->hasEmptyKey, 1, memory_order_release) == 0)
+		{
+			atomic_fetch_add_explicit(&table->numOccupied, 1, memory_order_relaxed);
+		}
+		return table->size;
+	}
+
+	unsigned int mask = (unsigned int)table->size - 1;
+	unsigned int index = hashMurmur(key) & mask;
+	int reserved = 0; //whether this insert has counted its key in numOccupied
+
+	for (int i = 0; i < table->size; ++i)
+	{
+		int current = atomic_load_explicit(&table->slots[index], memory_order_acquire);
+
+		if (current == CONCURRENT_EMPTY)
+		{
+			//reserve room for the key first, so the table never fills up and every search still reaches an empty slot
+			if (!reserved)
+			{
+				if (atomic_fetch_add_explicit(&table->numOccupied, 1, memory_order_relaxed) >= table->maxOccupied)
+				{
+					atomic_fetch_sub_explicit(&table->numOccupied, 1, memory_order_relaxed);
+					return -1;
+				}
+				reserved = 1;
+			}
+
+			//claim the slot, if another thread claimed it first, current is set to the key of that thread
+			if (atomic_compare_exchange_strong_explicit(&table->slots[index], &current, key, memory_order_release, memory_order_acquire))
+			{
+				return (int)index;
+			}
+			atomic_fetch_add_explicit(&table->numClaimConflicts, 1, memory_order_relaxed);
+		}
+
+		//the key is already in the table, possibly inserted by another thread just now
+		if (current == key)
+		{
+			if (reserved)
+			{
+				atomic_fetch_sub_explicit(&table->numOccupied, 1, memory_order_relaxed);
+			}
+			return (int)index;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	//only reachable when the reservation failed to find a slot, which the maximum number of occupied slots rules out
+	if (reserved)
+	{
+		atomic_fetch_sub_explicit(&table->numOccupied, 1, memory_order_relaxed);
+	}
+	return -1;
+}
+
+int searchConcurrent(ConcurrentTable* table, int key)
+{
+	if (key == CONCURRENT_EMPTY)
+	{
+		return atomic_load_explicit(&table->hasEmptyKey, memory_order_acquire) ? table->size : -1;
+	}
+
+	unsigned int mask = (unsigned int)table->size - 1;
+	unsigned int index = hashMurmur(key) & mask;
+
+	for (int i = 0; i < table->size; ++i)
+	{
+		int current = atomic_load_explicit(&table->slots[index], memory_order_acquire);
+
+		if (current == key)
+		{
+			return (int)index;
+		}
+		else if (current == CONCURRENT_EMPTY)
+		{
+			return -1;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	return -1;
+}
+
+int concurrentOccupied(ConcurrentTable* table)
+{
+	return atomic_load_explicit(&table->numOccupied, memory_order_relaxed);
+}
+
+void deleteConcurrent(ConcurrentTable* table)
+{
+	free((void*)table->slots);
+	table->slots = NULL;
+	table->size = 0;
+}
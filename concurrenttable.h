@@ -0,0 +1,81 @@
+#ifndef CONCURRENTTABLE_H
+#define CONCURRENTTABLE_H
+
+#include <stdatomic.h>
+
+//hash table that many threads can use at the same time: any number of threads insert while any number of threads search
+//the keys are stored in one array of atomic slots with linear probing, an empty slot holds CONCURRENT_EMPTY
+//
+//an insert claims an empty slot with a compare-and-swap from CONCURRENT_EMPTY to its key, no locks are taken;
+//if the swap fails, another thread has just claimed the slot, and the insert either finds its own key there or probes on,
+//so some insert always makes progress (lock-free)
+//a search never writes and never retries, it reads at most one slot per slot of the table (wait-free)
+//
+//memory ordering:
+//- an insert writes its key into a slot with a release compare-and-swap, a search reads the slots with acquire loads,
+//  so a thread that finds a key also sees everything the inserting thread did before inserting it
+//- a slot only ever changes once, from empty to a key, and keys are never removed, so the keys on the probe sequence of a key
+//  were all in place before the key itself; a search that finds a key keeps finding it, and a search that reaches an empty slot
+//  takes effect at the moment it read that slot, the key was not in the table then
+//- the counters are only statistics and use relaxed operations, the number of occupied slots is exact once no insert is running
+//
+//the table does not grow while it is shared, it is sized for the number of keys beforehand (initConcurrent, resetConcurrent)
+
+//the maximum load factor the table is sized for when no other is given: with linear probing a search for a missing key scans
+//the run of occupied slots up to the next empty one, about (1 + 1 / (1 - load)^2) / 2 slots, which grows without bound near a full table
+#define CONCURRENT_MAX_LOAD 0.75
+
+//the content of an empty slot, the key with this value is kept outside of the array of slots
+#define CONCURRENT_EMPTY ((int)0x80000000)
+
+//the concurrent hash table
+typedef struct ConcurrentTable ConcurrentTable;
+struct ConcurrentTable
+{
+	_Atomic int* slots; //array of slots, each holds a key or CONCURRENT_EMPTY
+	int size; //the number of slots, a power of two
+	int initialSize; //the number of slots when the table was initialized
+	double maxLoad; //the maximum allowed ratio of occupied slots to the number of slots
+	int maxOccupied; //the maximum number of occupied slots, at least one slot is always empty so that every search ends
+	atomic_int numOccupied; //the number of occupied slots, including the slots being claimed by inserts in progress
+	atomic_int hasEmptyKey; //1 if the key equal to CONCURRENT_EMPTY is in the table
+	atomic_llong numClaimConflicts; //the number of times an insert lost the compare-and-swap for an empty slot to another thread
+};
+
+//initializes an empty concurrent table, this is not thread-safe
+//table: pointer to the concurrent table
+//size: the requested number of slots, it is rounded up to a power of two
+//maxLoad: the maximum allowed ratio of occupied slots to the number of slots
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int initConcurrent(ConcurrentTable* table, int size, double maxLoad);
+
+//empties the concurrent table and sizes it so that the given number of keys fit without exceeding the maximum load factor,
+//it never becomes smaller than its initial size, this is not thread-safe
+//table: pointer to the concurrent table
+//numKeys: the number of keys that are going to be inserted
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int resetConcurrent(ConcurrentTable* table, int numKeys);
+
+//inserts a key into the concurrent table, lock-free, it can run at the same time as other inserts and searches
+//table: pointer to the concurrent table
+//key: the key to insert
+//returns: the index of the slot with the key, also when the key was already in the table, -1 if the table is full
+//the key equal to CONCURRENT_EMPTY is reported at index size
+int insertConcurrent(ConcurrentTable* table, int key);
+
+//searches for a key in the concurrent table, wait-free, it can run at the same time as inserts and other searches
+//table: pointer to the concurrent table
+//key: the key to search for
+//returns: the index of the slot where the key was found, -1 if it was not found
+int searchConcurrent(ConcurrentTable* table, int key);
+
+//returns the number of keys in the concurrent table
+//table: pointer to the concurrent table
+//returns: the number of occupied slots, it is exact once no insert is running
+int concurrentOccupied(ConcurrentTable* table);
+
+//frees the dynamically allocated memory associated with the concurrent table, this is not thread-safe
+//table: pointer to the concurrent table
+void deleteConcurrent(ConcurrentTable* table);
+
+#endif
@@ -0,0 +1,422 @@
+#include <stdlib.h>
+
+#include "cuckootable.h"
+#include "hashpolicy.h"
+
+#define CUCKOO_ALIGNMENT 64 //the alignment of the array of buckets, a bucket never crosses a cache line
+#define CUCKOO_SEED 0x9e3779b97f4a7c15ull //the seed of the hash of the keys
+
+//the largest number of buckets the breadth-first search looks at: the two buckets of the key, each with up to
+//CUCKOO_BUCKET_SLOTS children per level below it, down to CUCKOO_MAX_PATH - 1 levels, 2 * (1 + 4 + 16 + 64 + 256)
+#define CUCKOO_BFS_NODES 682
+
+//a bucket reached by the breadth-first search of an insert
+typedef struct CuckooNode CuckooNode;
+struct CuckooNode
+{
+	unsigned int bucket; //the index of the bucket
+	int parent; //the node whose key would move into this bucket, -1 for the two buckets of the inserted key
+	int parentSlot; //the slot of that key in the bucket of the parent node
+	int depth; //the number of kicks that lead to this bucket
+};
+
+//computes the 64-bit hash of a key, its two halves give the two buckets
+//key: the key
+//returns: the hash of the key
+static inline unsigned long long cuckooHash(int key)
+{
+	unsigned long long x = (unsigned int)key ^ CUCKOO_SEED;
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+
+	return x;
+}
+
+//computes the two buckets of a key, they are always different
+//table: pointer to the cuckoo table
+//key: the key
+//first: the index of the first bucket is saved here
+//second: the index of the second bucket is saved here
+static inline void cuckooBuckets(const CuckooTable* table, int key, unsigned int* first, unsigned int* second)
+{
+	unsigned long long hash = cuckooHash(key);
+	*first = reduceHash((unsigned int)(hash >> 32), table->numBuckets);
+	*second = reduceHash((unsigned int)hash, table->numBuckets);
+	if (*second == *first)
+	{
+		*second = *first + 1 == (unsigned int)table->numBuckets ? 0 : *first + 1;
+	}
+}
+
+//returns the bucket of a key other than the given one
+//table: pointer to the cuckoo table
+//key: the key
+//bucket: one of the two buckets of the key
+//returns: the index of the other bucket of the key
+static unsigned int otherBucket(const CuckooTable* table, int key, unsigned int bucket)
+{
+	unsigned int first;
+	unsigned int second;
+	cuckooBuckets(table, key, &first, &second);
+
+	return first == bucket ? second : first;
+}
+
+//finds an empty slot in a bucket
+//bucket: pointer to the bucket
+//returns: the index of the first empty slot, -1 if the bucket is full
+static int freeSlot(const CuckooBucket* bucket)
+{
+	for (int i = 0; i < CUCKOO_BUCKET_SLOTS; ++i)
+	{
+		if (bucket->keys[i] == CUCKOO_EMPTY)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+//allocates an array of buckets with all their slots empty
+//numBuckets: the number of buckets
+//returns: pointer to the array, NULL if it was not possible to allocate the memory
+static CuckooBucket* allocateBuckets(int numBuckets)
+{
+	//aligned_alloc requires the size to be a multiple of the alignment
+	size_t bytes = (size_t)numBuckets * sizeof(CuckooBucket);
+	bytes = (bytes + CUCKOO_ALIGNMENT - 1) / CUCKOO_ALIGNMENT * CUCKOO_ALIGNMENT;
+	CuckooBucket* buckets = (CuckooBucket*)aligned_alloc(CUCKOO_ALIGNMENT, bytes);
+	if (buckets == NULL)
+	{
+		return NULL;
+	}
+
+	for (int i = 0; i < numBuckets; ++i)
+	{
+		for (int j = 0; j < CUCKOO_BUCKET_SLOTS; ++j)
+		{
+			buckets[i].keys[j] = CUCKOO_EMPTY;
+		}
+	}
+
+	return buckets;
+}
+
+//checks whether a bucket is on the chain of kicks leading to a node, a chain never visits a bucket twice
+//nodes: the nodes of the breadth-first search
+//node: the index of the last node of the chain
+//bucket: the index of the bucket
+//returns: 1 if the bucket is on the chain, 0 otherwise
+static int onChain(const CuckooNode* nodes, int node, unsigned int bucket)
+{
+	for (; node != -1; node = nodes[node].parent)
+	{
+		if (nodes[node].bucket == bucket)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+//moves the keys along a chain of kicks found by the breadth-first search and places the inserted key in the slot freed at its start
+//every key moves into the slot that the previous move freed, starting from the end of the chain, so no key is ever lost
+//table: pointer to the cuckoo table
+//nodes: the nodes of the breadth-first search
+//node: the index of the last node of the chain
+//slot: the slot of the key of the last node that moves into the free slot
+//target: the index of the bucket with the free slot
+//targetSlot: the free slot
+//key: the inserted key
+static void kickChain(CuckooTable* table, const CuckooNode* nodes, int node, int slot, unsigned int target, int targetSlot, int key)
+{
+	table->buckets[target].keys[targetSlot] = table->buckets[nodes[node].bucket].keys[slot];
+	int length = 1;
+
+	while (nodes[node].parent != -1)
+	{
+		const CuckooNode* parent = &nodes[nodes[node].parent];
+		table->buckets[nodes[node].bucket].keys[slot] = table->buckets[parent->bucket].keys[nodes[node].parentSlot];
+		slot = nodes[node].parentSlot;
+		node = nodes[node].parent;
+		length++;
+	}
+
+	table->buckets[nodes[node].bucket].keys[slot] = key;
+
+	table->numKicks += length;
+	if (length > table->maxPath)
+	{
+		table->maxPath = length;
+	}
+}
+
+//places a key in one of its buckets, kicking other keys to their other buckets if both are full
+//the breadth-first search finds the shortest chain of kicks, so an insert moves as few keys as possible
+//table: pointer to the cuckoo table
+//key: the key to place, not CUCKOO_EMPTY
+//returns: 0 if the key was placed, -1 if no chain of at most CUCKOO_MAX_PATH kicks ends at a free slot
+static int placeKey(CuckooTable* table, int key)
+{
+	unsigned int first;
+	unsigned int second;
+	cuckooBuckets(table, key, &first, &second);
+
+	int slot = freeSlot(&table->buckets[first]);
+	if (slot != -1)
+	{
+		table->buckets[first].keys[slot] = key;
+		return 0;
+	}
+	slot = freeSlot(&table->buckets[second]);
+	if (slot != -1)
+	{
+		table->buckets[second].keys[slot] = key;
+		return 0;
+	}
+
+	CuckooNode nodes[CUCKOO_BFS_NODES];
+	nodes[0] = (CuckooNode){ first, -1, -1, 0 };
+	nodes[1] = (CuckooNode){ second, -1, -1, 0 };
+	int numNodes = 2;
+
+	for (int head = 0; head < numNodes; ++head)
+	{
+		const CuckooBucket* bucket = &table->buckets[nodes[head].bucket];
+		table->numVisited++;
+
+		for (int i = 0; i < CUCKOO_BUCKET_SLOTS; ++i)
+		{
+			//the buckets in the search are full, so every slot holds a key that could move to its other bucket
+			unsigned int other = otherBucket(table, bucket->keys[i], nodes[head].bucket);
+			int otherSlot = freeSlot(&table->buckets[other]);
+			if (otherSlot != -1)
+			{
+				kickChain(table, nodes, head, i, other, otherSlot, key);
+				return 0;
+			}
+
+			if (nodes[head].depth + 1 < CUCKOO_MAX_PATH && numNodes < CUCKOO_BFS_NODES && !onChain(nodes, head, other))
+			{
+				nodes[numNodes++] = (CuckooNode){ other, head, i, nodes[head].depth + 1 };
+			}
+		}
+	}
+
+	return -1;
+}
+
+//stores a key in its buckets or, if that fails, in the stash
+//table: pointer to the cuckoo table
+//key: the key to store
+//returns: 0 on success, -1 if the key found no place and the stash is full
+static int storeKey(CuckooTable* table, int key)
+{
+	if (key != CUCKOO_EMPTY && placeKey(table, key) == 0)
+	{
+		return 0;
+	}
+
+	if (table->numStashed == CUCKOO_STASH_SIZE)
+	{
+		return -1;
+	}
+	table->stash[table->numStashed++] = key;
+	table->numStashInserts++;
+
+	return 0;
+}
+
+//doubles the number of buckets of the cuckoo table and stores all the keys again, doubling further if they don't fit
+//table: pointer to the cuckoo table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+static int growCuckoo(CuckooTable* table)
+{
+	CuckooBucket* oldBuckets = table->buckets;
+	int oldNumBuckets = table->numBuckets;
+	int oldStash[CUCKOO_STASH_SIZE];
+	int oldNumStashed = table->numStashed;
+	for (int i = 0; i < oldNumStashed; ++i)
+	{
+		oldStash[i] = table->stash[i];
+	}
+
+	//the kicks while moving the keys are not counted, they are not caused by inserts
+	long long numKicks = table->numKicks;
+	int maxPath = table->maxPath;
+	long long numVisited = table->numVisited;
+	int numStashInserts = table->numStashInserts;
+
+	int numBuckets = oldNumBuckets;
+	int stored = 0;
+	while (!stored)
+	{
+		//the index of every slot, including the stash, fits into an int
+		CuckooBucket* buckets = numBuckets <= (0x7fffffff - CUCKOO_STASH_SIZE) / 2 / CUCKOO_BUCKET_SLOTS ? allocateBuckets(2 * numBuckets) : NULL;
+		if (buckets == NULL)
+		{
+			table->buckets = oldBuckets;
+			table->numBuckets = oldNumBuckets;
+			table->numStashed = oldNumStashed;
+			for (int i = 0; i < oldNumStashed; ++i)
+			{
+				table->stash[i] = oldStash[i];
+			}
+			return -1;
+		}
+		numBuckets *= 2;
+		table->buckets = buckets;
+		table->numBuckets = numBuckets;
+		table->numStashed = 0;
+
+		stored = 1;
+		for (int i = 0; i < oldNumBuckets && stored; ++i)
+		{
+			for (int j = 0; j < CUCKOO_BUCKET_SLOTS && stored; ++j)
+			{
+				if (oldBuckets[i].keys[j] != CUCKOO_EMPTY && storeKey(table, oldBuckets[i].keys[j]) == -1)
+				{
+					stored = 0;
+				}
+			}
+		}
+		for (int i = 0; i < oldNumStashed && stored; ++i)
+		{
+			if (storeKey(table, oldStash[i]) == -1)
+			{
+				stored = 0;
+			}
+		}
+
+		if (!stored)
+		{
+			free(table->buckets);
+		}
+	}
+
+	table->numKicks = numKicks;
+	table->maxPath = maxPath;
+	table->numVisited = numVisited;
+	table->numStashInserts = numStashInserts;
+
+	free(oldBuckets);
+	table->numGrowths++;
+
+	return 0;
+}
+
+int initCuckoo(CuckooTable* table, int size, double maxLoad)
+{
+	int numBuckets = (int)(((long long)size + CUCKOO_BUCKET_SLOTS - 1) / CUCKOO_BUCKET_SLOTS);
+	if (numBuckets < 2)
+	{
+		numBuckets = 2;
+	}
+
+	table->buckets = allocateBuckets(numBuckets);
+	table->numBuckets = numBuckets;
+	table->numOccupied = 0;
+	table->initialBuckets = numBuckets;
+	table->maxLoad = maxLoad;
+	table->numStashed = 0;
+	table->numGrowths = 0;
+	table->numKicks = 0;
+	table->maxPath = 0;
+	table->numVisited = 0;
+	table->numDuplicates = 0;
+	table->numStashInserts = 0;
+
+	return table->buckets == NULL ? -1 : 0;
+}
+
+int resetCuckoo(CuckooTable* table)
+{
+	free(table->buckets);
+
+	return initCuckoo(table, table->initialBuckets * CUCKOO_BUCKET_SLOTS, table->maxLoad);
+}
+
+int insertCuckoo(CuckooTable* table, int key)
+{
+	if (searchCuckoo(table, key) != -1)
+	{
+		table->numDuplicates++;
+		return 0;
+	}
+
+	//grow the table if the insert would exceed the maximum load factor
+	if (table->numOccupied + 1 > table->maxLoad * cuckooSlots(table) && growCuckoo(table) == -1)
+	{
+		return -1;
+	}
+
+	while (storeKey(table, key) == -1)
+	{
+		if (growCuckoo(table) == -1)
+		{
+			return -1;
+		}
+	}
+	table->numOccupied++;
+
+	return 0;
+}
+
+int searchCuckoo(const CuckooTable* table, int key)
+{
+	unsigned int first;
+	unsigned int second;
+	cuckooBuckets(table, key, &first, &second);
+
+	//both buckets are requested before either is compared, so the two cache lines are read at the same time
+	const CuckooBucket* firstBucket = &table->buckets[first];
+	const CuckooBucket* secondBucket = &table->buckets[second];
+	__builtin_prefetch(secondBucket);
+
+	if (key != CUCKOO_EMPTY)
+	{
+		for (int i = 0; i < CUCKOO_BUCKET_SLOTS; ++i)
+		{
+			if (firstBucket->keys[i] == key)
+			{
+				return (int)first * CUCKOO_BUCKET_SLOTS + i;
+			}
+		}
+		for (int i = 0; i < CUCKOO_BUCKET_SLOTS; ++i)
+		{
+			if (secondBucket->keys[i] == key)
+			{
+				return (int)second * CUCKOO_BUCKET_SLOTS + i;
+			}
+		}
+	}
+
+	for (int i = 0; i < table->numStashed; ++i)
+	{
+		if (table->stash[i] == key)
+		{
+			return table->numBuckets * CUCKOO_BUCKET_SLOTS + i;
+		}
+	}
+
+	return -1;
+}
+
+int cuckooSlots(const CuckooTable* table)
+{
+	return table->numBuckets * CUCKOO_BUCKET_SLOTS;
+}
+
+void deleteCuckoo(CuckooTable* table)
+{
+	free(table->buckets);
+	table->buckets = NULL;
+	table->numBuckets = 0;
+	table->numOccupied = 0;
+	table->numStashed = 0;
+}
@@ -0,0 +1,85 @@
+#ifndef CUCKOOTABLE_H
+#define CUCKOOTABLE_H
+
+#include <limits.h>
+
+//bucketized cuckoo hash table: every key has two candidate buckets given by two hash functions, and every bucket has CUCKOO_BUCKET_SLOTS slots
+//a bucket is 16 bytes and the buckets are aligned to a cache line, so a bucket never crosses a cache line and a lookup reads at most two lines,
+//whatever the load of the table; the two buckets are prefetched together, so the two reads overlap
+//an insert that finds both buckets full searches breadth-first for the shortest chain of keys that can each move to their other bucket
+//and ends at a free slot, then moves the keys along the chain (the kicks); a key for which no chain is found within CUCKOO_MAX_PATH moves
+//goes into a small stash, which a lookup only checks while it holds keys, and the table doubles when the stash is full
+//with 4 slots per bucket the table fills to about 95% before inserts start failing
+
+//the number of slots in a bucket
+#define CUCKOO_BUCKET_SLOTS 4
+
+//the number of keys the stash holds before the table grows
+#define CUCKOO_STASH_SIZE 8
+
+//the longest chain of kicks the breadth-first search looks for
+#define CUCKOO_MAX_PATH 5
+
+//the key marking an empty slot, a stored key equal to it is always kept in the stash
+#define CUCKOO_EMPTY INT_MIN
+
+//a bucket of the cuckoo table
+typedef struct CuckooBucket CuckooBucket;
+struct CuckooBucket
+{
+	int keys[CUCKOO_BUCKET_SLOTS]; //the keys in the slots of the bucket, CUCKOO_EMPTY for an empty slot
+};
+
+//the cuckoo table
+typedef struct CuckooTable CuckooTable;
+struct CuckooTable
+{
+	CuckooBucket* buckets; //array of buckets, aligned to a cache line
+	int numBuckets; //the number of buckets, at least 2
+	int numOccupied; //the number of stored keys, in the buckets and in the stash
+	int initialBuckets; //the number of buckets when the table is (re)created
+	double maxLoad; //the maximum allowed ratio of stored keys to the number of slots
+	int stash[CUCKOO_STASH_SIZE]; //the keys that found no place in their buckets
+	int numStashed; //the number of keys in the stash
+	int numGrowths; //the number of times the table has grown since it was (re)created
+	long long numKicks; //the number of times an insert moved a key to its other bucket
+	int maxPath; //the longest chain of kicks of a single insert
+	long long numVisited; //the number of buckets the breadth-first searches of the inserts looked at
+	int numDuplicates; //the number of keys that were inserted again and are stored once
+	int numStashInserts; //the number of inserts that found no chain of kicks and went into the stash
+};
+
+//initializes an empty cuckoo table
+//table: pointer to the cuckoo table
+//size: the requested number of slots, it is rounded up to whole buckets and to at least two buckets
+//maxLoad: the maximum allowed ratio of stored keys to the number of slots, the table also grows when the stash is full
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int initCuckoo(CuckooTable* table, int size, double maxLoad);
+
+//empties the cuckoo table and shrinks it back to its initial number of buckets
+//table: pointer to the cuckoo table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int resetCuckoo(CuckooTable* table);
+
+//inserts a key into the cuckoo table, a key that is already stored is not stored again
+//table: pointer to the cuckoo table
+//key: the key to insert
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int insertCuckoo(CuckooTable* table, int key);
+
+//searches for a key in the cuckoo table
+//table: pointer to the cuckoo table
+//key: the key to search for
+//returns: the index of the slot where the key was found, the slots of the stash follow the slots of the buckets, -1 if it was not found
+int searchCuckoo(const CuckooTable* table, int key);
+
+//returns the number of slots of the cuckoo table, not counting the stash
+//table: pointer to the cuckoo table
+//returns: the number of slots
+int cuckooSlots(const CuckooTable* table);
+
+//frees the dynamically allocated memory associated with the cuckoo table
+//table: pointer to the cuckoo table
+void deleteCuckoo(CuckooTable* table);
+
+#endif
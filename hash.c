@@ -1,20 +1,62 @@
 
 #include <stdlib.h> 
 #include <stdio.h>
-#include <time.h>
-
-const int MAX_INPUT_SIZE = 1000; //maximum number of elements for storage in the hash table
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "benchmark.h"
+#include "bloomfilter.h"
+#include "concurrenttable.h"
+#include "cuckootable.h"
+#include "hashpolicy.h"
+#include "loader.h"
+#include "perfecthash.h"
+#include "probestats.h"
+#include "robinhood.h"
+#include "server.h"
+#include "snapshot.h"
+#include "swisstable.h"
+
+const int INITIAL_INPUT_SIZE = 1024; //initial capacity of the list of elements for storage, the list grows as more elements are read
+#define LOAD_CHUNK_SIZE 4096 //number of values taken from the loader at once when reading the list of elements for storage
 const int MAX_SEARCH_SIZE = 1000; //maximum number of elements for search
+const double DEFAULT_MAX_LOAD = 1.0; //default maximum load factor of the engines that cap their load themselves or place every element
+const double QUADRATIC_MAX_LOAD = 0.5; //default maximum load factor of the classic engine with quadratic probing, which reaches only about half of the entries
+const double PROBING_MAX_LOAD = 0.75; //default maximum load factor of the classic engine with the other probe sequences, whose runs grow long near a full table
+const int DEFAULT_REHASH_STEP = 4; //default number of buckets moved from the old array into the new one per insert during a rehash
+const int INITIAL_COLLISION_LOG_SIZE = 1024; //initial capacity of the collision log, the log grows as more collisions are recorded
+#define BATCH_LANES 16 //number of lookups a batched search keeps in flight at once
+#define MAX_BUILD_THREADS 64 //maximum number of threads building the hash table, a thread number fits into an unsigned char
+const int MIN_BUILD_THREAD_ITEMS = 16384; //minimum number of elements per thread of a parallel build, fewer threads are used for smaller inputs
+#define FORCE_INLINE static inline __attribute__((always_inline)) //for functions that are specialized by inlining them with constant arguments
 
 //entry in the list of elements for storage in the hash table
 typedef struct InputEntry InputEntry;
 struct InputEntry
 {
 	int key; //the value of the element
-	int* collisions; //array of indices into the hash table where collisions occurred when storig this element
 	int numCollisions; //number of collisions which occurred when storig this element in the has table
 };
 
+//one collision that occurred when storing an element in the hash table
+typedef struct CollisionRecord CollisionRecord;
+struct CollisionRecord
+{
+	int key; //the value of the element that was being stored
+	int index; //the index in the hash table where the collision occurred
+};
+
+//append-only log of all the collisions that occurred when storing the elements in the hash table
+//all the records are kept in a single array that grows with the number of collisions that actually occur
+typedef struct CollisionLog CollisionLog;
+struct CollisionLog
+{
+	CollisionRecord* array; //array of records
+	long long size; //the number of records in the log, there can be more records than elements since every probe can collide
+	long long capacity; //the number of records the array can hold before it has to grow
+};
+
 //the list of elements for storage in the hash table
 //this list is created when reading the elements from the input file
 //it is later used to store the elemets in the hash table and record any collisions that occur
@@ -56,400 +98,3404 @@ struct HashEntry
 	EntryStatus status; //whether this entry is empty or occupied
 };
 
-//the hash table
 typedef struct HashTable HashTable;
+
+//the probing functions of the hash table, specialized for one hash function, probe sequence and table geometry
+//the specialized functions are selected once when the table is initialized, so their loops don't dispatch on the policy
+typedef struct HashPolicy HashPolicy;
+struct HashPolicy
+{
+	int (*place)(HashEntry* array, int size, int key); //places a key into an array without recording collisions
+	unsigned int (*home)(int key, int size); //computes the home index of a key
+	int (*search)(HashEntry* array, int size, int key); //searches for a key in an array
+	int (*measure)(HashEntry* array, int size, int key, int* numProbes); //searches for a key in an array and counts the probes
+	int (*insert)(HashTable* table, InputEntry* entry, CollisionLog* log); //probes for an empty entry of the table and records the collisions
+	int (*searchBatch)(HashTable* table, SearchEntry* entries, int count); //searches for many entries at once
+	int (*insertRegion)(HashEntry* array, int size, InputEntry* entry, unsigned int low, unsigned int high, CollisionLog* log); //probes only within a region of the array
+};
+
+//the hash table
+//when the load factor would exceed maxLoad, or when an element cannot be placed, the table grows
+//growing is incremental: a larger array is allocated and every insert moves migrateStep buckets of the old array into it,
+//so no single insert has to move the whole table; migrateStep is large enough that the rehash ends before the load factor triggers the next growth
 struct HashTable
 {
 	HashEntry* array; //array of entries
 	int size; //the size of the array of entries
-	int numOccupied; //the number of entries that are occupied
+	int numOccupied; //the number of entries that are occupied (in both arrays while a rehash is in progress)
+	int initialSize; //the size of the array when the table is (re)created
+	double maxLoad; //the maximum allowed ratio of occupied entries to the size of the array
+	int rehashStep; //the smallest number of buckets of the old array moved per insert while a rehash is in progress
+	int migrateStep; //the number of buckets of the old array moved per insert during the current rehash, at least rehashStep
+	HashEntry* oldArray; //the array whose entries are being moved into array, NULL if no rehash is in progress
+	int oldSize; //the size of the old array
+	int rehashIndex; //the index of the next bucket of the old array that is to be moved
+	int numGrowths; //the number of times the table has grown since it was (re)created
+	HashFunction hashFunction; //the hash function giving the home index of a key
+	ProbeSequence probeSequence; //the sequence of indices probed after the home index
+	const HashPolicy* policy; //the probing functions specialized for the hash function, probe sequence and size of the table
+	int numBuildThreads; //the number of threads that built the table when it was last created
+	int numDeferred; //the number of entries a parallel build had to insert after its threads finished
 };
 
-//tries to insert one entry into the hash table, uses quadratic probing
-//hashTable: pointer to the hash table 
-//entry: pointer to the entry that is to be inserted, information about collisions that occurred, if any, is saved into the entry
-//returns: the index in the hash table where the entry was inserted, -1 if it was not possible to insert the entry
-int insertHash(HashTable* table, InputEntry* entry)
+//initializes an empty collision log, the memory for the records is allocated when the first collision is recorded
+//log: pointer to the collision log
+void initCollisionLog(CollisionLog* log)
 {
-	entry->numCollisions = 0;
+	log->array = NULL;
+	log->size = 0;
+	log->capacity = 0;
+}
 
-	//perform the quadratic probing algorithm
-	for (int i = 0; i < table->size; ++i)
+//appends a collision to the collision log
+//log: pointer to the collision log
+//key: the value of the element that was being stored
+//index: the index in the hash table where the collision occurred
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int recordCollision(CollisionLog* log, int key, int index)
+{
+	//the log is full, double its capacity unless the doubled array couldn't be addressed
+	if (log->size == log->capacity)
 	{
-		//compute index into the hash table
-		int index = (entry->key + (i * i)) % table->size;
-
-		//if the place at the index is empty, update the hash table and exit
-		if (table->array[index].status == EMPTY)
+		if (log->capacity > (long long)(SIZE_MAX / 2 / sizeof(CollisionRecord)))
 		{
-			table->array[index].key = entry->key;
-			table->array[index].status = OCCUPIED;
-			table->numOccupied++;
-			return index;
+			return -1;
 		}
-		//if the place at the index isn't empty, record the collision and continue with the next iteration
-		else
+		long long capacity = log->capacity == 0 ? INITIAL_COLLISION_LOG_SIZE : 2 * log->capacity;
+		CollisionRecord* array = (CollisionRecord*)realloc(log->array, (size_t)capacity * sizeof(CollisionRecord));
+		if (array == NULL)
 		{
-			entry->collisions[i] = index;
-			entry->numCollisions++;
+			return -1;
 		}
+		log->array = array;
+		log->capacity = capacity;
 	}
 
-	//the value couldn't be inserted into the hash table
-	return -1;
-}
-
-//tries to insert all the elements from the input list into the hash table, uses the insertHash function
-//hashTable: pointer to the hash table
-//inputList: the input list with entries to insert into the hash table
-void createHash(HashTable* hashTable, InputList inputList)
-{
-	hashTable->numOccupied = 0;
-
-	//set all hash table entries to empty
-	for (int i = 0; i < hashTable->size; ++i)
-	{
-		hashTable->array[i].status = EMPTY;
-	}
+	log->array[log->size].key = key;
+	log->array[log->size].index = index;
+	log->size++;
 
-	//go through the input list
-	for (int i = 0; i < inputList.size; ++i)
-	{
-		//and try to insert each input element into the hash table
-		insertHash(hashTable, &inputList.array[i]);
-	}
+	return 0;
 }
 
-//searches for the given entry in the hash table
-//hashTable: pointer to the hash table 
-//entry: pointer to the entry to search for, the index in the entry gets set to the index in the hash table where the entry was found, -1 if it was not found
-//returns: the index in the hash table where the entry was found, -1 if it was not found
-int searchHash(HashTable* table, SearchEntry* entry)
+//appends all the records of one collision log to another collision log
+//log: pointer to the collision log the records are appended to
+//other: pointer to the collision log whose records are appended, it is not changed
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int appendCollisionLog(CollisionLog* log, CollisionLog* other)
 {
-	//perform the quadratic probing algorithm
-	for (int i = 0; i < table->size; ++i)
+	if (log->size + other->size > log->capacity)
 	{
-		//compute index into the hash table
-		int index = (entry->key + (i * i)) % table->size;
-
-		if (table->array[index].status == EMPTY)
+		long long capacity = log->capacity == 0 ? INITIAL_COLLISION_LOG_SIZE : log->capacity;
+		while (capacity < log->size + other->size)
 		{
-			//the searched value was not found
-			entry->index = -1;
-			return -1;
+			if (capacity > (long long)(SIZE_MAX / 2 / sizeof(CollisionRecord)))
+			{
+				return -1;
+			}
+			capacity *= 2;
 		}
-		//if the place at the index contains the searched value, save the index and exit
-		else if (table->array[index].status == OCCUPIED && table->array[index].key == entry->key)
+
+		CollisionRecord* array = (CollisionRecord*)realloc(log->array, (size_t)capacity * sizeof(CollisionRecord));
+		if (array == NULL)
 		{
-			entry->index = index;
-			return index;
+			return -1;
 		}
+		log->array = array;
+		log->capacity = capacity;
 	}
 
-	//the searched value was not found
-	entry->index = -1;
-
-	return -1;
-}
+	if (other->size > 0)
+	{
+		memcpy(&log->array[log->size], other->array, (size_t)other->size * sizeof(CollisionRecord));
+	}
+	log->size += other->size;
 
-//frees the dynamically allocated memory associated with the hash table
-//hashTable: pointer to the hash table 
-void deleteHash(HashTable* hashTable)
-{
-	free(hashTable->array);
-	hashTable->array = NULL;
-	hashTable->size = 0;
-	hashTable->numOccupied = 0;
+	return 0;
 }
 
-//frees the dynamically allocated memory associated with the search list
-//searchList: pointer to the search list
-void deleteSearchList(SearchList* searchList)
+//frees the dynamically allocated memory associated with the collision log
+//log: pointer to the collision log
+void deleteCollisionLog(CollisionLog* log)
 {
-	free(searchList->array);
-	searchList->array = NULL;
-	searchList->numFound = 0;
-	searchList->size = 0;
+	free(log->array);
+	initCollisionLog(log);
 }
 
-//reads elements from the given file and creates a search list from them
-//fileName: the path to the search file
-//returns: a search list with the elements from the search file
-SearchList readSearchList(char* fileName)
+//checks whether a number is a prime number
+//n: the number to check
+//returns: 1 if the number is prime, 0 otherwise
+int isPrime(int n)
 {
-	//create empty search list
-	SearchList searchList;
-	searchList.array = NULL;
-	searchList.numFound = 0;
-	searchList.size = 0;
-
-	//try to open the search file, return empty search list if it fails
-	FILE* file;
-	file = fopen(fileName, "r");
-	if (file == NULL)
+	if (n < 2)
 	{
-		printf("Error: cannot open file %s!\n", fileName);
-		return searchList;
+		return 0;
 	}
 
-	//try to allocate memory for the search list, return empty search list if it fails
-	searchList.array = (SearchEntry*)malloc(MAX_SEARCH_SIZE * sizeof(SearchEntry));
-	if (searchList.array == NULL)
+	for (int i = 2; i <= n / i; ++i)
 	{
-		fclose(file);
-		printf("Error: couldn't allocate memory!\n");
-		return searchList;
+		if (n % i == 0)
+		{
+			return 0;
+		}
 	}
 
-	//read entries from the search file until the end of file or until the maximum allowed number of values is read
-	while (searchList.size < MAX_SEARCH_SIZE && fscanf(file, "%d", &searchList.array[searchList.size].key) != EOF)
+	return 1;
+}
+
+//computes the size of the array the hash table grows into
+//a power of two size doubles, so that the table keeps indexing with a mask instead of a division,
+//any other size grows to the smallest prime at least twice the current size, so that quadratic probing keeps reaching half of the entries
+//size: the current size of the array
+//returns: the new size, -1 if it would not fit into an int
+int nextHashSize(int size)
+{
+	if (size > (0x7fffffff - 1) / 2)
 	{
-		searchList.array[searchList.size].index = -1;
-		searchList.size++;
+		return -1;
 	}
 
-	fclose(file);
+	if (isPowerOfTwo(size))
+	{
+		return 2 * size;
+	}
 
-	//if nothing was read from the search file
-	if (searchList.size == 0)
+	int newSize = 2 * size + 1;
+	while (!isPrime(newSize))
 	{
-		deleteSearchList(&searchList); //free the memory of the search list
-		printf("Error: No retrieval data loaded from file %s!\n", fileName);
+		if (newSize == 0x7fffffff)
+		{
+			return -1;
+		}
+		newSize++;
 	}
 
-	return searchList;
+	return newSize;
 }
 
-//frees the dynamically allocated memory associated with the input list
-//searchList: pointer to the input list
-void deleteInputList(InputList* inputList)
+//allocates an array of hash table entries and sets all of them to empty
+//size: the number of entries
+//returns: pointer to the array, NULL if it was not possible to allocate the memory
+HashEntry* allocateEntries(int size)
 {
-	//free the memory of the arrays of collisions of all the entries
-	for (int i = 0; i < inputList->size; ++i)
+	HashEntry* array = (HashEntry*)malloc(size * sizeof(HashEntry));
+	if (array == NULL)
 	{
-		free(inputList->array[i].collisions);
-		inputList->array[i].collisions = NULL;
+		return NULL;
 	}
 
-	//free the memory of the input list
-	free(inputList->array);
-	inputList->array = NULL;
-	inputList->size = 0;
+	for (int i = 0; i < size; ++i)
+	{
+		array[i].status = EMPTY;
+	}
+
+	return array;
 }
 
-//reads elements from the given file and creates an input list from them
-//fileName: the path to the input file
-//hashSize: the size of the hash table (this is needed to allocate the space for storing possible collisions)
-//returns: an input list with the elements from the input file
-InputList readInputList(char* fileName, int hashSize)
+//position of a lookup or insert in its probe sequence
+typedef struct Probe Probe;
+struct Probe
 {
-	//create empty input list
-	InputList inputList;
-	inputList.array = NULL;
-	inputList.size = 0;
+	unsigned int index; //the index of the current probe
+	unsigned int step; //the distance to the next probe, kept below the size of the array
+	int i; //the number of the current probe
+};
 
-	//try to open the input file, return empty input list if it fails
-	FILE* file;
-	file = fopen(fileName, "r");
-	if (file == NULL)
+//starts a probe sequence at the home index of a key
+//the hash function, probe sequence and geometry are constants in every specialized caller, so the switches are resolved at compile time
+//probe: pointer to the probe
+//key: the key being probed for
+//size: the size of the array of entries
+//hashFunction: the hash function giving the home index
+//probeSequence: the sequence of indices probed after the home index
+//pow2: whether the size is a power of two, indices are then reduced with a mask
+FORCE_INLINE void probeStart(Probe* probe, int key, int size, HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
+{
+	unsigned int mask = (unsigned int)size - 1;
+
+	switch (hashFunction)
 	{
-		printf("Error: cannot open file %s!\n", fileName);
-		return inputList;
+	case HASH_FIBONACCI:
+		probe->index = reduceHash(hashFibonacci(key), size);
+		break;
+	case HASH_MURMUR:
+		probe->index = reduceHash(hashMurmur(key), size);
+		break;
+	default:
+		if (pow2)
+		{
+			probe->index = (unsigned int)key & mask;
+		}
+		else
+		{
+			int index = key % size;
+			probe->index = (unsigned int)(index < 0 ? index + size : index);
+		}
+		break;
 	}
 
-	//try to allocate memory for the input list, return empty input list if it fails
-	inputList.array = (InputEntry*)malloc(MAX_INPUT_SIZE * sizeof(InputEntry));
-	if (inputList.array == NULL)
+	switch (probeSequence)
 	{
-		fclose(file);
-		printf("Error: couldn't allocate memory!\n");
-		return inputList;
+	case PROBE_DOUBLE:
+		//the step must be coprime with the size to reach every index: odd for a power of two, anything below a prime size
+		//this is the only division of the sequence and it is done once per key
+		probe->step = pow2 ? ((hashMurmur(~key) | 1) & mask) : (size > 1 ? 1 + hashMurmur(~key) % (unsigned int)(size - 1) : 0);
+		break;
+	default:
+		probe->step = pow2 ? (1 & mask) : 1;
+		break;
 	}
 
-	//read entries from the input file until the end of file or until the maximum allowed number of values is read
-	while (inputList.size < MAX_INPUT_SIZE && fscanf(file, "%d", &inputList.array[inputList.size].key) != EOF)
+	probe->i = 0;
+}
+
+//moves to the next index of a probe sequence
+//probe: pointer to the probe
+//size: the size of the array of entries
+//probeSequence: the sequence of indices probed after the home index
+//pow2: whether the size is a power of two
+FORCE_INLINE void probeNext(Probe* probe, int size, ProbeSequence probeSequence, int pow2)
+{
+	unsigned int mask = (unsigned int)size - 1;
+
+	probe->i++;
+
+	switch (probeSequence)
 	{
-		//try to allocate memory for the array of collisions for this entry, return empty input list if it fails
-		inputList.array[inputList.size].collisions = (int*)malloc(hashSize * sizeof(int));
-		if (inputList.array[inputList.size].collisions == NULL)
+	case PROBE_LINEAR:
+		probe->index += 1;
+		break;
+	case PROBE_TRIANGULAR:
+		//the triangular sequence is only used with power of two sizes
+		probe->index += (unsigned int)probe->i;
+		break;
+	case PROBE_DOUBLE:
+		probe->index += probe->step;
+		break;
+	default:
+		//(i+1)^2 - i^2 = 2i+1, so the distance to the next probe grows by 2
+		probe->index += probe->step;
+		probe->step += 2;
+		if (pow2)
 		{
-			fclose(file);
-			deleteInputList(&inputList); //free the memory of the input list
-			printf("Error: couldn't allocate memory!\n");
-			return inputList;
+			probe->step &= mask;
+		}
+		else if (probe->step >= (unsigned int)size)
+		{
+			probe->step -= (unsigned int)size;
 		}
+		break;
+	}
 
-		inputList.array[inputList.size].numCollisions = 0;
-		inputList.size++;
+	if (pow2)
+	{
+		probe->index &= mask;
+	}
+	else if (probe->index >= (unsigned int)size)
+	{
+		probe->index -= (unsigned int)size;
 	}
+}
 
-	fclose(file);
+//places a key into an array of hash table entries, no collisions are recorded
+//this is used to move entries between arrays when the hash table grows
+//array: the array of entries
+//size: the size of the array
+//key: the key to place
+//hashFunction, probeSequence, pow2: the policy, see probeStart
+//returns: the index in the array where the key was placed, -1 if there was no empty entry on the probe sequence
+FORCE_INLINE int placeKeyWith(HashEntry* array, int size, int key, HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
+{
+	Probe probe;
+	probeStart(&probe, key, size, hashFunction, probeSequence, pow2);
 
-	//if nothing was read from the input file
-	if (inputList.size == 0)
+	for (int i = 0; i < size; ++i)
 	{
-		deleteInputList(&inputList); //free the memory of the input list
-		printf("Error: No input data loaded from file %s!\n", fileName);
+		if (array[probe.index].status == EMPTY)
+		{
+			array[probe.index].key = key;
+			array[probe.index].status = OCCUPIED;
+			return (int)probe.index;
+		}
+
+		probeNext(&probe, size, probeSequence, pow2);
 	}
 
-	return inputList;
+	return -1;
 }
 
-//prints the statistics
-//inputFile: the path to the input file
-//searchFile: the path to the search file
-//hashTable: the hashTable
-//searchList: the list of entries for searching
-//inputList: the list of entries for storage
-//storageTime: the time in miliseconds that the storage took
-//searchTime: the time in miliseconds that the search took
-void printStats(char* inputFile, char* searchFile, HashTable hashTable, SearchList searchList, InputList inputList,
-	float storageTime, float searchTime)
+//searches for a key in an array of hash table entries
+//array: the array of entries
+//size: the size of the array
+//key: the key to search for
+//hashFunction, probeSequence, pow2: the policy, see probeStart
+//returns: the index in the array where the key was found, -1 if it was not found
+FORCE_INLINE int probeSearchWith(HashEntry* array, int size, int key, HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
 {
-	printf("Data storage and retrieval:\n");
-	printf("a comparison of hashing and directed search of sorted data\n");
-	printf("================================\n\n");
+	Probe probe;
+	probeStart(&probe, key, size, hashFunction, probeSequence, pow2);
 
-	printf("Input data loaded from file %s\n", inputFile);
-	printf("Retrieval data loaded from file %s\n", searchFile);
-	printf("Storage Method: Hashing\n");
-	printf("Number of items stored in the hash table: %d\n", hashTable.numOccupied);
-	printf("Number of items searched: %d\n", searchList.size);
-	printf("Number of items found: %d\n\n", searchList.numFound);
+	for (int i = 0; i < size; ++i)
+	{
+		if (array[probe.index].status == EMPTY)
+		{
+			return -1;
+		}
+		else if (array[probe.index].key == key)
+		{
+			return (int)probe.index;
+		}
 
-	printf("Storage details:\n\n");
+		probeNext(&probe, size, probeSequence, pow2);
+	}
+
+	return -1;
+}
 
-	printf("  Hash table size: %d\n", hashTable.size);
+//searches for a key in an array of hash table entries like probeSearchWith and counts the entries it reads
+//it is only used for the probe telemetry, so the searches that are timed don't count anything
+//array: the array of entries
+//size: the size of the array
+//key: the key to search for
+//numProbes: the number of entries read is saved here, including the empty entry that ended a search that failed
+//hashFunction, probeSequence, pow2: the policy, see probeStart
+//returns: the index in the array where the key was found, -1 if it was not found
+FORCE_INLINE int probeMeasureWith(HashEntry* array, int size, int key, int* numProbes, HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
+{
+	Probe probe;
+	probeStart(&probe, key, size, hashFunction, probeSequence, pow2);
 
-	for (int i = 0; i < inputList.size; ++i)
+	for (int i = 0; i < size; ++i)
 	{
-		for (int j = 0; j < inputList.array[i].numCollisions; ++j)
+		*numProbes = i + 1;
+		if (array[probe.index].status == EMPTY)
+		{
+			return -1;
+		}
+		else if (array[probe.index].key == key)
 		{
-			printf("  Collision occurred saving item with value %d at hash table location %d\n", inputList.array[i].key, inputList.array[i].collisions[j]);
+			return (int)probe.index;
 		}
+
+		probeNext(&probe, size, probeSequence, pow2);
 	}
 
-	printf("\nRetrieval details:\n\n");
-	for (int i = 0; i < searchList.size; ++i)
+	return -1;
+}
+
+//probes the current array of the hash table for an empty entry for the given entry and records the collisions
+//hashTable: pointer to the hash table
+//entry: pointer to the entry that is to be inserted, its number of collisions is increased by the collisions that occur
+//log: pointer to the collision log, NULL if the collisions shouldn't be recorded
+//hashFunction, probeSequence, pow2: the policy, see probeStart
+//returns: the index where the entry was inserted, -1 if there was no empty entry on the probe sequence, -2 if it was not possible to allocate the memory
+FORCE_INLINE int insertProbeWith(HashTable* table, InputEntry* entry, CollisionLog* log, HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
+{
+	HashEntry* array = table->array;
+	int size = table->size;
+
+	Probe probe;
+	probeStart(&probe, entry->key, size, hashFunction, probeSequence, pow2);
+
+	for (int i = 0; i < size; ++i)
 	{
-		if (searchList.array[i].index != -1)
+		//if the place at the index is empty, update the hash table and exit
+		if (array[probe.index].status == EMPTY)
 		{
-			printf("  Value %d found in the hash table at position %d\n", searchList.array[i].key, searchList.array[i].index);
+			array[probe.index].key = entry->key;
+			array[probe.index].status = OCCUPIED;
+			table->numOccupied++;
+			return (int)probe.index;
 		}
-		else
+
+		//if the place at the index isn't empty, record the collision and continue with the next probe
+		entry->numCollisions++;
+		if (log != NULL && recordCollision(log, entry->key, (int)probe.index) == -1)
 		{
-			printf("  Value %d not found in the hash table\n", searchList.array[i].key);
+			return -2;
 		}
-	}
 
-	printf("\nExecution times:\n\n");
+		probeNext(&probe, size, probeSequence, pow2);
+	}
 
-	printf("  Time to store data: %f ms\n", storageTime);
-	printf("  Time to retrieve data: %f ms\n\n", searchTime);
+	return -1;
+}
 
-	printf("Hash table is %3.0f%% full.\n\n", (hashTable.numOccupied * 100.0) / hashTable.size);
+//computes the home index of a key, the first index of its probe sequence
+//key: the key
+//size: the size of the array of entries
+//hashFunction, probeSequence, pow2: the policy, see probeStart
+//returns: the home index of the key
+FORCE_INLINE unsigned int homeIndexWith(int key, int size, HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
+{
+	Probe probe;
+	probeStart(&probe, key, size, hashFunction, probeSequence, pow2);
 
-	printf("================================\n\n");
+	return probe.index;
 }
 
-int main(int argc, char* argv[])
+//probes for an empty entry for the given entry, but only as long as the probe sequence stays within a region of the array
+//threads of a parallel build each own one region, so they never write to the same entry
+//when the probe sequence leaves the region, the collisions counted and recorded for the entry are rolled back,
+//so the entry can be inserted again later as if this attempt never happened
+//array: the array of entries
+//size: the size of the array
+//entry: pointer to the entry that is to be inserted, its number of collisions is increased by the collisions that occur
+//low, high: the region of the array, from index low up to but not including index high
+//log: pointer to the collision log of the region, NULL if the collisions shouldn't be recorded
+//hashFunction, probeSequence, pow2: the policy, see probeStart
+//returns: the index where the entry was inserted, -1 if the probe sequence left the region, -2 if it was not possible to allocate the memory
+FORCE_INLINE int insertRegionWith(HashEntry* array, int size, InputEntry* entry, unsigned int low, unsigned int high, CollisionLog* log,
+	HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
 {
-	//check the number of arguments
-	if (argc != 4)
-	{
-		//wrong number of arguments
-		printf("Error: 3 arguments required!\n");
-		return -1;
-	}
+	long long logSize = log != NULL ? log->size : 0;
 
-	//get the hash table size
-	int hashSize = atoi(argv[3]);
+	Probe probe;
+	probeStart(&probe, entry->key, size, hashFunction, probeSequence, pow2);
 
-	//check if the hash table size is valid
-	if (hashSize <= 0)
+	for (int i = 0; i < size && probe.index >= low && probe.index < high; ++i)
 	{
-		//invalid hash table size
-		printf("Error: hash table size must be greater than 0!\n");
-		return -1;
-	}
+		if (array[probe.index].status == EMPTY)
+		{
+			array[probe.index].key = entry->key;
+			array[probe.index].status = OCCUPIED;
+			return (int)probe.index;
+		}
 
-	//read the input data from the specified file and store it in the input list
-	InputList inputList = readInputList(argv[1], hashSize);
-	if (inputList.size == 0)
-	{
-		//nothing was read
-		return -1; 
+		entry->numCollisions++;
+		if (log != NULL && recordCollision(log, entry->key, (int)probe.index) == -1)
+		{
+			return -2;
+		}
+
+		probeNext(&probe, size, probeSequence, pow2);
 	}
 
-	//read the search data from the specified file and store it in the search list
-	SearchList searchList = readSearchList(argv[2]);
-	if (searchList.size == 0)
+	//roll back the collisions of this attempt
+	entry->numCollisions = 0;
+	if (log != NULL)
 	{
-		//nothing was read
-		//free dynamically allocated memory
-		deleteInputList(&inputList);
-		return -1;
+		log->size = logSize;
 	}
 
-	//allocate the hash table
-	HashTable hashTable;
-	hashTable.array = (HashEntry*)malloc(hashSize * sizeof(HashEntry));
+	return -1;
+}
 
-	//if there was an allocation error
-	if (hashTable.array == NULL)
+//state of one lookup in flight during a batched search
+typedef struct ProbeLane ProbeLane;
+struct ProbeLane
+{
+	SearchEntry* entry; //the entry being searched for, NULL if the lane is free
+	Probe probe; //the position in the probe sequence, the entry at its index has been prefetched
+};
+
+//searches for many entries in the current array of the hash table at once
+//BATCH_LANES lookups are in flight at the same time, each of them advances by one probe in turn,
+//and the entry of the next probe of a lookup is prefetched while the other lanes are being resolved,
+//so the cache misses of independent lookups overlap instead of being paid one after another
+//hashTable: pointer to the hash table, no rehash may be in progress
+//entries: the entries to search for, the index in each entry is set as in searchHash
+//count: the number of entries
+//hashFunction, probeSequence, pow2: the policy, see probeStart
+//returns: the number of entries that were found
+FORCE_INLINE int searchBatchWith(HashTable* table, SearchEntry* entries, int count, HashFunction hashFunction, ProbeSequence probeSequence, int pow2)
+{
+	HashEntry* array = table->array;
+	int size = table->size;
+	int numFound = 0;
+
+	//start a lookup in every lane
+	ProbeLane lanes[BATCH_LANES];
+	int next = 0; //the next entry to start searching for
+	int numActive = 0; //the number of lanes with a lookup in flight
+	for (int l = 0; l < BATCH_LANES; ++l)
 	{
-		printf("Error: couldn't allocate memory!\n");
-		//free dynamically allocated memory
-		deleteInputList(&inputList);
-		deleteSearchList(&searchList);
-		return -1;
+		lanes[l].entry = NULL;
+		if (next < count)
+		{
+			lanes[l].entry = &entries[next];
+			probeStart(&lanes[l].probe, entries[next].key, size, hashFunction, probeSequence, pow2);
+			__builtin_prefetch(&array[lanes[l].probe.index]);
+			next++;
+			numActive++;
+		}
 	}
 
-	hashTable.size = hashSize;
+	while (numActive > 0)
+	{
+		for (int l = 0; l < BATCH_LANES; ++l)
+		{
+			ProbeLane* lane = &lanes[l];
+			if (lane->entry == NULL)
+			{
+				continue;
+			}
+
+			HashEntry* hashEntry = &array[lane->probe.index];
+			if (hashEntry->status == EMPTY)
+			{
+				//the searched value was not found
+				lane->entry->index = -1;
+			}
+			else if (hashEntry->key == lane->entry->key)
+			{
+				//the searched value was found
+				lane->entry->index = (int)lane->probe.index;
+				numFound++;
+			}
+			else if (lane->probe.i + 1 < size)
+			{
+				//continue with the next probe, it is resolved in the next round
+				probeNext(&lane->probe, size, probeSequence, pow2);
+				__builtin_prefetch(&array[lane->probe.index]);
+				continue;
+			}
+			else
+			{
+				//the whole probe sequence was searched
+				lane->entry->index = -1;
+			}
+
+			//the lookup in this lane is finished, start the next one
+			if (next < count)
+			{
+				lane->entry = &entries[next];
+				probeStart(&lane->probe, entries[next].key, size, hashFunction, probeSequence, pow2);
+				__builtin_prefetch(&array[lane->probe.index]);
+				next++;
+			}
+			else
+			{
+				lane->entry = NULL;
+				numActive--;
+			}
+		}
+	}
+
+	return numFound;
+}
+
+//defines the probing functions specialized for one policy and the HashPolicy structure pointing to them
+//NAME: suffix of the names of the functions
+//HASH, PROBE, POW2: the policy, see probeStart
+#define DEFINE_HASH_POLICY(NAME, HASH, PROBE, POW2) \
+	static int place_##NAME(HashEntry* array, int size, int key) \
+	{ \
+		return placeKeyWith(array, size, key, HASH, PROBE, POW2); \
+	} \
+	static unsigned int home_##NAME(int key, int size) \
+	{ \
+		return homeIndexWith(key, size, HASH, PROBE, POW2); \
+	} \
+	static int search_##NAME(HashEntry* array, int size, int key) \
+	{ \
+		return probeSearchWith(array, size, key, HASH, PROBE, POW2); \
+	} \
+	static int measure_##NAME(HashEntry* array, int size, int key, int* numProbes) \
+	{ \
+		return probeMeasureWith(array, size, key, numProbes, HASH, PROBE, POW2); \
+	} \
+	static int insert_##NAME(HashTable* table, InputEntry* entry, CollisionLog* log) \
+	{ \
+		return insertProbeWith(table, entry, log, HASH, PROBE, POW2); \
+	} \
+	static int searchBatch_##NAME(HashTable* table, SearchEntry* entries, int count) \
+	{ \
+		return searchBatchWith(table, entries, count, HASH, PROBE, POW2); \
+	} \
+	static int insertRegion_##NAME(HashEntry* array, int size, InputEntry* entry, unsigned int low, unsigned int high, CollisionLog* log) \
+	{ \
+		return insertRegionWith(array, size, entry, low, high, log, HASH, PROBE, POW2); \
+	} \
+	static const HashPolicy policy_##NAME = \
+		{ place_##NAME, home_##NAME, search_##NAME, measure_##NAME, insert_##NAME, searchBatch_##NAME, insertRegion_##NAME };
+
+//defines the policies of a hash function with every probe sequence, for power of two sizes and for any other size
+//the triangular sequence only visits every index of a power of two table, so tables using it are always a power of two
+#define DEFINE_HASH_POLICIES(NAME, HASH) \
+	DEFINE_HASH_POLICY(NAME##_quadratic, HASH, PROBE_QUADRATIC, 0) \
+	DEFINE_HASH_POLICY(NAME##_quadratic_pow2, HASH, PROBE_QUADRATIC, 1) \
+	DEFINE_HASH_POLICY(NAME##_linear, HASH, PROBE_LINEAR, 0) \
+	DEFINE_HASH_POLICY(NAME##_linear_pow2, HASH, PROBE_LINEAR, 1) \
+	DEFINE_HASH_POLICY(NAME##_triangular_pow2, HASH, PROBE_TRIANGULAR, 1) \
+	DEFINE_HASH_POLICY(NAME##_double, HASH, PROBE_DOUBLE, 0) \
+	DEFINE_HASH_POLICY(NAME##_double_pow2, HASH, PROBE_DOUBLE, 1)
+
+DEFINE_HASH_POLICIES(modulo, HASH_MODULO)
+DEFINE_HASH_POLICIES(fibonacci, HASH_FIBONACCI)
+DEFINE_HASH_POLICIES(murmur, HASH_MURMUR)
+
+//the specialized probing functions indexed by hash function, probe sequence and whether the size is a power of two
+static const HashPolicy* const HASH_POLICIES[3][4][2] =
+{
+	{
+		{ &policy_modulo_quadratic, &policy_modulo_quadratic_pow2 },
+		{ &policy_modulo_linear, &policy_modulo_linear_pow2 },
+		{ &policy_modulo_triangular_pow2, &policy_modulo_triangular_pow2 },
+		{ &policy_modulo_double, &policy_modulo_double_pow2 }
+	},
+	{
+		{ &policy_fibonacci_quadratic, &policy_fibonacci_quadratic_pow2 },
+		{ &policy_fibonacci_linear, &policy_fibonacci_linear_pow2 },
+		{ &policy_fibonacci_triangular_pow2, &policy_fibonacci_triangular_pow2 },
+		{ &policy_fibonacci_double, &policy_fibonacci_double_pow2 }
+	},
+	{
+		{ &policy_murmur_quadratic, &policy_murmur_quadratic_pow2 },
+		{ &policy_murmur_linear, &policy_murmur_linear_pow2 },
+		{ &policy_murmur_triangular_pow2, &policy_murmur_triangular_pow2 },
+		{ &policy_murmur_double, &policy_murmur_double_pow2 }
+	}
+};
+
+//selects the probing functions for the hash function, probe sequence and current size of the hash table
+//hashTable: pointer to the hash table
+void selectPolicy(HashTable* table)
+{
+	table->policy = HASH_POLICIES[table->hashFunction][table->probeSequence][isPowerOfTwo(table->size)];
+}
+
+//rebuilds the hash table at once into an array larger than the current one, this also completes a rehash that is in progress
+//it is only used when moving an entry during an incremental rehash fails, which quadratic probing makes possible but rare
+//hashTable: pointer to the hash table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int rebuildHash(HashTable* table)
+{
+	int newSize = table->size;
+
+	while (1)
+	{
+		newSize = nextHashSize(newSize);
+		if (newSize == -1)
+		{
+			return -1;
+		}
+
+		HashEntry* newArray = allocateEntries(newSize);
+		if (newArray == NULL)
+		{
+			return -1;
+		}
+
+		//place the entries of the current array and the entries of the old array that were not moved yet
+		int placed = 1;
+		for (int i = 0; placed && i < table->size; ++i)
+		{
+			if (table->array[i].status == OCCUPIED)
+			{
+				placed = table->policy->place(newArray, newSize, table->array[i].key) != -1;
+			}
+		}
+		for (int i = table->rehashIndex; placed && table->oldArray != NULL && i < table->oldSize; ++i)
+		{
+			if (table->oldArray[i].status == OCCUPIED)
+			{
+				placed = table->policy->place(newArray, newSize, table->oldArray[i].key) != -1;
+			}
+		}
+
+		//some entry didn't fit, try again with an even larger array
+		if (!placed)
+		{
+			free(newArray);
+			continue;
+		}
+
+		free(table->array);
+		free(table->oldArray);
+		table->array = newArray;
+		table->size = newSize;
+		table->oldArray = NULL;
+		table->oldSize = 0;
+		table->rehashIndex = 0;
+		table->numGrowths++;
+
+		return 0;
+	}
+}
+
+//moves buckets of the old array into the current array, frees the old array when all of its buckets have been moved
+//hashTable: pointer to the hash table
+//count: the maximum number of buckets to move
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int migrateBuckets(HashTable* table, int count)
+{
+	for (int i = 0; i < count && table->rehashIndex < table->oldSize; ++i)
+	{
+		HashEntry* entry = &table->oldArray[table->rehashIndex];
+
+		//the old array is left intact so that lookups can keep following its probe sequences
+		if (entry->status == OCCUPIED && table->policy->place(table->array, table->size, entry->key) == -1)
+		{
+			return rebuildHash(table);
+		}
+
+		table->rehashIndex++;
+	}
+
+	//all the buckets have been moved
+	if (table->oldArray != NULL && table->rehashIndex == table->oldSize)
+	{
+		free(table->oldArray);
+		table->oldArray = NULL;
+		table->oldSize = 0;
+		table->rehashIndex = 0;
+	}
+
+	return 0;
+}
+
+//completes a rehash that is in progress by moving all the remaining buckets of the old array
+//hashTable: pointer to the hash table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int finishRehash(HashTable* table)
+{
+	if (table->oldArray == NULL)
+	{
+		return 0;
+	}
+
+	return migrateBuckets(table, table->oldSize - table->rehashIndex);
+}
+
+//starts growing the hash table: allocates a larger array and makes the current array the old array whose buckets are moved by the following inserts
+//the buckets moved per insert are chosen so that the rehash is complete before the load factor triggers the next growth,
+//so a rehash is still in progress only when an insert found no empty entry on its probe sequence first; it is then completed here,
+//which moves at most the buckets of the old array that are left
+//hashTable: pointer to the hash table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int growHash(HashTable* table)
+{
+	if (finishRehash(table) == -1)
+	{
+		return -1;
+	}
+
+	int newSize = nextHashSize(table->size);
+	if (newSize == -1)
+	{
+		return -1;
+	}
+
+	HashEntry* newArray = allocateEntries(newSize);
+	if (newArray == NULL)
+	{
+		return -1;
+	}
+
+	table->oldArray = table->array;
+	table->oldSize = table->size;
+	table->rehashIndex = 0;
+	table->array = newArray;
+	table->size = newSize;
+	table->numGrowths++;
+
+	//the load factor triggers the next growth after insertsLeft more inserts, by then all the old buckets must have been moved
+	long long insertsLeft = (long long)(table->maxLoad * newSize) - table->numOccupied;
+	long long step = insertsLeft > 0 ? (table->oldSize + insertsLeft - 1) / insertsLeft : table->oldSize;
+	table->migrateStep = step > table->rehashStep ? (int)step : table->rehashStep;
+
+	return 0;
+}
+
+//initializes an empty hash table
+//hashTable: pointer to the hash table
+//size: the initial size of the array of entries
+//maxLoad: the maximum allowed ratio of occupied entries to the size of the array
+//rehashStep: the number of buckets moved per insert while a rehash is in progress
+//hashFunction: the hash function giving the home index of a key
+//probeSequence: the sequence of indices probed after the home index, with PROBE_TRIANGULAR the size is rounded up to a power of two
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int initHash(HashTable* table, int size, double maxLoad, int rehashStep, HashFunction hashFunction, ProbeSequence probeSequence)
+{
+	//the triangular sequence visits every index only in a power of two table
+	if (probeSequence == PROBE_TRIANGULAR)
+	{
+		int roundedSize = 1;
+		while (roundedSize < size && roundedSize <= 0x7fffffff / 2)
+		{
+			roundedSize *= 2;
+		}
+		size = roundedSize;
+	}
+
+	table->array = allocateEntries(size);
+	table->size = size;
+	table->numOccupied = 0;
+	table->initialSize = size;
+	table->maxLoad = maxLoad;
+	table->rehashStep = rehashStep;
+	table->migrateStep = rehashStep;
+	table->oldArray = NULL;
+	table->oldSize = 0;
+	table->rehashIndex = 0;
+	table->numGrowths = 0;
+	table->hashFunction = hashFunction;
+	table->probeSequence = probeSequence;
+	table->numBuildThreads = 1;
+	table->numDeferred = 0;
+	selectPolicy(table);
+
+	return table->array == NULL ? -1 : 0;
+}
+
+//tries to insert one entry into the hash table, uses the probing functions of the policy of the table
+//if a rehash is in progress, some buckets of the old array are moved first
+//the table grows if the insert would exceed the maximum load factor or if there is no empty entry on the probe sequence
+//hashTable: pointer to the hash table 
+//entry: pointer to the entry that is to be inserted, the number of collisions that occurred is saved into the entry
+//log: pointer to the collision log where the collisions are recorded, NULL if they shouldn't be recorded
+//returns: the index in the hash table where the entry was inserted, -1 if it was not possible to allocate the memory
+int insertHash(HashTable* table, InputEntry* entry, CollisionLog* log)
+{
+	entry->numCollisions = 0;
+
+	//do a bounded part of the rehash that is in progress
+	if (table->oldArray != NULL && migrateBuckets(table, table->migrateStep) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	//grow the table if the insert would exceed the maximum load factor
+	if (table->numOccupied + 1 > table->maxLoad * table->size && growHash(table) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	while (1)
+	{
+		//perform the probing algorithm
+		int index = table->policy->insert(table, entry, log);
+		if (index >= 0)
+		{
+			return index;
+		}
+		else if (index == -2)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+
+		//there was no empty place on the probe sequence, grow the table and try again
+		if (growHash(table) == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+	}
+}
+
+//empties the hash table and shrinks it back to its initial size, and empties the collision log
+//hashTable: pointer to the hash table
+//log: pointer to the collision log, NULL if the collisions are not recorded
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int resetHash(HashTable* hashTable, CollisionLog* log)
+{
+	hashTable->numOccupied = 0;
+	hashTable->numBuildThreads = 1;
+	hashTable->numDeferred = 0;
+
+	if (log != NULL)
+	{
+		log->size = 0;
+	}
+	hashTable->numGrowths = 0;
+
+	free(hashTable->oldArray);
+	hashTable->oldArray = NULL;
+	hashTable->oldSize = 0;
+	hashTable->rehashIndex = 0;
+
+	//if the table grew during a previous run, go back to the initial size
+	if (hashTable->size != hashTable->initialSize)
+	{
+		free(hashTable->array);
+		hashTable->array = (HashEntry*)malloc(hashTable->initialSize * sizeof(HashEntry));
+		hashTable->size = hashTable->initialSize;
+		if (hashTable->array == NULL)
+		{
+			hashTable->size = 0;
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+		selectPolicy(hashTable);
+	}
+
+	//set all hash table entries to empty
+	for (int i = 0; i < hashTable->size; ++i)
+	{
+		hashTable->array[i].status = EMPTY;
+	}
+
+	return 0;
+}
+
+//tries to insert all the elements from the input list into the hash table, uses the insertHash function
+//the table is reset to its initial size first, a rehash that is still in progress at the end is completed
+//hashTable: pointer to the hash table
+//inputList: the input list with entries to insert into the hash table
+//log: pointer to the collision log, it is emptied first and then the collisions are recorded into it, NULL if they shouldn't be recorded
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createHash(HashTable* hashTable, InputList inputList, CollisionLog* log)
+{
+	if (resetHash(hashTable, log) == -1)
+	{
+		return -1;
+	}
+
+	//go through the input list
+	for (int i = 0; i < inputList.size; ++i)
+	{
+		//and try to insert each input element into the hash table
+		if (insertHash(hashTable, &inputList.array[i], log) == -1)
+		{
+			return -1;
+		}
+	}
+
+	if (finishRehash(hashTable) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+//the work of one thread of a parallel build of the hash table
+//the input list is split into equal chunks, one per thread, and the array of entries into equal regions, one per thread
+typedef struct BuildThread BuildThread;
+struct BuildThread
+{
+	pthread_t thread; //the thread
+	int id; //the number of the thread, it is also the number of its region
+	int numThreads; //the number of threads of the build
+	HashTable* table; //the hash table being built
+	InputList inputList; //the input list with entries to insert
+	unsigned char* regions; //the region of the home index of every entry of the input list, shared by all threads
+	int* order; //the indices of the entries of the input list partitioned by region, shared by all threads
+	int first; //the first entry of the chunk of the input list of the thread
+	int last; //one past the last entry of the chunk of the input list of the thread
+	int offsets[MAX_BUILD_THREADS]; //the number of entries of the chunk in every region, then the positions in order where they are written
+	int start; //the position in order of the first entry of the region of the thread
+	int end; //one past the position in order of the last entry of the region of the thread
+	int numPlaced; //the number of entries of its region the thread inserted
+	int numDeferred; //the number of entries whose probe sequence left the region, they are moved to the beginning of the region in order
+	CollisionLog log; //the collisions that occurred in the region of the thread
+	int recordCollisions; //whether the collisions are recorded into the log of the thread
+	int failed; //1 if it was not possible to allocate the memory
+};
+
+//computes the region of the home index of every entry of the chunk of the thread and counts the entries of the chunk in every region
+//it is the first pass of a radix partition of the input list by the high bits of the home index
+//arg: pointer to the BuildThread
+//returns: NULL
+void* countRegions(void* arg)
+{
+	BuildThread* build = (BuildThread*)arg;
+	HashTable* table = build->table;
+
+	for (int r = 0; r < build->numThreads; ++r)
+	{
+		build->offsets[r] = 0;
+	}
+
+	for (int i = build->first; i < build->last; ++i)
+	{
+		unsigned int home = table->policy->home(build->inputList.array[i].key, table->size);
+		int region = (int)(((unsigned long long)home * build->numThreads) / table->size);
+		build->regions[i] = (unsigned char)region;
+		build->offsets[region]++;
+	}
+
+	return NULL;
+}
+
+//writes the indices of the entries of the chunk of the thread to their region in the order array
+//it is the second pass of the radix partition, the entries of a region keep the order of the input list
+//arg: pointer to the BuildThread, its offsets are the positions where the entries of each region are written
+//returns: NULL
+void* scatterRegions(void* arg)
+{
+	BuildThread* build = (BuildThread*)arg;
+
+	for (int i = build->first; i < build->last; ++i)
+	{
+		build->order[build->offsets[build->regions[i]]++] = i;
+	}
+
+	return NULL;
+}
+
+//inserts the entries whose home index is in the region of the thread, no other thread writes to the region
+//entries whose probe sequence leaves the region are deferred
+//arg: pointer to the BuildThread
+//returns: NULL
+void* fillRegion(void* arg)
+{
+	BuildThread* build = (BuildThread*)arg;
+	HashTable* table = build->table;
+	CollisionLog* log = build->recordCollisions ? &build->log : NULL;
+
+	//the region contains exactly the indices whose region, as computed by countRegions, is the number of the thread
+	unsigned int low = (unsigned int)(((unsigned long long)build->id * table->size + build->numThreads - 1) / build->numThreads);
+	unsigned int high = (unsigned int)(((unsigned long long)(build->id + 1) * table->size + build->numThreads - 1) / build->numThreads);
+
+	build->numPlaced = 0;
+	build->numDeferred = 0;
+
+	for (int i = build->start; i < build->end; ++i)
+	{
+		InputEntry* entry = &build->inputList.array[build->order[i]];
+		entry->numCollisions = 0;
+
+		int index = table->policy->insertRegion(table->array, table->size, entry, low, high, log);
+		if (index >= 0)
+		{
+			build->numPlaced++;
+		}
+		else if (index == -1)
+		{
+			//the deferred entries are written over the part of the region that was already inserted
+			build->order[build->start + build->numDeferred++] = build->order[i];
+		}
+		else
+		{
+			build->failed = 1;
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+//runs a phase of a parallel build on all the threads and waits for them to finish
+//threads: the threads of the build
+//numThreads: the number of threads
+//work: the function the threads run
+void runBuildThreads(BuildThread* threads, int numThreads, void* (*work)(void*))
+{
+	int numStarted = 0;
+	for (; numStarted < numThreads; ++numStarted)
+	{
+		if (pthread_create(&threads[numStarted].thread, NULL, work, &threads[numStarted]) != 0)
+		{
+			break;
+		}
+	}
+
+	for (int t = 0; t < numStarted; ++t)
+	{
+		pthread_join(threads[t].thread, NULL);
+	}
+
+	//the threads that couldn't be started do their part on this thread
+	for (int t = numStarted; t < numThreads; ++t)
+	{
+		work(&threads[t]);
+	}
+}
+
+//inserts all the elements from the input list into the hash table using several threads
+//the table is reset and grown at once to the size it would have after inserting all the entries one by one,
+//the entries are radix-partitioned by the region of the array their home index falls into, one region per thread,
+//and every thread inserts the entries of its region without any locking, because no other thread writes to the region;
+//entries whose probe sequence leaves their region are inserted one by one with insertHash after all the threads finish
+//the table ends up with the same entries and occupancy as with createHash, but an entry may be at a different index
+//hashTable: pointer to the hash table
+//inputList: the input list with entries to insert into the hash table
+//log: pointer to the collision log, it is emptied first and then the collisions are recorded into it, NULL if they shouldn't be recorded
+//numThreads: the maximum number of threads, from 1 to MAX_BUILD_THREADS, at most one thread per MIN_BUILD_THREAD_ITEMS entries is used
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createHashParallel(HashTable* hashTable, InputList inputList, CollisionLog* log, int numThreads)
+{
+	//starting the threads costs more than inserting a small input
+	if (numThreads > inputList.size / MIN_BUILD_THREAD_ITEMS)
+	{
+		numThreads = inputList.size / MIN_BUILD_THREAD_ITEMS;
+	}
+	if (numThreads <= 1)
+	{
+		return createHash(hashTable, inputList, log);
+	}
+
+	if (resetHash(hashTable, log) == -1)
+	{
+		return -1;
+	}
+
+	//grow the table to the size the load factor would lead to
+	int newSize = hashTable->size;
+	int numGrowths = 0;
+	while (inputList.size > hashTable->maxLoad * newSize)
+	{
+		newSize = nextHashSize(newSize);
+		if (newSize == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+		numGrowths++;
+	}
+	if (newSize != hashTable->size)
+	{
+		free(hashTable->array);
+		hashTable->array = allocateEntries(newSize);
+		hashTable->size = newSize;
+		if (hashTable->array == NULL)
+		{
+			hashTable->size = 0;
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+		hashTable->numGrowths = numGrowths;
+		selectPolicy(hashTable);
+	}
+
+	unsigned char* regions = (unsigned char*)malloc((size_t)inputList.size * sizeof(unsigned char));
+	int* order = (int*)malloc((size_t)inputList.size * sizeof(int));
+	BuildThread* threads = (BuildThread*)malloc((size_t)numThreads * sizeof(BuildThread));
+	if (regions == NULL || order == NULL || threads == NULL)
+	{
+		free(regions);
+		free(order);
+		free(threads);
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	for (int t = 0; t < numThreads; ++t)
+	{
+		threads[t].id = t;
+		threads[t].numThreads = numThreads;
+		threads[t].table = hashTable;
+		threads[t].inputList = inputList;
+		threads[t].regions = regions;
+		threads[t].order = order;
+		threads[t].first = (int)(((long long)t * inputList.size) / numThreads);
+		threads[t].last = (int)(((long long)(t + 1) * inputList.size) / numThreads);
+		threads[t].recordCollisions = log != NULL;
+		threads[t].failed = 0;
+		initCollisionLog(&threads[t].log);
+	}
+
+	//partition the input list by region: count the entries of every chunk in every region
+	runBuildThreads(threads, numThreads, countRegions);
+
+	//compute where every chunk writes the entries of every region, the regions follow each other in order and so do the chunks within a region
+	int position = 0;
+	for (int r = 0; r < numThreads; ++r)
+	{
+		threads[r].start = position;
+		for (int t = 0; t < numThreads; ++t)
+		{
+			int count = threads[t].offsets[r];
+			threads[t].offsets[r] = position;
+			position += count;
+		}
+		threads[r].end = position;
+	}
+
+	runBuildThreads(threads, numThreads, scatterRegions);
+
+	//fill the regions
+	runBuildThreads(threads, numThreads, fillRegion);
+
+	int result = 0;
+	for (int t = 0; t < numThreads; ++t)
+	{
+		hashTable->numOccupied += threads[t].numPlaced;
+		hashTable->numDeferred += threads[t].numDeferred;
+
+		if (threads[t].failed || (log != NULL && appendCollisionLog(log, &threads[t].log) == -1))
+		{
+			printf("Error: couldn't allocate memory!\n");
+			result = -1;
+		}
+	}
+
+	//insert the deferred entries, their collisions follow the collisions of the regions
+	for (int t = 0; result == 0 && t < numThreads; ++t)
+	{
+		for (int i = 0; result == 0 && i < threads[t].numDeferred; ++i)
+		{
+			if (insertHash(hashTable, &inputList.array[order[threads[t].start + i]], log) == -1)
+			{
+				result = -1;
+			}
+		}
+	}
+
+	if (result == 0 && finishRehash(hashTable) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		result = -1;
+	}
+	hashTable->numBuildThreads = numThreads;
+
+	for (int t = 0; t < numThreads; ++t)
+	{
+		deleteCollisionLog(&threads[t].log);
+	}
+	free(regions);
+	free(order);
+	free(threads);
+
+	return result;
+}
+
+//searches for the given entry in the hash table
+//while a rehash is in progress, the old array is searched too, the returned index is then an index into the old array
+//hashTable: pointer to the hash table 
+//entry: pointer to the entry to search for, the index in the entry gets set to the index in the hash table where the entry was found, -1 if it was not found
+//returns: the index in the hash table where the entry was found, -1 if it was not found
+int searchHash(HashTable* table, SearchEntry* entry)
+{
+	//perform the probing algorithm
+	int index = table->policy->search(table->array, table->size, entry->key);
+
+	//the entry may not have been moved from the old array yet
+	if (index == -1 && table->oldArray != NULL)
+	{
+		index = table->policy->search(table->oldArray, table->oldSize, entry->key);
+	}
+
+	entry->index = index;
+
+	return index;
+}
+
+//searches for many entries in the hash table at once, see searchBatchWith
+//hashTable: pointer to the hash table
+//entries: the entries to search for, the index in each entry is set as in searchHash
+//count: the number of entries
+//returns: the number of entries that were found
+int searchHashBatch(HashTable* table, SearchEntry* entries, int count)
+{
+	//while a rehash is in progress two arrays have to be searched, search the entries one by one
+	if (table->oldArray != NULL)
+	{
+		int numFound = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			if (searchHash(table, &entries[i]) != -1)
+			{
+				numFound++;
+			}
+		}
+
+		return numFound;
+	}
+
+	return table->policy->searchBatch(table, entries, count);
+}
+
+//collects the probe telemetry of the stored keys: looks up every key of the array and counts its probes,
+//and measures the runs of consecutive occupied entries
+//the table is read after it was built, so building it doesn't count anything
+//hashTable: pointer to the hash table, no rehash may be in progress
+//stats: pointer to the telemetry, it is emptied first
+void collectTableProbes(HashTable* table, ProbeStats* stats)
+{
+	HashEntry* array = table->array;
+	int size = table->size;
+
+	initProbeStats(stats, size);
+
+	int start = -1; //an empty entry, the runs are measured from it so that a run wrapping around the end is counted once
+	for (int i = 0; i < size; ++i)
+	{
+		if (array[i].status == EMPTY)
+		{
+			start = start == -1 ? i : start;
+			continue;
+		}
+
+		int numProbes = 0;
+		table->policy->measure(array, size, array[i].key, &numProbes);
+		recordProbeLength(&stats->stored, numProbes);
+		stats->numOccupied++;
+	}
+
+	//a full table has no runs
+	if (start == -1)
+	{
+		return;
+	}
+
+	int run = 0;
+	for (int i = 1; i <= size; ++i)
+	{
+		int index = start + i < size ? start + i : start + i - size;
+		if (array[index].status == EMPTY)
+		{
+			if (run > 0)
+			{
+				recordProbeRun(stats, run);
+			}
+			run = 0;
+		}
+		else
+		{
+			run++;
+		}
+	}
+}
+
+//adds the probes of searching for the entries of a list to the probe telemetry
+//the searches are repeated with counting, after the timed searches
+//hashTable: pointer to the hash table
+//entries: the searched entries
+//count: the number of entries
+//stats: pointer to the telemetry
+void collectSearchProbes(HashTable* table, SearchEntry* entries, int count, ProbeStats* stats)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		int numProbes = 0;
+		int index = table->policy->measure(table->array, table->size, entries[i].key, &numProbes);
+
+		//the entry may not have been moved from the old array yet
+		if (index == -1 && table->oldArray != NULL)
+		{
+			int numOldProbes = 0;
+			index = table->policy->measure(table->oldArray, table->oldSize, entries[i].key, &numOldProbes);
+			numProbes += numOldProbes;
+		}
+
+		recordProbeLength(index != -1 ? &stats->hits : &stats->misses, numProbes);
+	}
+}
+
+//frees the dynamically allocated memory associated with the hash table
+//hashTable: pointer to the hash table 
+void deleteHash(HashTable* hashTable)
+{
+	free(hashTable->array);
+	free(hashTable->oldArray);
+	hashTable->array = NULL;
+	hashTable->oldArray = NULL;
+	hashTable->size = 0;
+	hashTable->oldSize = 0;
+	hashTable->numOccupied = 0;
+}
+
+//frees the dynamically allocated memory associated with the search list
+//searchList: pointer to the search list
+void deleteSearchList(SearchList* searchList)
+{
+	free(searchList->array);
+	searchList->array = NULL;
+	searchList->numFound = 0;
+	searchList->size = 0;
+}
+
+//reads elements from the given file and creates a search list from them
+//fileName: the path to the search file
+//stats: pointer to the structure where the statistics of the loading are saved, NULL if they are not needed
+//returns: a search list with the elements from the search file
+SearchList readSearchList(char* fileName, LoadStats* stats)
+{
+	//create empty search list
+	SearchList searchList;
+	searchList.array = NULL;
+	searchList.numFound = 0;
+	searchList.size = 0;
+
+	//try to open the search file, return empty search list if it fails
+	IntReader reader;
+	if (openIntReader(&reader, fileName) == -1)
+	{
+		printf("Error: cannot open file %s!\n", fileName);
+		return searchList;
+	}
+
+	//try to allocate memory for the search list and the values, return empty search list if it fails
+	searchList.array = (SearchEntry*)malloc(MAX_SEARCH_SIZE * sizeof(SearchEntry));
+	int* values = (int*)malloc(MAX_SEARCH_SIZE * sizeof(int));
+	if (searchList.array == NULL || values == NULL)
+	{
+		closeIntReader(&reader, NULL);
+		free(values);
+		deleteSearchList(&searchList);
+		printf("Error: couldn't allocate memory!\n");
+		return searchList;
+	}
+
+	//read entries from the search file until the end of file or until the maximum allowed number of values is read
+	int numRead = readInts(&reader, values, MAX_SEARCH_SIZE);
+	for (int i = 0; i < numRead; ++i)
+	{
+		searchList.array[i].key = values[i];
+		searchList.array[i].index = -1;
+	}
+	searchList.size = numRead > 0 ? numRead : 0;
+
+	closeIntReader(&reader, stats);
+	free(values);
+
+	//if nothing was read from the search file
+	if (searchList.size == 0)
+	{
+		deleteSearchList(&searchList); //free the memory of the search list
+		printf("Error: No retrieval data loaded from file %s!\n", fileName);
+	}
+
+	return searchList;
+}
+
+//frees the dynamically allocated memory associated with the input list
+//searchList: pointer to the input list
+void deleteInputList(InputList* inputList)
+{
+	//free the memory of the input list
+	free(inputList->array);
+	inputList->array = NULL;
+	inputList->size = 0;
+}
+
+//reads elements from the given file and creates an input list from them
+//the file is streamed through the loader in chunks, so only the input list itself has to fit into memory
+//fileName: the path to the input file
+//stats: pointer to the structure where the statistics of the loading are saved, NULL if they are not needed
+//returns: an input list with the elements from the input file
+InputList readInputList(char* fileName, LoadStats* stats)
+{
+	//create empty input list
+	InputList inputList;
+	inputList.array = NULL;
+	inputList.size = 0;
+
+	//try to open the input file, return empty input list if it fails
+	IntReader reader;
+	if (openIntReader(&reader, fileName) == -1)
+	{
+		printf("Error: cannot open file %s!\n", fileName);
+		return inputList;
+	}
+
+	//try to allocate memory for the input list, return empty input list if it fails
+	int capacity = INITIAL_INPUT_SIZE;
+	inputList.array = (InputEntry*)malloc(capacity * sizeof(InputEntry));
+	if (inputList.array == NULL)
+	{
+		closeIntReader(&reader, NULL);
+		printf("Error: couldn't allocate memory!\n");
+		return inputList;
+	}
+
+	//read entries from the input file until the end of file, a chunk of values at a time
+	int values[LOAD_CHUNK_SIZE];
+	int numRead;
+	while ((numRead = readInts(&reader, values, LOAD_CHUNK_SIZE)) > 0)
+	{
+		//the list can't take the chunk, double its capacity
+		while (inputList.size + numRead > capacity)
+		{
+			InputEntry* array = capacity <= 0x7fffffff / 2 ?
+				(InputEntry*)realloc(inputList.array, 2 * (size_t)capacity * sizeof(InputEntry)) : NULL;
+			if (array == NULL)
+			{
+				closeIntReader(&reader, NULL);
+				deleteInputList(&inputList); //free the memory of the input list
+				printf("Error: couldn't allocate memory!\n");
+				return inputList;
+			}
+			inputList.array = array;
+			capacity *= 2;
+		}
+
+		for (int i = 0; i < numRead; ++i)
+		{
+			inputList.array[inputList.size].key = values[i];
+			inputList.array[inputList.size].numCollisions = 0;
+			inputList.size++;
+		}
+	}
+
+	closeIntReader(&reader, stats);
+
+	//reading the file failed
+	if (numRead == -1)
+	{
+		deleteInputList(&inputList); //free the memory of the input list
+		printf("Error: cannot read file %s!\n", fileName);
+		return inputList;
+	}
+
+	//if nothing was read from the input file
+	if (inputList.size == 0)
+	{
+		deleteInputList(&inputList); //free the memory of the input list
+		printf("Error: No input data loaded from file %s!\n", fileName);
+	}
+
+	return inputList;
+}
+
+//the engines that can be used for storing the elements
+typedef enum Engine Engine;
+enum Engine { ENGINE_CLASSIC, ENGINE_SWISS, ENGINE_ROBINHOOD, ENGINE_CONCURRENT, ENGINE_PERFECT, ENGINE_CUCKOO };
+
+//optional command line settings, given after the three required arguments
+typedef struct Options Options;
+struct Options
+{
+	double maxLoad; //the maximum load factor of the hash table (--max-load)
+	int rehashStep; //the number of buckets moved per insert during a rehash (--rehash-step)
+	int recordCollisions; //whether the collisions are recorded into the collision log, 0 with --no-collisions
+	Engine engine; //the engine that stores the elements (--engine)
+	int batch; //whether the whole search list is searched with one batched call, 1 with --batch
+	HashFunction hashFunction; //the hash function of the classic engine (--hash)
+	ProbeSequence probeSequence; //the probe sequence of the classic engine (--probe)
+	char* deleteFile; //the file with the elements to delete after storing, NULL if nothing is deleted (--delete)
+	int numThreads; //the number of threads building the classic engine (--threads)
+	char* snapshotFile; //the snapshot of the hash table that is mapped if it exists and written otherwise, NULL without a snapshot (--snapshot)
+	int verifySnapshot; //whether the checksum of the whole table is verified when a snapshot is mapped, 1 with --verify-snapshot
+	int stream; //whether the search file is streamed in chunks and every result is printed as it is found, 1 with --stream
+	BenchOptions bench; //the settings of the benchmark of the storage and retrieval (--warmup, --trials, --report, --report-format)
+	int probeStats; //whether the probe telemetry of the classic engine is printed, 1 with --probe-stats
+	char* probeStatsFile; //the file the probe telemetry is written into as JSON, NULL if it isn't written (--probe-stats-json)
+	int filterBits; //the number of bits per element of the Bloom filter checked before searching, 0 without a filter (--filter)
+	char* serveAddress; //the socket path, or "-" for the standard input and output, the stored elements are served at instead of searching the search file, NULL without a server (--serve)
+};
+
+//the storage of the elements: the engine that is used and its structure
+typedef struct Storage Storage;
+struct Storage
+{
+	Engine engine; //the engine that stores the elements
+	HashTable hashTable; //the hash table with open addressing, quadratic probing by default, used by ENGINE_CLASSIC
+	SwissTable swissTable; //the swiss table, used by ENGINE_SWISS
+	RobinHoodTable robinHoodTable; //the robin hood table, used by ENGINE_ROBINHOOD
+	ConcurrentTable concurrentTable; //the lock-free table, used by ENGINE_CONCURRENT
+	PerfectHash perfectHash; //the minimal perfect hash table, used by ENGINE_PERFECT
+	CuckooTable cuckooTable; //the bucketized cuckoo table, used by ENGINE_CUCKOO
+	CollisionLog* log; //the collision log used by ENGINE_CLASSIC, NULL if the collisions are not recorded
+	int numThreads; //the number of threads building the hash table of ENGINE_CLASSIC
+	Snapshot snapshot; //the snapshot the hash table of ENGINE_CLASSIC was mapped from, its map is NULL if the table was built
+	int filterBits; //the number of bits per element of the Bloom filter, 0 without a filter
+	BloomFilter filter; //the Bloom filter of the stored elements checked before searching, its blocks are NULL without a filter
+	double filterTime; //the time in miliseconds that building the filter took the last time
+	long long filterMisses; //the number of searched elements that were not found, counted after the timed searches
+	long long filterFalsePositives; //the number of those elements the filter passed
+};
+
+//returns the name of an engine as it is given on the command line
+//engine: the engine
+//returns: the name of the engine
+const char* engineName(Engine engine)
+{
+	switch (engine)
+	{
+	case ENGINE_SWISS:
+		return "swiss";
+	case ENGINE_ROBINHOOD:
+		return "robinhood";
+	case ENGINE_CONCURRENT:
+		return "concurrent";
+	case ENGINE_PERFECT:
+		return "perfect";
+	case ENGINE_CUCKOO:
+		return "cuckoo";
+	default:
+		return "classic";
+	}
+}
+
+//initializes an empty storage
+//storage: pointer to the storage
+//options: the settings of the engine that is to store the elements
+//size: the initial size of the table
+//log: pointer to the collision log, NULL if the collisions shouldn't be recorded
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int initStorage(Storage* storage, Options* options, int size, CollisionLog* log)
+{
+	storage->engine = options->engine;
+	storage->log = log;
+	storage->numThreads = options->numThreads;
+	storage->snapshot.map = NULL;
+	storage->filterBits = options->filterBits;
+	initBloomFilter(&storage->filter);
+	storage->filterTime = 0.0;
+	storage->filterMisses = 0;
+	storage->filterFalsePositives = 0;
+
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		return initSwiss(&storage->swissTable, size, options->maxLoad);
+	case ENGINE_ROBINHOOD:
+		return initRobinHood(&storage->robinHoodTable, size, options->maxLoad, options->hashFunction);
+	case ENGINE_CONCURRENT:
+		return initConcurrent(&storage->concurrentTable, size, options->maxLoad);
+	case ENGINE_PERFECT:
+		//the table is sized by the number of distinct keys when it is built
+		initPerfect(&storage->perfectHash);
+		return 0;
+	case ENGINE_CUCKOO:
+		return initCuckoo(&storage->cuckooTable, size, options->maxLoad);
+	default:
+		return initHash(&storage->hashTable, size, options->maxLoad, options->rehashStep, options->hashFunction, options->probeSequence);
+	}
+}
+
+//inserts all the elements from the input list into the swiss table
+//swissTable: pointer to the swiss table, it is emptied first
+//inputList: the input list with entries to insert into the swiss table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createSwiss(SwissTable* swissTable, InputList inputList)
+{
+	if (resetSwiss(swissTable) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	for (int i = 0; i < inputList.size; ++i)
+	{
+		//the swiss table counts the collisions of all the entries together
+		inputList.array[i].numCollisions = 0;
+
+		if (insertSwiss(swissTable, inputList.array[i].key) == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+//inserts all the elements from the input list into the robin hood table
+//robinHoodTable: pointer to the robin hood table, it is emptied first
+//inputList: the input list with entries to insert into the robin hood table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createRobinHood(RobinHoodTable* robinHoodTable, InputList inputList)
+{
+	if (resetRobinHood(robinHoodTable) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	for (int i = 0; i < inputList.size; ++i)
+	{
+		//the robin hood table counts the displacements of all the entries together
+		inputList.array[i].numCollisions = 0;
+
+		if (insertRobinHood(robinHoodTable, inputList.array[i].key) == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+//inserts all the elements from the input list into the concurrent table
+//concurrentTable: pointer to the concurrent table, it is emptied and sized for the input list first
+//inputList: the input list with entries to insert into the concurrent table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createConcurrent(ConcurrentTable* concurrentTable, InputList inputList)
+{
+	if (resetConcurrent(concurrentTable, inputList.size) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	for (int i = 0; i < inputList.size; ++i)
+	{
+		inputList.array[i].numCollisions = 0;
+
+		if (insertConcurrent(concurrentTable, inputList.array[i].key) == -1)
+		{
+			printf("Error: the concurrent table is full!\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+//builds the minimal perfect hash table over all the elements from the input list
+//perfectHash: pointer to the minimal perfect hash table, it is rebuilt
+//inputList: the input list with entries to store in the minimal perfect hash table
+//returns: 0 on success, -1 if it was not possible to allocate the memory or to build the table
+int createPerfect(PerfectHash* perfectHash, InputList inputList)
+{
+	int* keys = (int*)malloc((size_t)inputList.size * sizeof(int));
+	if (keys == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	//no key ever collides in a perfect hash table
+	for (int i = 0; i < inputList.size; ++i)
+	{
+		keys[i] = inputList.array[i].key;
+		inputList.array[i].numCollisions = 0;
+	}
+
+	int result = buildPerfect(perfectHash, keys, inputList.size);
+	free(keys);
+	if (result == -1)
+	{
+		printf("Error: couldn't build the minimal perfect hash table!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+//inserts all the elements from the input list into the cuckoo table
+//cuckooTable: pointer to the cuckoo table, it is emptied first
+//inputList: the input list with entries to insert into the cuckoo table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createCuckoo(CuckooTable* cuckooTable, InputList inputList)
+{
+	if (resetCuckoo(cuckooTable) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	for (int i = 0; i < inputList.size; ++i)
+	{
+		//the cuckoo table counts the kicks of all the entries together
+		inputList.array[i].numCollisions = 0;
+
+		if (insertCuckoo(cuckooTable, inputList.array[i].key) == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+//inserts all the elements from the input list into the storage
+//storage: pointer to the storage, it is emptied first
+//inputList: the input list with entries to insert
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createStorage(Storage* storage, InputList inputList)
+{
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		return createSwiss(&storage->swissTable, inputList);
+	case ENGINE_ROBINHOOD:
+		return createRobinHood(&storage->robinHoodTable, inputList);
+	case ENGINE_CONCURRENT:
+		return createConcurrent(&storage->concurrentTable, inputList);
+	case ENGINE_PERFECT:
+		return createPerfect(&storage->perfectHash, inputList);
+	case ENGINE_CUCKOO:
+		return createCuckoo(&storage->cuckooTable, inputList);
+	default:
+		if (storage->numThreads > 1)
+		{
+			return createHashParallel(&storage->hashTable, inputList, storage->log, storage->numThreads);
+		}
+		return createHash(&storage->hashTable, inputList, storage->log);
+	}
+}
+
+//builds the Bloom filter of the stored elements, it is part of the storage phase
+//storage: pointer to the storage with the stored elements and the number of bits per element of the filter
+//inputList: the input list with the stored entries, the entries of a hash table mapped from a snapshot are taken from the table instead
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int createStorageFilter(Storage* storage, InputList inputList)
+{
+	double start = benchNow();
+
+	HashTable* table = &storage->hashTable;
+	int count = storage->snapshot.map != NULL ? table->numOccupied : inputList.size;
+	if (createBloomFilter(&storage->filter, count, storage->filterBits) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	if (storage->snapshot.map != NULL)
+	{
+		for (int i = 0; i < table->size; ++i)
+		{
+			if (table->array[i].status == OCCUPIED)
+			{
+				bloomAdd(&storage->filter, table->array[i].key);
+			}
+		}
+	}
+	else
+	{
+		for (int i = 0; i < inputList.size; ++i)
+		{
+			bloomAdd(&storage->filter, inputList.array[i].key);
+		}
+	}
+
+	storage->filterTime = (benchNow() - start) / 1e6;
+
+	return 0;
+}
+
+//counts the searched entries that were not found and how many of them the Bloom filter passed, for its false positive rate
+//the filter is checked again after the timed searches, so the searches don't count anything
+//storage: pointer to the storage with the filter, its counts are increased
+//entries: the searched entries with the indices where they were found
+//count: the number of entries
+void countFilterMisses(Storage* storage, SearchEntry* entries, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		if (entries[i].index == -1)
+		{
+			storage->filterMisses++;
+			storage->filterFalsePositives += bloomMayContain(&storage->filter, entries[i].key);
+		}
+	}
+}
+
+//searches for the given entry in the structure of the engine of the storage, without checking the filter
+//storage: pointer to the storage
+//entry: pointer to the entry to search for, the index in the entry gets set to the index where the entry was found, -1 if it was not found
+//returns: the index where the entry was found, -1 if it was not found
+int searchEngine(Storage* storage, SearchEntry* entry)
+{
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		entry->index = searchSwiss(&storage->swissTable, entry->key);
+		return entry->index;
+	case ENGINE_ROBINHOOD:
+		entry->index = searchRobinHood(&storage->robinHoodTable, entry->key);
+		return entry->index;
+	case ENGINE_CONCURRENT:
+		entry->index = searchConcurrent(&storage->concurrentTable, entry->key);
+		return entry->index;
+	case ENGINE_PERFECT:
+		entry->index = searchPerfect(&storage->perfectHash, entry->key);
+		return entry->index;
+	case ENGINE_CUCKOO:
+		entry->index = searchCuckoo(&storage->cuckooTable, entry->key);
+		return entry->index;
+	default:
+		return searchHash(&storage->hashTable, entry);
+	}
+}
+
+//searches for the given entry in the storage
+//with a Bloom filter, most elements that were not stored are rejected by the filter with one cache line before the structure is searched
+//storage: pointer to the storage
+//entry: pointer to the entry to search for, the index in the entry gets set to the index where the entry was found, -1 if it was not found
+//returns: the index where the entry was found, -1 if it was not found
+int searchStorage(Storage* storage, SearchEntry* entry)
+{
+	if (storage->filter.blocks != NULL && !bloomMayContain(&storage->filter, entry->key))
+	{
+		entry->index = -1;
+		return -1;
+	}
+
+	return searchEngine(storage, entry);
+}
+
+//deletes a key from the storage, only the robin hood engine supports deletion
+//storage: pointer to the storage
+//key: the key to delete
+//returns: the index where the key was stored, -1 if it was not found
+int deleteKey(Storage* storage, int key)
+{
+	switch (storage->engine)
+	{
+	case ENGINE_ROBINHOOD:
+		return deleteRobinHoodKey(&storage->robinHoodTable, key);
+	default:
+		return -1;
+	}
+}
+
+//searches for many entries in the swiss table at once
+//the hashes of BATCH_LANES entries are computed and their first groups prefetched before any of them is searched
+//swissTable: pointer to the swiss table
+//entries: the entries to search for, the index in each entry is set to the slot where it was found, -1 if it was not found
+//count: the number of entries
+//returns: the number of entries that were found
+int searchSwissBatch(SwissTable* swissTable, SearchEntry* entries, int count)
+{
+	int numFound = 0;
+	unsigned int hashes[BATCH_LANES];
+
+	for (int start = 0; start < count; start += BATCH_LANES)
+	{
+		int batchSize = count - start < BATCH_LANES ? count - start : BATCH_LANES;
+
+		for (int i = 0; i < batchSize; ++i)
+		{
+			hashes[i] = swissHash(entries[start + i].key);
+			prefetchSwiss(swissTable, hashes[i]);
+		}
+
+		for (int i = 0; i < batchSize; ++i)
+		{
+			entries[start + i].index = searchSwissHashed(swissTable, entries[start + i].key, hashes[i]);
+			if (entries[start + i].index != -1)
+			{
+				numFound++;
+			}
+		}
+	}
+
+	return numFound;
+}
+
+//searches for all the entries of the search list in the structure of the engine of the storage at once, without checking the filter
+//storage: pointer to the storage
+//searchList: pointer to the search list, the indices of its entries and the number of found entries are set
+void searchEngineBatch(Storage* storage, SearchList* searchList)
+{
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		searchList->numFound = searchSwissBatch(&storage->swissTable, searchList->array, searchList->size);
+		break;
+	case ENGINE_ROBINHOOD:
+	case ENGINE_CONCURRENT:
+	case ENGINE_PERFECT:
+	case ENGINE_CUCKOO:
+		//a robin hood or concurrent lookup usually ends within the cache line of its home index,
+		//a perfect hash lookup reads one pilot and one slot and a cuckoo lookup prefetches its two buckets together,
+		//search the entries one by one
+		searchList->numFound = 0;
+		for (int i = 0; i < searchList->size; ++i)
+		{
+			if (searchEngine(storage, &searchList->array[i]) != -1)
+			{
+				searchList->numFound++;
+			}
+		}
+		break;
+	default:
+		searchList->numFound = searchHashBatch(&storage->hashTable, searchList->array, searchList->size);
+		break;
+	}
+}
+
+//searches for all the entries of the search list in the storage at once
+//with a Bloom filter, the filter is checked for all the entries first and only the entries it passes are searched at once,
+//they are copied into a list of their own for that
+//storage: pointer to the storage
+//searchList: pointer to the search list, the indices of its entries and the number of found entries are set
+void searchStorageBatch(Storage* storage, SearchList* searchList)
+{
+	if (storage->filter.blocks == NULL)
+	{
+		searchEngineBatch(storage, searchList);
+		return;
+	}
+
+	SearchList passed = { NULL, 0, 0 };
+	passed.array = (SearchEntry*)malloc((size_t)searchList->size * sizeof(SearchEntry));
+	if (passed.array == NULL)
+	{
+		//search the entries one by one instead
+		searchList->numFound = 0;
+		for (int i = 0; i < searchList->size; ++i)
+		{
+			if (searchStorage(storage, &searchList->array[i]) != -1)
+			{
+				searchList->numFound++;
+			}
+		}
+		return;
+	}
+
+	//the rejected entries are not found, the passed ones are marked with -2 until their result is copied back
+	for (int i = 0; i < searchList->size; ++i)
+	{
+		SearchEntry* entry = &searchList->array[i];
+		entry->index = -1;
+		if (bloomMayContain(&storage->filter, entry->key))
+		{
+			entry->index = -2;
+			passed.array[passed.size++].key = entry->key;
+		}
+	}
+
+	searchEngineBatch(storage, &passed);
+
+	int next = 0;
+	for (int i = 0; i < searchList->size; ++i)
+	{
+		if (searchList->array[i].index == -2)
+		{
+			searchList->array[i].index = passed.array[next++].index;
+		}
+	}
+	searchList->numFound = passed.numFound;
+
+	deleteSearchList(&passed);
+}
+
+//returns the number of elements stored in the storage
+//storage: pointer to the storage
+//returns: the number of occupied entries
+int storageOccupied(Storage* storage)
+{
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		return storage->swissTable.numOccupied;
+	case ENGINE_ROBINHOOD:
+		return storage->robinHoodTable.numOccupied;
+	case ENGINE_CONCURRENT:
+		return concurrentOccupied(&storage->concurrentTable);
+	case ENGINE_PERFECT:
+		return storage->perfectHash.size;
+	case ENGINE_CUCKOO:
+		return storage->cuckooTable.numOccupied;
+	default:
+		return storage->hashTable.numOccupied;
+	}
+}
+
+//returns the number of entries of the storage
+//storage: pointer to the storage
+//returns: the size of the table
+int storageSize(Storage* storage)
+{
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		return storage->swissTable.size;
+	case ENGINE_ROBINHOOD:
+		return storage->robinHoodTable.size;
+	case ENGINE_CONCURRENT:
+		return storage->concurrentTable.size;
+	case ENGINE_PERFECT:
+		return storage->perfectHash.size;
+	case ENGINE_CUCKOO:
+		return cuckooSlots(&storage->cuckooTable);
+	default:
+		return storage->hashTable.size;
+	}
+}
+
+//frees the dynamically allocated memory associated with the storage
+//storage: pointer to the storage
+void deleteStorage(Storage* storage)
+{
+	deleteBloomFilter(&storage->filter);
+
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		deleteSwiss(&storage->swissTable);
+		break;
+	case ENGINE_ROBINHOOD:
+		deleteRobinHood(&storage->robinHoodTable);
+		break;
+	case ENGINE_CONCURRENT:
+		deleteConcurrent(&storage->concurrentTable);
+		break;
+	case ENGINE_PERFECT:
+		deletePerfect(&storage->perfectHash);
+		break;
+	case ENGINE_CUCKOO:
+		deleteCuckoo(&storage->cuckooTable);
+		break;
+	default:
+		//the array of a mapped table belongs to the snapshot
+		if (storage->snapshot.map != NULL)
+		{
+			closeSnapshot(&storage->snapshot);
+			storage->hashTable.array = NULL;
+		}
+		deleteHash(&storage->hashTable);
+		break;
+	}
+}
+
+//fills the configuration values of a snapshot of the hash table, a snapshot is only used with the configuration and the input it was built with
+//options: the settings of the hash table
+//size: the initial size of the hash table
+//inputFile: the path to the input file, its size and modification time identify the stored data
+//config: array of SNAPSHOT_NUM_VALUES values where the configuration is saved
+//returns: 0 on success, -1 if the input file doesn't exist
+int hashSnapshotConfig(Options* options, int size, char* inputFile, unsigned long long* config)
+{
+	memset(config, 0, SNAPSHOT_NUM_VALUES * sizeof(unsigned long long));
+	config[0] = (unsigned long long)options->hashFunction;
+	config[1] = (unsigned long long)options->probeSequence;
+	config[2] = (unsigned long long)size;
+	memcpy(&config[3], &options->maxLoad, sizeof(double));
+	config[4] = sizeof(HashEntry);
+
+	return snapshotInputIdentity(inputFile, &config[5]);
+}
+
+//writes a snapshot of the built hash table
+//storage: pointer to the storage with the built hash table of ENGINE_CLASSIC
+//options: the settings of the hash table
+//size: the initial size of the hash table
+//inputList: the list of entries that were stored, with the numbers of their collisions
+//inputFile: the path to the input file the entries were read from
+//fileName: the path to the snapshot file
+//returns: 0 on success, -1 if the snapshot could not be written
+int saveHashSnapshot(Storage* storage, Options* options, int size, InputList inputList, char* inputFile, char* fileName)
+{
+	HashTable* hashTable = &storage->hashTable;
+
+	long long numCollisions = 0;
+	for (int i = 0; i < inputList.size; ++i)
+	{
+		numCollisions += inputList.array[i].numCollisions;
+	}
+
+	unsigned long long config[SNAPSHOT_NUM_VALUES];
+	if (hashSnapshotConfig(options, size, inputFile, config) == -1)
+	{
+		return -1;
+	}
+
+	unsigned long long metadata[SNAPSHOT_NUM_VALUES] = { 0 };
+	metadata[0] = (unsigned long long)hashTable->size;
+	metadata[1] = (unsigned long long)hashTable->numOccupied;
+	metadata[2] = (unsigned long long)hashTable->numGrowths;
+	metadata[3] = (unsigned long long)numCollisions;
+
+	if (writeSnapshot(fileName, SNAPSHOT_HASH_TABLE, config, metadata, hashTable->array, (size_t)hashTable->size * sizeof(HashEntry)) == -1)
+	{
+		printf("Error: cannot write snapshot %s!\n", fileName);
+		return -1;
+	}
+
+	return 0;
+}
+
+//maps a snapshot of the hash table instead of building the table, the array of entries is used directly from the mapped file
+//searching never writes to the array, so the table can stay read-only
+//storage: pointer to the initialized storage of ENGINE_CLASSIC
+//options: the settings of the hash table, they must be the ones the snapshot was built with
+//size: the initial size of the hash table
+//inputFile: the path to the input file, it must be unchanged since the snapshot was built, but it isn't read
+//fileName: the path to the snapshot file
+//returns: 0 on success, -1 if the snapshot could not be mapped or doesn't match
+int loadHashSnapshot(Storage* storage, Options* options, int size, char* inputFile, char* fileName)
+{
+	unsigned long long config[SNAPSHOT_NUM_VALUES];
+	if (hashSnapshotConfig(options, size, inputFile, config) == -1)
+	{
+		return -1;
+	}
+
+	if (openSnapshot(&storage->snapshot, fileName, SNAPSHOT_HASH_TABLE, config, options->verifySnapshot) == -1)
+	{
+		return -1;
+	}
+
+	const SnapshotHeader* header = storage->snapshot.header;
+	if (header->metadata[0] == 0 || header->metadata[0] > 0x7fffffff || header->metadata[0] * sizeof(HashEntry) != header->payloadSize)
+	{
+		closeSnapshot(&storage->snapshot);
+		printf("Error: snapshot %s has an invalid size!\n", fileName);
+		return -1;
+	}
+
+	HashTable* hashTable = &storage->hashTable;
+	free(hashTable->array);
+	hashTable->array = (HashEntry*)storage->snapshot.payload;
+	hashTable->size = (int)header->metadata[0];
+	hashTable->numOccupied = (int)header->metadata[1];
+	hashTable->numGrowths = (int)header->metadata[2];
+	selectPolicy(hashTable);
+
+	return 0;
+}
+
+//prints the storage details of the hash table with quadratic probing
+//hashTable: pointer to the hash table
+//inputList: the list of entries for storage
+//log: the collisions that occurred when storing the entries, NULL if they were not recorded
+void printHashDetails(HashTable* hashTable, InputList inputList, CollisionLog* log)
+{
+	printf("  Hash table size: %d\n", hashTable->size);
+	if (hashTable->numGrowths > 0)
+	{
+		printf("  Hash table grew %d times from the initial size %d\n", hashTable->numGrowths, hashTable->initialSize);
+	}
+	if (hashTable->numBuildThreads > 1)
+	{
+		printf("  Hash table built by %d threads, %d items left the region of their thread and were inserted afterwards\n",
+			hashTable->numBuildThreads, hashTable->numDeferred);
+	}
+
+	if (log != NULL)
+	{
+		for (long long i = 0; i < log->size; ++i)
+		{
+			printf("  Collision occurred saving item with value %d at hash table location %d\n", log->array[i].key, log->array[i].index);
+		}
+	}
+	else
+	{
+		//only the number of collisions of each entry is known
+		long long numCollisions = 0;
+		for (int i = 0; i < inputList.size; ++i)
+		{
+			numCollisions += inputList.array[i].numCollisions;
+		}
+
+		printf("  %lld collisions occurred (recording of collisions is disabled)\n", numCollisions);
+	}
+}
+
+//prints the storage details of the swiss table
+//swissTable: pointer to the swiss table
+void printSwissDetails(SwissTable* swissTable)
+{
+	printf("  Hash table size: %d\n", swissTable->size);
+	if (swissTable->numGrowths > 0)
+	{
+		printf("  Hash table grew %d times from the initial size %d\n", swissTable->numGrowths, swissTable->initialSize);
+	}
+	printf("  Swiss table layout with %d control bytes per group\n", SWISS_GROUP_SIZE);
+	printf("  %lld full groups were probed past when saving items\n", swissTable->numGroupCollisions);
+}
+
+//prints the storage details of the robin hood table
+//robinHoodTable: pointer to the robin hood table
+void printRobinHoodDetails(RobinHoodTable* robinHoodTable)
+{
+	double meanDistance;
+	int maxDistance;
+	robinHoodDistances(robinHoodTable, &meanDistance, &maxDistance);
+
+	printf("  Hash table size: %d\n", robinHoodTable->size);
+	if (robinHoodTable->numGrowths > 0)
+	{
+		printf("  Hash table grew %d times from the initial size %d\n", robinHoodTable->numGrowths, robinHoodTable->initialSize);
+	}
+	printf("  Robin hood hashing with linear probing and %s hash function\n", hashFunctionName(robinHoodTable->hashFunction));
+	printf("  %lld items were displaced by items further from their home location when saving items\n", robinHoodTable->numDisplacements);
+	printf("  Mean probe distance: %.2f, maximum probe distance: %d\n", meanDistance, maxDistance);
+	if (robinHoodTable->numDeleted > 0)
+	{
+		printf("  %d items deleted with backward shift\n", robinHoodTable->numDeleted);
+	}
+	if (robinHoodTable->numDuplicates > 0)
+	{
+		printf("  %d repeated items were stored once\n", robinHoodTable->numDuplicates);
+	}
+}
+
+//prints the storage details of the concurrent table
+//concurrentTable: pointer to the concurrent table
+void printConcurrentDetails(ConcurrentTable* concurrentTable)
+{
+	printf("  Hash table size: %d\n", concurrentTable->size);
+	if (concurrentTable->size != concurrentTable->initialSize)
+	{
+		printf("  Hash table was sized up from the initial size %d to fit the items\n", concurrentTable->initialSize);
+	}
+	printf("  Lock-free hashing with linear probing and murmur hash function, empty slots are claimed with compare-and-swap\n");
+	printf("  %lld inserts lost an empty slot to another thread\n", (long long)atomic_load(&concurrentTable->numClaimConflicts));
+}
+
+//prints the storage details of the minimal perfect hash table
+//perfectHash: pointer to the minimal perfect hash table
+//storeResult: pointer to the measured time of building the table
+void printPerfectDetails(PerfectHash* perfectHash, BenchResult* storeResult)
+{
+	long long pilotBytes;
+	long long keyBytes;
+	perfectMemory(perfectHash, &pilotBytes, &keyBytes);
+	double numKeys = perfectHash->size > 0 ? (double)perfectHash->size : 1.0;
+
+	printf("  Hash table size: %d (one slot per distinct item)\n", perfectHash->size);
+	printf("  Minimal perfect hash with %d buckets, %d of them dense, found with seed number %d\n", perfectHash->numBuckets,
+		perfectHash->numDenseBuckets, perfectHash->numSeeds);
+	if (perfectHash->numDuplicates > 0)
+	{
+		printf("  %d repeated items were stored once\n", perfectHash->numDuplicates);
+	}
+	printf("  Built in %f ms, %.2f pilots tried per bucket, the largest pilot is %u\n", storeResult->median / 1e6,
+		perfectHash->numBuckets > 0 ? (double)perfectHash->numPilotTries / perfectHash->numBuckets : 0.0, perfectHash->maxPilot);
+	printf("  %.2f bits per item for the hash function, %.2f bits per item with the verification array of items\n", pilotBytes * 8.0 / numKeys,
+		(pilotBytes + keyBytes) * 8.0 / numKeys);
+}
+
+//prints the storage details of the cuckoo table
+//cuckooTable: pointer to the cuckoo table
+void printCuckooDetails(CuckooTable* cuckooTable)
+{
+	int numSlots = cuckooSlots(cuckooTable);
+	int numInBuckets = cuckooTable->numOccupied - cuckooTable->numStashed;
+
+	printf("  Hash table size: %d (%d buckets of %d slots)\n", numSlots, cuckooTable->numBuckets, CUCKOO_BUCKET_SLOTS);
+	if (cuckooTable->numGrowths > 0)
+	{
+		printf("  Hash table grew %d times from the initial size %d\n", cuckooTable->numGrowths, cuckooTable->initialBuckets * CUCKOO_BUCKET_SLOTS);
+	}
+	printf("  Bucketized cuckoo hashing with 2 hash functions, a lookup reads at most 2 cache lines\n");
+	printf("  Achieved load factor: %.3f (%d items in the buckets, %d in the stash of %d)\n", numSlots > 0 ? (double)numInBuckets / numSlots : 0.0,
+		numInBuckets, cuckooTable->numStashed, CUCKOO_STASH_SIZE);
+	printf("  %lld kicks when saving items, %.3f per item, the longest chain was %d kicks (%lld buckets searched breadth-first)\n",
+		cuckooTable->numKicks, cuckooTable->numOccupied > 0 ? (double)cuckooTable->numKicks / cuckooTable->numOccupied : 0.0,
+		cuckooTable->maxPath, cuckooTable->numVisited);
+	if (cuckooTable->numStashInserts > 0)
+	{
+		printf("  %d items found no chain of at most %d kicks and went into the stash\n", cuckooTable->numStashInserts, CUCKOO_MAX_PATH);
+	}
+	if (cuckooTable->numDuplicates > 0)
+	{
+		printf("  %d repeated items were stored once\n", cuckooTable->numDuplicates);
+	}
+}
+
+//prints the storage details of a hash table mapped from a snapshot
+//hashTable: pointer to the hash table
+//snapshot: pointer to the snapshot the table was mapped from
+void printHashSnapshotDetails(HashTable* hashTable, Snapshot* snapshot)
+{
+	printf("  Hash table size: %d\n", hashTable->size);
+	if (hashTable->numGrowths > 0)
+	{
+		printf("  Hash table grew %d times from the initial size %d\n", hashTable->numGrowths, hashTable->initialSize);
+	}
+	printf("  Hash table mapped from a snapshot, %lld collisions occurred when it was built\n", (long long)snapshot->header->metadata[3]);
+}
+
+//prints the title, the sources of the data, the storage method and the number of stored items
+//inputFile: the path to the input file
+//searchFile: the path to the search file, NULL if the retrieval data is received by the server
+//deleteFile: the path to the deletion file, NULL if nothing was deleted
+//storage: pointer to the storage with the stored elements
+void printStatsHeader(char* inputFile, char* searchFile, char* deleteFile, Storage* storage)
+{
+	printf("Data storage and retrieval:\n");
+	printf("a comparison of hashing and directed search of sorted data\n");
+	printf("================================\n\n");
+
+	if (storage->engine == ENGINE_CLASSIC && storage->snapshot.map != NULL)
+	{
+		printf("Input data loaded from snapshot\n");
+	}
+	else
+	{
+		printf("Input data loaded from file %s\n", inputFile);
+	}
+	if (searchFile != NULL)
+	{
+		printf("Retrieval data loaded from file %s\n", searchFile);
+	}
+	if (deleteFile != NULL)
+	{
+		printf("Deletion data loaded from file %s\n", deleteFile);
+	}
+	if (storage->engine != ENGINE_CLASSIC)
+	{
+		printf("Storage Method: Hashing (%s engine)\n", engineName(storage->engine));
+	}
+	else if (storage->hashTable.hashFunction != HASH_MODULO || storage->hashTable.probeSequence != PROBE_QUADRATIC)
+	{
+		printf("Storage Method: Hashing (%s hash function, %s probing)\n",
+			hashFunctionName(storage->hashTable.hashFunction), probeSequenceName(storage->hashTable.probeSequence));
+	}
+	else
+	{
+		printf("Storage Method: Hashing\n");
+	}
+	printf("Number of items stored in the hash table: %d\n", storageOccupied(storage));
+}
+
+//prints the details of the structure of the storage
+//storage: pointer to the storage with the stored elements
+//inputList: the list of entries for storage
+//storeResult: pointer to the measured time of storing all the elements
+void printStorageDetails(Storage* storage, InputList inputList, BenchResult* storeResult)
+{
+	printf("Storage details:\n\n");
+
+	switch (storage->engine)
+	{
+	case ENGINE_SWISS:
+		printSwissDetails(&storage->swissTable);
+		break;
+	case ENGINE_ROBINHOOD:
+		printRobinHoodDetails(&storage->robinHoodTable);
+		break;
+	case ENGINE_CONCURRENT:
+		printConcurrentDetails(&storage->concurrentTable);
+		break;
+	case ENGINE_PERFECT:
+		printPerfectDetails(&storage->perfectHash, storeResult);
+		break;
+	case ENGINE_CUCKOO:
+		printCuckooDetails(&storage->cuckooTable);
+		break;
+	default:
+		if (storage->snapshot.map != NULL)
+		{
+			printHashSnapshotDetails(&storage->hashTable, &storage->snapshot);
+		}
+		else
+		{
+			printHashDetails(&storage->hashTable, inputList, storage->log);
+		}
+		break;
+	}
+}
+
+//prints the result of one search
+//entry: pointer to the searched entry
+void printRetrieval(SearchEntry* entry)
+{
+	if (entry->index != -1)
+	{
+		printf("  Value %d found in the hash table at position %d\n", entry->key, entry->index);
+	}
+	else
+	{
+		printf("  Value %d not found in the hash table\n", entry->key);
+	}
+}
+
+//prints the execution times and the fill of the hash table
+//storage: pointer to the storage with the stored elements
+//inputLoad: pointer to the statistics of loading the input file
+//searchLoad: pointer to the statistics of loading the search file
+//storeResult: pointer to the measured time of storing all the elements
+//searchResult: pointer to the measured time of one search
+void printExecutionTimes(Storage* storage, LoadStats* inputLoad, LoadStats* searchLoad, BenchResult* storeResult, BenchResult* searchResult)
+{
+	printf("\nExecution times:\n\n");
+
+	if (storage->engine == ENGINE_CLASSIC && storage->snapshot.map != NULL)
+	{
+		printLoadStats("retrieval data", searchLoad);
+		printBenchResult("store data", storeResult, "snapshot mapped and checked");
+	}
+	else
+	{
+		printLoadStats("input data", inputLoad);
+		printLoadStats("retrieval data", searchLoad);
+		printBenchResult("store data", storeResult, NULL);
+	}
+	printBenchResult("retrieve data", searchResult, NULL);
+	printf("\n");
+
+	const BenchResult* results[] = { storeResult, searchResult };
+	printBenchCounters(results, 2);
+
+	printf("Hash table is %3.0f%% full.\n\n", (storageOccupied(storage) * 100.0) / storageSize(storage));
+
+	printf("================================\n\n");
+}
+
+//prints the statistics
+//inputFile: the path to the input file
+//searchFile: the path to the search file
+//deleteFile: the path to the deletion file, NULL if nothing was deleted
+//storage: pointer to the storage with the stored elements
+//searchList: the list of entries for searching
+//inputList: the list of entries for storage
+//inputLoad: pointer to the statistics of loading the input file
+//searchLoad: pointer to the statistics of loading the search file
+//storeResult: pointer to the measured time of storing all the elements
+//searchResult: pointer to the measured time of one search
+//probeStats: pointer to the probe telemetry, NULL if it isn't printed
+void printStats(char* inputFile, char* searchFile, char* deleteFile, Storage* storage, SearchList searchList, InputList inputList,
+	LoadStats* inputLoad, LoadStats* searchLoad, BenchResult* storeResult, BenchResult* searchResult, ProbeStats* probeStats)
+{
+	printStatsHeader(inputFile, searchFile, deleteFile, storage);
+	printf("Number of items searched: %d\n", searchList.size);
+	printf("Number of items found: %d\n\n", searchList.numFound);
+
+	printStorageDetails(storage, inputList, storeResult);
+
+	printf("\nRetrieval details:\n\n");
+	for (int i = 0; i < searchList.size; ++i)
+	{
+		printRetrieval(&searchList.array[i]);
+	}
+
+	if (storage->filter.blocks != NULL)
+	{
+		printBloomFilter(&storage->filter, storage->filterTime, storage->filterMisses, storage->filterFalsePositives);
+	}
+	if (probeStats != NULL)
+	{
+		printProbeStats(probeStats);
+	}
+
+	printExecutionTimes(storage, inputLoad, searchLoad, storeResult, searchResult);
+}
+
+//the data of the measured storage phase
+typedef struct StoreBench StoreBench;
+struct StoreBench
+{
+	Storage* storage; //pointer to the storage the elements are stored in
+	InputList inputList; //the list of entries for storage
+};
+
+//stores all the elements of the input list and builds the Bloom filter, the operation measured as the storage phase
+//context: pointer to the StoreBench
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int benchStore(void* context)
+{
+	StoreBench* bench = (StoreBench*)context;
+
+	if (createStorage(bench->storage, bench->inputList) == -1)
+	{
+		return -1;
+	}
+	if (bench->storage->filterBits > 0)
+	{
+		return createStorageFilter(bench->storage, bench->inputList);
+	}
+
+	return 0;
+}
+
+//the data of the measured retrieval phase
+typedef struct SearchBench SearchBench;
+struct SearchBench
+{
+	Storage* storage; //pointer to the storage with the stored elements
+	SearchList* searchList; //pointer to the list of entries for searching, the results are saved in it
+	int batch; //whether the list is searched with one batched call
+};
+
+//searches for all the elements of the search list, the operation measured as the retrieval phase
+//context: pointer to the SearchBench
+//returns: 0
+int benchSearch(void* context)
+{
+	SearchBench* bench = (SearchBench*)context;
+	SearchList* searchList = bench->searchList;
+
+	if (bench->batch)
+	{
+		searchStorageBatch(bench->storage, searchList);
+		return 0;
+	}
+
+	searchList->numFound = 0;
+	for (int i = 0; i < searchList->size; ++i)
+	{
+		if (searchStorage(bench->storage, &searchList->array[i]) != -1)
+		{
+			searchList->numFound++;
+		}
+	}
+
+	return 0;
+}
+
+//appends the measured times of the storage and retrieval to the report file
+//options: pointer to the settings with the report file, and whether the elements were searched with batched calls
+//storage: pointer to the storage with the stored elements
+//inputFile: the path to the input file
+//searchSize: the number of searched elements
+//results: array of the results of the storage and the retrieval
+//returns: 0 on success, -1 if the report could not be written
+int writeHashReport(Options* options, Storage* storage, char* inputFile, long long searchSize, BenchResult* results)
+{
+	char method[64];
+	char filter[24] = "";
+	if (options->filterBits > 0)
+	{
+		snprintf(filter, sizeof(filter), "-bloom%d", options->filterBits);
+	}
+	if (storage->engine == ENGINE_CLASSIC)
+	{
+		snprintf(method, sizeof(method), "classic-%s-%s%s%s", hashFunctionName(storage->hashTable.hashFunction),
+			probeSequenceName(storage->hashTable.probeSequence), options->batch ? "-batch" : "", filter);
+	}
+	else
+	{
+		snprintf(method, sizeof(method), "%s%s%s", engineName(storage->engine), options->batch ? "-batch" : "", filter);
+	}
+
+	BenchRun run = { "hash", method, inputFile, storageOccupied(storage), storageSize(storage), searchSize };
+
+	return writeBenchReport(&options->bench, &run, results, 2);
+}
+
+//searches for the elements of the search file while the file is being read and prints every result as it is found
+//the file is read in chunks by a second thread, so reading the next chunk overlaps with searching the current one,
+//and the memory used doesn't depend on the number of elements in the file
+//storage: pointer to the storage with the stored elements
+//searchFile: the path to the search file, "-" reads the standard input
+//batch: whether every chunk is searched with one batched call
+//numSearched: the number of searched elements is saved here
+//numFound: the number of found elements is saved here
+//searchLoad: pointer to the structure where the statistics of the loading are saved, the time covers the whole streaming
+//perfCounters: whether the hardware counters run while searching
+//searchResult: pointer to where the time of one search, averaged over all of them, and the counts of the hardware events per search are saved
+//probeStats: pointer to the probe telemetry of the classic engine the probes of every chunk are added to, NULL if it isn't collected
+//returns: 0 on success, -1 if the file could not be read
+int streamSearch(Storage* storage, char* searchFile, int batch, long long* numSearched, long long* numFound, LoadStats* searchLoad, int perfCounters,
+	BenchResult* searchResult, ProbeStats* probeStats)
+{
+	*numSearched = 0;
+	*numFound = 0;
+
+	SearchList chunkList;
+	chunkList.array = (SearchEntry*)malloc(PIPELINE_CHUNK_SIZE * sizeof(SearchEntry));
+	chunkList.size = 0;
+	chunkList.numFound = 0;
+	if (chunkList.array == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	ChunkPipeline pipeline;
+	if (openChunkPipeline(&pipeline, searchFile) == -1)
+	{
+		printf("Error: cannot open file %s!\n", searchFile);
+		deleteSearchList(&chunkList);
+		return -1;
+	}
+
+	//only the lookups are timed, the chunks are read in the meantime
+	SearchBench bench = { storage, &chunkList, batch };
+	double totalTime = 0.0;
+	PerfCounters counters;
+	if (perfCounters)
+	{
+		openPerfCounters(&counters);
+	}
+	int* values;
+	int count;
+	while ((count = nextChunk(&pipeline, &values)) > 0)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			chunkList.array[i].key = values[i];
+			chunkList.array[i].index = -1;
+		}
+		chunkList.size = count;
+
+		if (perfCounters)
+		{
+			startPerfCounters(&counters);
+		}
+		double start = benchNow();
+		benchSearch(&bench);
+		totalTime += benchNow() - start;
+		if (perfCounters)
+		{
+			stopPerfCounters(&counters);
+		}
+		if (probeStats != NULL)
+		{
+			collectSearchProbes(&storage->hashTable, chunkList.array, count, probeStats);
+		}
+		if (storage->filter.blocks != NULL)
+		{
+			countFilterMisses(storage, chunkList.array, count);
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			printRetrieval(&chunkList.array[i]);
+		}
+
+		*numSearched += count;
+		*numFound += chunkList.numFound;
+	}
+
+	closeChunkPipeline(&pipeline, searchLoad);
+	PerfCounts counts;
+	if (perfCounters)
+	{
+		readPerfCounters(&counters, &counts);
+		closePerfCounters(&counters);
+	}
+	deleteSearchList(&chunkList);
+
+	if (count == -1)
+	{
+		printf("Error: cannot read file %s!\n", searchFile);
+		return -1;
+	}
+	if (*numSearched == 0)
+	{
+		printf("Error: No retrieval data loaded from file %s!\n", searchFile);
+		return -1;
+	}
+
+	singleBenchResult(searchResult, "retrieve", totalTime / *numSearched, *numSearched);
+	if (perfCounters)
+	{
+		searchResult->counts = counts;
+		scalePerfCounts(&searchResult->counts, (double)*numSearched);
+	}
+
+	return 0;
+}
+
+//the structure the server searches
+typedef struct HashServer HashServer;
+struct HashServer
+{
+	Storage* storage; //pointer to the storage with the stored elements
+	SearchList searchList; //the entries of the batch being searched, room for SERVER_MAX_BATCH entries
+};
+
+//searches for a batch of keys received by the server with one batched call, behind the Bloom filter if there is one,
+//whose false positives among the keys that were not found are counted afterwards like for a streamed search
+//context: pointer to the HashServer
+//keys: pointer to the keys to search for
+//count: the number of keys, at most SERVER_MAX_BATCH
+//positions: pointer to an array of count ints where the index of every key in the storage is saved, -1 if it is not found
+//returns: the number of keys found
+int serveLookup(void* context, const int* keys, int count, int* positions)
+{
+	HashServer* hashServer = (HashServer*)context;
+	SearchList* searchList = &hashServer->searchList;
+
+	searchList->size = count;
+	for (int i = 0; i < count; ++i)
+	{
+		searchList->array[i].key = keys[i];
+	}
+
+	searchStorageBatch(hashServer->storage, searchList);
+	if (hashServer->storage->filter.blocks != NULL)
+	{
+		countFilterMisses(hashServer->storage, searchList->array, count);
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		positions[i] = searchList->array[i].index;
+	}
+
+	return searchList->numFound;
+}
+
+//answers the lookups of the clients of the server with the stored elements until the server is stopped,
+//after printing the header, the storage details and the time of the storage, and prints the statistics of the server at the end
+//storage: pointer to the storage with the stored elements
+//serveAddress: the socket path, "-" for the standard input and output
+//inputFile: the path to the input file
+//deleteFile: the path to the deletion file, NULL if nothing was deleted
+//inputList: the list of entries for storage
+//inputLoad: pointer to the statistics of loading the input file
+//storeResult: pointer to the measured time of storing all the elements
+//returns: 0 on success, -1 if the server could not be opened or failed
+int serveStorage(Storage* storage, char* serveAddress, char* inputFile, char* deleteFile, InputList inputList, LoadStats* inputLoad,
+	BenchResult* storeResult)
+{
+	HashServer hashServer = { storage, { NULL, 0, 0 } };
+	hashServer.searchList.array = (SearchEntry*)malloc(SERVER_MAX_BATCH * sizeof(SearchEntry));
+	if (hashServer.searchList.array == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	Server server;
+	if (openServer(&server, serveAddress) == -1)
+	{
+		deleteSearchList(&hashServer.searchList);
+		return -1;
+	}
+
+	printStatsHeader(inputFile, NULL, deleteFile, storage);
+	printf("\n");
+	printStorageDetails(storage, inputList, storeResult);
+	printf("\nExecution times:\n\n");
+	if (storage->engine == ENGINE_CLASSIC && storage->snapshot.map != NULL)
+	{
+		printBenchResult("store data", storeResult, "snapshot mapped and checked");
+	}
+	else
+	{
+		printLoadStats("input data", inputLoad);
+		printBenchResult("store data", storeResult, NULL);
+	}
+	printf("\n");
+
+	int result = runServer(&server, serveLookup, &hashServer);
+	printServerStats(&server);
+	if (storage->filter.blocks != NULL)
+	{
+		printBloomFilter(&storage->filter, storage->filterTime, storage->filterMisses, storage->filterFalsePositives);
+	}
+	printf("\n================================\n\n");
 
-	//try to insert all of the elements from the input list into the hash table
-	//do it many times for purposes of execution time measuring
-	clock_t lastTime = clock();
-	for (int i = 0; i < 1000000; ++i)
+	closeServer(&server);
+	deleteSearchList(&hashServer.searchList);
+
+	return result;
+}
+
+//returns the maximum load factor of an engine when --max-load is not given
+//the concurrent table is sized for the input at its own cap, since it never grows and a miss scans up to the next empty slot,
+//and the robin hood table grows at its own cap, since its probe distances jump as the last empty slots are filled
+//the classic table grows when the load factor would exceed it, which for quadratic probing on a prime size has to happen at half the table:
+//its probe sequence reaches only about half of the entries, so an insert above that load can probe the whole sequence in vain first
+//engine: the engine of the storage
+//probeSequence: the probe sequence of the classic engine
+//returns: the default maximum load factor
+double defaultMaxLoad(Engine engine, ProbeSequence probeSequence)
+{
+	if (engine == ENGINE_CONCURRENT)
+	{
+		return CONCURRENT_MAX_LOAD;
+	}
+	if (engine == ENGINE_ROBINHOOD)
+	{
+		return ROBINHOOD_MAX_LOAD;
+	}
+	if (engine != ENGINE_CLASSIC)
+	{
+		return DEFAULT_MAX_LOAD;
+	}
+
+	return probeSequence == PROBE_QUADRATIC ? QUADRATIC_MAX_LOAD : PROBING_MAX_LOAD;
+}
+
+//parses the optional arguments
+//argc: the number of arguments
+//argv: the arguments, the options start after the three required arguments
+//options: pointer to the structure where the settings are saved, options that are not given keep their default values
+//returns: 0 on success, -1 if an option is unknown or has an invalid value
+int parseOptions(int argc, char* argv[], Options* options)
+{
+	options->maxLoad = 0.0;
+	options->rehashStep = DEFAULT_REHASH_STEP;
+	options->recordCollisions = 1;
+	options->engine = ENGINE_CLASSIC;
+	options->batch = 0;
+	options->hashFunction = HASH_MODULO;
+	options->probeSequence = PROBE_QUADRATIC;
+	options->deleteFile = NULL;
+	options->numThreads = 1;
+	options->snapshotFile = NULL;
+	options->verifySnapshot = 0;
+	options->stream = 0;
+	options->probeStats = 0;
+	options->probeStatsFile = NULL;
+	options->filterBits = 0;
+	options->serveAddress = NULL;
+	initBenchOptions(&options->bench);
+
+	for (int i = 4; i < argc; ++i)
+	{
+		//options without a value
+		if (strcmp(argv[i], "--no-collisions") == 0)
+		{
+			options->recordCollisions = 0;
+			continue;
+		}
+		if (strcmp(argv[i], "--batch") == 0)
+		{
+			options->batch = 1;
+			continue;
+		}
+		if (strcmp(argv[i], "--stream") == 0)
+		{
+			options->stream = 1;
+			continue;
+		}
+		if (strcmp(argv[i], "--probe-stats") == 0)
+		{
+			options->probeStats = 1;
+			continue;
+		}
+		if (strcmp(argv[i], "--verify-snapshot") == 0)
+		{
+			options->verifySnapshot = 1;
+			continue;
+		}
+
+		//the filter takes the number of bits per item if the next argument isn't an option, BLOOM_DEFAULT_BITS otherwise
+		if (strcmp(argv[i], "--filter") == 0)
+		{
+			options->filterBits = BLOOM_DEFAULT_BITS;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				options->filterBits = atoi(argv[++i]);
+				if (options->filterBits < 1 || options->filterBits > 64)
+				{
+					printf("Error: the number of bits per item of the filter must be from 1 to 64!\n");
+					return -1;
+				}
+			}
+			continue;
+		}
+
+		//the options of the benchmark
+		int parsed = parseBenchOption(argc, argv, &i, &options->bench);
+		if (parsed == -1)
+		{
+			return -1;
+		}
+		if (parsed == 1)
+		{
+			continue;
+		}
+
+		//all the other options take a value
+		if (i + 1 >= argc)
+		{
+			printf("Error: option %s requires a value!\n", argv[i]);
+			return -1;
+		}
+
+		if (strcmp(argv[i], "--max-load") == 0)
+		{
+			options->maxLoad = atof(argv[++i]);
+			if (options->maxLoad <= 0.0 || options->maxLoad > 1.0)
+			{
+				printf("Error: maximum load factor must be greater than 0 and at most 1!\n");
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--rehash-step") == 0)
+		{
+			options->rehashStep = atoi(argv[++i]);
+			if (options->rehashStep <= 0)
+			{
+				printf("Error: rehash step must be greater than 0!\n");
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--engine") == 0)
+		{
+			++i;
+			if (strcmp(argv[i], "classic") == 0)
+			{
+				options->engine = ENGINE_CLASSIC;
+			}
+			else if (strcmp(argv[i], "swiss") == 0)
+			{
+				options->engine = ENGINE_SWISS;
+			}
+			else if (strcmp(argv[i], "robinhood") == 0)
+			{
+				options->engine = ENGINE_ROBINHOOD;
+			}
+			else if (strcmp(argv[i], "concurrent") == 0)
+			{
+				options->engine = ENGINE_CONCURRENT;
+			}
+			else if (strcmp(argv[i], "perfect") == 0)
+			{
+				options->engine = ENGINE_PERFECT;
+			}
+			else if (strcmp(argv[i], "cuckoo") == 0)
+			{
+				options->engine = ENGINE_CUCKOO;
+			}
+			else
+			{
+				printf("Error: unknown engine %s!\n", argv[i]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--hash") == 0)
+		{
+			++i;
+			if (strcmp(argv[i], "modulo") == 0)
+			{
+				options->hashFunction = HASH_MODULO;
+			}
+			else if (strcmp(argv[i], "fibonacci") == 0)
+			{
+				options->hashFunction = HASH_FIBONACCI;
+			}
+			else if (strcmp(argv[i], "murmur") == 0)
+			{
+				options->hashFunction = HASH_MURMUR;
+			}
+			else
+			{
+				printf("Error: unknown hash function %s!\n", argv[i]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--probe") == 0)
+		{
+			++i;
+			if (strcmp(argv[i], "quadratic") == 0)
+			{
+				options->probeSequence = PROBE_QUADRATIC;
+			}
+			else if (strcmp(argv[i], "linear") == 0)
+			{
+				options->probeSequence = PROBE_LINEAR;
+			}
+			else if (strcmp(argv[i], "triangular") == 0)
+			{
+				options->probeSequence = PROBE_TRIANGULAR;
+			}
+			else if (strcmp(argv[i], "double") == 0)
+			{
+				options->probeSequence = PROBE_DOUBLE;
+			}
+			else
+			{
+				printf("Error: unknown probe sequence %s!\n", argv[i]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--delete") == 0)
+		{
+			options->deleteFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--snapshot") == 0)
+		{
+			options->snapshotFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--probe-stats-json") == 0)
+		{
+			options->probeStatsFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--serve") == 0)
+		{
+			options->serveAddress = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threads") == 0)
+		{
+			options->numThreads = atoi(argv[++i]);
+			if (options->numThreads < 1 || options->numThreads > MAX_BUILD_THREADS)
+			{
+				printf("Error: the number of threads must be from 1 to %d!\n", MAX_BUILD_THREADS);
+				return -1;
+			}
+		}
+		else
+		{
+			printf("Error: unknown option %s!\n", argv[i]);
+			return -1;
+		}
+	}
+
+	//without --max-load, the classic table grows before its probe sequence runs out of empty entries
+	if (options->maxLoad == 0.0)
+	{
+		options->maxLoad = defaultMaxLoad(options->engine, options->probeSequence);
+	}
+
+	//the swiss, concurrent, perfect and cuckoo tables have their own hash functions and probing, the robin hood table always probes linearly
+	if ((options->engine == ENGINE_SWISS || options->engine == ENGINE_CONCURRENT || options->engine == ENGINE_PERFECT || options->engine == ENGINE_CUCKOO)
+		&& (options->hashFunction != HASH_MODULO || options->probeSequence != PROBE_QUADRATIC))
+	{
+		printf("Error: --hash and --probe apply only to the classic engine!\n");
+		return -1;
+	}
+	if (options->engine == ENGINE_ROBINHOOD && options->probeSequence != PROBE_QUADRATIC)
+	{
+		printf("Error: the robinhood engine always uses linear probing!\n");
+		return -1;
+	}
+
+	if (options->numThreads > 1 && options->engine != ENGINE_CLASSIC)
+	{
+		printf("Error: --threads applies only to the classic engine!\n");
+		return -1;
+	}
+
+	if (options->snapshotFile != NULL && options->engine != ENGINE_CLASSIC)
+	{
+		printf("Error: --snapshot applies only to the classic engine!\n");
+		return -1;
+	}
+
+	if ((options->probeStats || options->probeStatsFile != NULL) && options->engine != ENGINE_CLASSIC)
+	{
+		printf("Error: --probe-stats applies only to the classic engine!\n");
+		return -1;
+	}
+
+	//the server answers the lookups of its clients instead of searching the search file
+	if (options->serveAddress != NULL && (options->stream || options->probeStats || options->probeStatsFile != NULL))
+	{
+		printf("Error: --serve can't be used with --stream or --probe-stats!\n");
+		return -1;
+	}
+
+	//deleting without tombstones relies on the probe distances of the robin hood table
+	if (options->deleteFile != NULL && options->engine != ENGINE_ROBINHOOD)
+	{
+		printf("Error: --delete requires the robinhood engine!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	//check the number of arguments
+	if (argc < 4)
+	{
+		//wrong number of arguments
+		printf("Error: 3 arguments required!\n");
+		return -1;
+	}
+
+	//read the optional settings
+	Options options;
+	if (parseOptions(argc, argv, &options) == -1)
+	{
+		return -1;
+	}
+
+	//get the hash table size
+	int hashSize = atoi(argv[3]);
+
+	//check if the hash table size is valid
+	if (hashSize <= 0)
+	{
+		//invalid hash table size
+		printf("Error: hash table size must be greater than 0!\n");
+		return -1;
+	}
+
+	//an existing snapshot replaces the input data
+	int useSnapshot = options.snapshotFile != NULL && snapshotExists(options.snapshotFile);
+
+	//read the input data from the specified file and store it in the input list
+	LoadStats inputLoad = { 0, 0, 0.0 };
+	InputList inputList = { NULL, 0 };
+	if (!useSnapshot)
+	{
+		inputList = readInputList(argv[1], &inputLoad);
+		if (inputList.size == 0)
+		{
+			//nothing was read
+			return -1;
+		}
+	}
+
+	//read the search data from the specified file and store it in the search list, a streamed search file is read while searching
+	LoadStats searchLoad = { 0, 0, 0.0 };
+	SearchList searchList = { NULL, 0, 0 };
+	int readSearchFile = !options.stream && options.serveAddress == NULL;
+	if (readSearchFile)
+	{
+		searchList = readSearchList(argv[2], &searchLoad);
+	}
+	if (readSearchFile && searchList.size == 0)
+	{
+		//nothing was read
+		//free dynamically allocated memory
+		deleteInputList(&inputList);
+		return -1;
+	}
+
+	//the collisions are recorded into the log unless recording is disabled
+	CollisionLog collisionLog;
+	initCollisionLog(&collisionLog);
+	CollisionLog* log = options.recordCollisions ? &collisionLog : NULL;
+
+	//allocate the hash table
+	Storage storage;
+
+	//if there was an allocation error
+	if (initStorage(&storage, &options, hashSize, log) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		//free dynamically allocated memory
+		deleteInputList(&inputList);
+		deleteSearchList(&searchList);
+		return -1;
+	}
+
+	//insert all of the elements from the input list into the hash table
+	//the insertion is repeated by the benchmark harness for measuring its time, a parallel build is measured by the wall clock too
+	//with a snapshot, the storage time is the time to map and check it once, and a server builds the table once and reports that build
+	BenchResult results[2]; //the results of the storage and of the retrieval
+	StoreBench storeBench = { &storage, inputList };
+	int storeFailed;
+	if (useSnapshot)
+	{
+		double start = benchNow();
+		storeFailed = loadHashSnapshot(&storage, &options, hashSize, argv[1], options.snapshotFile) == -1;
+		if (!storeFailed && options.filterBits > 0)
+		{
+			storeFailed = createStorageFilter(&storage, inputList) == -1;
+		}
+		singleBenchResult(&results[0], "store", benchNow() - start, 1);
+	}
+	else if (options.serveAddress != NULL)
+	{
+		double start = benchNow();
+		storeFailed = benchStore(&storeBench) == -1;
+		singleBenchResult(&results[0], "store", benchNow() - start, 1);
+	}
+	else
+	{
+		storeFailed = runBenchmark(&results[0], "store", benchStore, NULL, &storeBench, 1, &options.bench) == -1;
+	}
+	if (storeFailed)
+	{
+		//free dynamically allocated memory
+		deleteInputList(&inputList);
+		deleteSearchList(&searchList);
+		deleteStorage(&storage);
+		deleteCollisionLog(&collisionLog);
+		return -1;
+	}
+
+	//write the snapshot of the built table for the next runs
+	if (options.snapshotFile != NULL && !useSnapshot && saveHashSnapshot(&storage, &options, hashSize, inputList, argv[1], options.snapshotFile) == -1)
 	{
-		createHash(&hashTable, inputList);
+		//free dynamically allocated memory
+		deleteInputList(&inputList);
+		deleteSearchList(&searchList);
+		deleteStorage(&storage);
+		deleteCollisionLog(&collisionLog);
+		return -1;
 	}
-	//compute the storage time for the hash table
-	clock_t totalTime = clock() - lastTime;
-	float storageTime = ((((float)totalTime) / CLOCKS_PER_SEC) * 1000) / (1000000);
 
-	//do the search many times for purposes of execution time measuring
-	totalTime = 0;
-	for (int i = 0; i < 1000000; ++i)
+	//delete the elements listed in the deletion file from the stored table
+	if (options.deleteFile != NULL)
 	{
-		searchList.numFound = 0;
+		SearchList deleteList = readSearchList(options.deleteFile, NULL);
+		if (deleteList.size == 0)
+		{
+			//nothing was read
+			//free dynamically allocated memory
+			deleteInputList(&inputList);
+			deleteSearchList(&searchList);
+			deleteStorage(&storage);
+			deleteCollisionLog(&collisionLog);
+			return -1;
+		}
 
-		//for each item in the search list
-		for (int j = 0; j < searchList.size; ++j)
+		for (int i = 0; i < deleteList.size; ++i)
 		{
-			//try to find it in the hash table
-			lastTime = clock();
-			int index = searchHash(&hashTable, &searchList.array[j]);
+			deleteKey(&storage, deleteList.array[i].key);
+		}
+
+		deleteSearchList(&deleteList);
+	}
+
+	//answer the lookups of the clients with the stored elements until the server is stopped
+	if (options.serveAddress != NULL)
+	{
+		int result = serveStorage(&storage, options.serveAddress, argv[1], options.deleteFile, inputList, &inputLoad, &results[0]);
+
+		//free dynamically allocated memory
+		deleteInputList(&inputList);
+		deleteStorage(&storage);
+		deleteCollisionLog(&collisionLog);
+
+		return result;
+	}
+
+	//the probe telemetry is collected from the built table and from repeating the searches with counting, outside the timed phases
+	ProbeStats probeStats;
+	ProbeStats* telemetry = options.probeStats || options.probeStatsFile != NULL ? &probeStats : NULL;
+	if (telemetry != NULL)
+	{
+		collectTableProbes(&storage.hashTable, telemetry);
+	}
 
-			if (index != -1)
+	//search for the streamed elements once, printing the results as they are found
+	if (options.stream)
+	{
+		printStatsHeader(argv[1], argv[2], options.deleteFile, &storage);
+		printf("\n");
+		printStorageDetails(&storage, inputList, &results[0]);
+		printf("\nRetrieval details:\n\n");
+
+		long long numSearched;
+		long long numFound;
+		int result = streamSearch(&storage, argv[2], options.batch, &numSearched, &numFound, &searchLoad, options.bench.perfCounters, &results[1],
+			telemetry);
+		if (result == 0)
+		{
+			printf("\nNumber of items searched: %lld\n", numSearched);
+			printf("Number of items found: %lld\n", numFound);
+			if (storage.filter.blocks != NULL)
 			{
-				searchList.numFound++; //it was found
+				printBloomFilter(&storage.filter, storage.filterTime, storage.filterMisses, storage.filterFalsePositives);
 			}
-			totalTime += clock() - lastTime;
+			if (options.probeStats)
+			{
+				printProbeStats(telemetry);
+			}
+			printExecutionTimes(&storage, &inputLoad, &searchLoad, &results[0], &results[1]);
+		}
+		if (result == 0 && options.bench.reportFile != NULL)
+		{
+			result = writeHashReport(&options, &storage, argv[1], numSearched, results);
 		}
+		if (result == 0 && options.probeStatsFile != NULL)
+		{
+			result = writeProbeStatsJson(telemetry, options.probeStatsFile);
+		}
+
+		//free dynamically allocated memory
+		deleteInputList(&inputList);
+		deleteStorage(&storage);
+		deleteCollisionLog(&collisionLog);
+
+		return result;
+	}
+
+	//search for the whole search list, repeated by the benchmark harness for measuring the time of one search
+	//with --batch the list is searched with one batched call
+	SearchBench searchBench = { &storage, &searchList, options.batch };
+	if (runBenchmark(&results[1], "retrieve", benchSearch, NULL, &searchBench, searchList.size, &options.bench) == -1)
+	{
+		//free dynamically allocated memory
+		deleteInputList(&inputList);
+		deleteSearchList(&searchList);
+		deleteStorage(&storage);
+		deleteCollisionLog(&collisionLog);
+		return -1;
 	}
-	//compute the search time for the hash table
-	float searchTime = ((((float)totalTime) / CLOCKS_PER_SEC) * 1000) / (1000000 * searchList.size);
 	
+	if (telemetry != NULL)
+	{
+		collectSearchProbes(&storage.hashTable, searchList.array, searchList.size, telemetry);
+	}
+	if (storage.filter.blocks != NULL)
+	{
+		countFilterMisses(&storage, searchList.array, searchList.size);
+	}
+
 	//print the statistics
-	printStats(argv[1], argv[2], hashTable, searchList, inputList, storageTime, searchTime);
+	printStats(argv[1], argv[2], options.deleteFile, &storage, searchList, inputList, &inputLoad, &searchLoad, &results[0], &results[1],
+		options.probeStats ? telemetry : NULL);
+
+	//append the measured times to the report
+	int result = 0;
+	if (options.bench.reportFile != NULL)
+	{
+		result = writeHashReport(&options, &storage, argv[1], searchList.size, results);
+	}
+	if (result == 0 && options.probeStatsFile != NULL)
+	{
+		result = writeProbeStatsJson(telemetry, options.probeStatsFile);
+	}
 
 	//free dynamically allocated memory
 	deleteInputList(&inputList);
 	deleteSearchList(&searchList);
-	deleteHash(&hashTable);
+	deleteStorage(&storage);
+	deleteCollisionLog(&collisionLog);
 
-	return 0;
+	return result;
 }
 
 
@@ -0,0 +1,101 @@
+#ifndef HASHPOLICY_H
+#define HASHPOLICY_H
+
+//hash functions and probe sequences that the hash tables can be specialized for
+//the functions are static inline so that every table compiles them into its own probing loops
+
+//the hash functions mapping a key to its home index
+typedef enum HashFunction HashFunction;
+enum HashFunction
+{
+	HASH_MODULO, //f(k) = k mod TableSize
+	HASH_FIBONACCI, //multiplication by 2^32 divided by the golden ratio, the high bits select the index
+	HASH_MURMUR //the finalizer of the 32-bit murmur3 hash, every bit of the key affects every bit of the hash
+};
+
+//the sequences of indices probed after the home index
+typedef enum ProbeSequence ProbeSequence;
+enum ProbeSequence
+{
+	PROBE_QUADRATIC, //home + i*i
+	PROBE_LINEAR, //home + i
+	PROBE_TRIANGULAR, //home + i*(i+1)/2, visits every index of a power of two table
+	PROBE_DOUBLE //home + i*step, where the step is given by a second hash of the key
+};
+
+//the multiplicative (fibonacci) hash of a key
+//key: the key to hash
+//returns: the hash of the key, its high bits are the best mixed ones
+static inline unsigned int hashFibonacci(int key)
+{
+	return (unsigned int)key * 2654435769u;
+}
+
+//the murmur3 finalizer hash of a key
+//key: the key to hash
+//returns: the hash of the key
+static inline unsigned int hashMurmur(int key)
+{
+	unsigned int h = (unsigned int)key;
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+
+	return h;
+}
+
+//maps a 32-bit hash onto the range [0, size) with a multiplication instead of a division
+//for a power of two size this takes the highest bits of the hash
+//hash: the hash
+//size: the size of the range
+//returns: the index in the range
+static inline unsigned int reduceHash(unsigned int hash, int size)
+{
+	return (unsigned int)(((unsigned long long)hash * (unsigned int)size) >> 32);
+}
+
+//checks whether a size is a power of two
+//size: the size, greater than 0
+//returns: 1 if the size is a power of two, 0 otherwise
+static inline int isPowerOfTwo(int size)
+{
+	return (size & (size - 1)) == 0;
+}
+
+//returns the name of a hash function as it is given on the command line
+//hashFunction: the hash function
+//returns: the name of the hash function
+static inline const char* hashFunctionName(HashFunction hashFunction)
+{
+	switch (hashFunction)
+	{
+	case HASH_FIBONACCI:
+		return "fibonacci";
+	case HASH_MURMUR:
+		return "murmur";
+	default:
+		return "modulo";
+	}
+}
+
+//returns the name of a probe sequence as it is given on the command line
+//probeSequence: the probe sequence
+//returns: the name of the probe sequence
+static inline const char* probeSequenceName(ProbeSequence probeSequence)
+{
+	switch (probeSequence)
+	{
+	case PROBE_LINEAR:
+		return "linear";
+	case PROBE_TRIANGULAR:
+		return "triangular";
+	case PROBE_DOUBLE:
+		return "double";
+	default:
+		return "quadratic";
+	}
+}
+
+#endif
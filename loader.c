@@ -0,0 +1,323 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "loader.h"
+
+//returns the current time of the monotonic clock
+//returns: the time in seconds
+static double loaderTime()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+//checks whether a character is a decimal digit
+//c: the character
+//returns: 1 if the character is a digit, 0 otherwise
+static inline int isDigit(char c)
+{
+	return (unsigned char)(c - '0') < 10;
+}
+
+//parses the digits at the beginning of a string, up to 8 of them at once
+//on little-endian machines 8 characters are loaded as one 64-bit word, the length of the run of digits is found from a mask of the non-digit bytes
+//and the digits are combined into the value by three multiplications (SWAR, SIMD within a register)
+//p: pointer to the first digit, at least 8 bytes must be readable from it
+//value: pointer to where the value of the digits is saved, it wraps around if it doesn't fit
+//returns: pointer to the first character after the digits
+static inline const char* parseDigits(const char* p, unsigned int* value)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	unsigned long long word;
+	memcpy(&word, p, sizeof(word));
+
+	//a byte is a digit if its high nibble is 3 and its low nibble plus 6 doesn't carry into the high nibble
+	unsigned long long nonDigits = ((word & 0xF0F0F0F0F0F0F0F0ull) ^ 0x3030303030303030ull)
+		| (((word & 0x0F0F0F0F0F0F0F0Full) + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull);
+	int length = nonDigits == 0 ? 8 : __builtin_ctzll(nonDigits) / 8;
+
+	//move the digits to the high bytes, the low bytes become leading zeros, then combine pairs of digits, pairs of pairs and pairs of those
+	unsigned long long digits = (word & 0x0F0F0F0F0F0F0F0Full) << (8 * (8 - length) & 63);
+	if (length == 0)
+	{
+		digits = 0;
+	}
+	digits = (digits * 2561) >> 8;
+	digits = ((digits & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+	digits = ((digits & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+
+	unsigned int result = (unsigned int)digits;
+	p += length;
+#else
+	unsigned int result = 0;
+#endif
+
+	//the digits after the first 8, and all of them without the fast path
+	while (isDigit(*p))
+	{
+		result = result * 10 + (unsigned int)(*p - '0');
+		p++;
+	}
+
+	*value = result;
+
+	return p;
+}
+
+//moves the unparsed characters to the beginning of the buffer and reads the next block of the file after them
+//reader: pointer to the reader
+static void refillBuffer(IntReader* reader)
+{
+	size_t remaining = reader->length - reader->position;
+	memmove(reader->buffer, reader->buffer + reader->position, remaining);
+	reader->position = 0;
+	reader->length = remaining;
+
+	size_t numRead = fread(reader->buffer + reader->length, 1, LOADER_BLOCK_SIZE - reader->length, reader->file);
+	reader->length += numRead;
+	reader->stats.numBytes += (long long)numRead;
+
+	if (numRead < LOADER_BLOCK_SIZE - remaining)
+	{
+		reader->error = ferror(reader->file) != 0;
+		reader->endOfFile = feof(reader->file) != 0 || reader->error;
+	}
+
+	//the terminating character stops the parsing loops at the end of the data without checking the length
+	reader->buffer[reader->length] = '\0';
+}
+
+int openIntReader(IntReader* reader, const char* fileName)
+{
+	reader->startTime = loaderTime();
+	reader->stats.numBytes = 0;
+	reader->stats.numValues = 0;
+	reader->stats.seconds = 0.0;
+	reader->position = 0;
+	reader->length = 0;
+	reader->endOfFile = 0;
+	reader->error = 0;
+	reader->buffer = NULL;
+
+	reader->file = strcmp(fileName, "-") == 0 ? stdin : fopen(fileName, "rb");
+	if (reader->file == NULL)
+	{
+		return -1;
+	}
+
+	//the terminating character and the 8 bytes the digit parser may load from it are allocated after the block
+	reader->buffer = (char*)calloc(LOADER_BLOCK_SIZE + 1 + 8, 1);
+	if (reader->buffer == NULL)
+	{
+		closeIntReader(reader, NULL);
+		return -1;
+	}
+	reader->buffer[0] = '\0';
+
+	return 0;
+}
+
+int readInts(IntReader* reader, int* values, int count)
+{
+	int numRead = 0;
+
+	while (numRead < count)
+	{
+		if (!reader->endOfFile && reader->length - reader->position <= LOADER_MAX_TOKEN)
+		{
+			refillBuffer(reader);
+		}
+
+		//values are parsed only before the limit, so that a value is never cut by the end of the buffer unless the file ends there
+		const char* p = reader->buffer + reader->position;
+		const char* end = reader->buffer + reader->length;
+		const char* limit = reader->endOfFile ? end : end - LOADER_MAX_TOKEN;
+
+		while (numRead < count)
+		{
+			//skip the separators, a minus sign counts only when a digit follows
+			while (p < limit && !isDigit(*p) && !(*p == '-' && isDigit(p[1])))
+			{
+				p++;
+			}
+			if (p >= limit)
+			{
+				break;
+			}
+
+			int negative = *p == '-';
+			p += negative;
+
+			unsigned int value;
+			p = parseDigits(p, &value);
+
+			values[numRead++] = negative ? (int)(0u - value) : (int)value;
+		}
+
+		reader->position = (size_t)(p - reader->buffer);
+
+		//the whole file was parsed
+		if (reader->endOfFile && p >= end)
+		{
+			break;
+		}
+	}
+
+	reader->stats.numValues += numRead;
+
+	return numRead == 0 && reader->error ? -1 : numRead;
+}
+
+void closeIntReader(IntReader* reader, LoadStats* stats)
+{
+	if (reader->file != NULL && reader->file != stdin)
+	{
+		fclose(reader->file);
+	}
+	reader->file = NULL;
+	free(reader->buffer);
+	reader->buffer = NULL;
+
+	reader->stats.seconds = loaderTime() - reader->startTime;
+	if (stats != NULL)
+	{
+		*stats = reader->stats;
+	}
+}
+
+//the reading thread of a chunk pipeline: parses chunks into the free chunks until the end of the file or until the pipeline is closed
+//arg: pointer to the ChunkPipeline
+//returns: NULL
+static void* readChunks(void* arg)
+{
+	ChunkPipeline* pipeline = (ChunkPipeline*)arg;
+	int chunk = 0;
+
+	while (1)
+	{
+		//wait until a chunk is free, the chunks the caller hasn't taken yet or works on are not
+		pthread_mutex_lock(&pipeline->mutex);
+		while (pipeline->numFull + pipeline->held == PIPELINE_DEPTH && !pipeline->stop)
+		{
+			pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+		}
+		int stop = pipeline->stop;
+		pthread_mutex_unlock(&pipeline->mutex);
+
+		if (stop)
+		{
+			break;
+		}
+
+		int count = readInts(&pipeline->reader, pipeline->chunks[chunk], PIPELINE_CHUNK_SIZE);
+
+		pthread_mutex_lock(&pipeline->mutex);
+		pipeline->counts[chunk] = count;
+		pipeline->numFull++;
+		pthread_cond_broadcast(&pipeline->changed);
+		pthread_mutex_unlock(&pipeline->mutex);
+
+		//the end of the file or an error is passed on as the last chunk
+		if (count <= 0)
+		{
+			break;
+		}
+		chunk = (chunk + 1) % PIPELINE_DEPTH;
+	}
+
+	return NULL;
+}
+
+int openChunkPipeline(ChunkPipeline* pipeline, const char* fileName)
+{
+	if (openIntReader(&pipeline->reader, fileName) == -1)
+	{
+		return -1;
+	}
+
+	int allocated = 1;
+	for (int i = 0; i < PIPELINE_DEPTH; ++i)
+	{
+		pipeline->chunks[i] = (int*)malloc(PIPELINE_CHUNK_SIZE * sizeof(int));
+		allocated = allocated && pipeline->chunks[i] != NULL;
+		pipeline->counts[i] = 0;
+	}
+	pipeline->numFull = 0;
+	pipeline->next = 0;
+	pipeline->held = 0;
+	pipeline->stop = 0;
+	pthread_mutex_init(&pipeline->mutex, NULL);
+	pthread_cond_init(&pipeline->changed, NULL);
+
+	if (!allocated || pthread_create(&pipeline->thread, NULL, readChunks, pipeline) != 0)
+	{
+		for (int i = 0; i < PIPELINE_DEPTH; ++i)
+		{
+			free(pipeline->chunks[i]);
+		}
+		pthread_mutex_destroy(&pipeline->mutex);
+		pthread_cond_destroy(&pipeline->changed);
+		closeIntReader(&pipeline->reader, NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
+int nextChunk(ChunkPipeline* pipeline, int** values)
+{
+	pthread_mutex_lock(&pipeline->mutex);
+
+	//give the previous chunk back to the reading thread
+	if (pipeline->held)
+	{
+		pipeline->held = 0;
+		pthread_cond_broadcast(&pipeline->changed);
+	}
+
+	while (pipeline->numFull == 0)
+	{
+		pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+	}
+
+	int chunk = pipeline->next;
+	int count = pipeline->counts[chunk];
+	pipeline->numFull--;
+	pipeline->held = 1;
+	pipeline->next = (pipeline->next + 1) % PIPELINE_DEPTH;
+
+	pthread_mutex_unlock(&pipeline->mutex);
+
+	*values = pipeline->chunks[chunk];
+
+	return count;
+}
+
+void closeChunkPipeline(ChunkPipeline* pipeline, LoadStats* stats)
+{
+	pthread_mutex_lock(&pipeline->mutex);
+	pipeline->stop = 1;
+	pthread_cond_broadcast(&pipeline->changed);
+	pthread_mutex_unlock(&pipeline->mutex);
+
+	pthread_join(pipeline->thread, NULL);
+
+	for (int i = 0; i < PIPELINE_DEPTH; ++i)
+	{
+		free(pipeline->chunks[i]);
+	}
+	pthread_mutex_destroy(&pipeline->mutex);
+	pthread_cond_destroy(&pipeline->changed);
+	closeIntReader(&pipeline->reader, stats);
+}
+
+void printLoadStats(const char* name, const LoadStats* stats)
+{
+	double seconds = stats->seconds > 0.0 ? stats->seconds : 1e-9;
+
+	printf("  Time to load %s: %f ms (%lld bytes, %.2f MB/s, %.2f million values/s)\n", name, stats->seconds * 1000, stats->numBytes,
+		stats->numBytes / seconds / 1e6, stats->numValues / seconds / 1e6);
+}
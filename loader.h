@@ -0,0 +1,105 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+//fast loading of integers from text files, used by both programs instead of one fscanf call per value
+//the file is read in large blocks into a buffer and the integers are parsed from the buffer by a hand-written loop that takes 8 digits at once,
+//only one block is held in memory at a time, so a file of any size can be streamed through a fixed amount of memory
+//the values are decimal integers with an optional minus sign, any other characters separate them,
+//a value that doesn't fit into an int wraps around
+
+//the size of the blocks the file is read in
+#define LOADER_BLOCK_SIZE (4 << 20)
+
+//the longest value, including leading zeros, that is guaranteed to be parsed whole when it crosses the end of a block
+#define LOADER_MAX_TOKEN 64
+
+//the number of values in a chunk of a file streamed through a ChunkPipeline
+#define PIPELINE_CHUNK_SIZE 65536
+
+//the number of chunks of a ChunkPipeline, the reading thread fills one while the caller works on another
+#define PIPELINE_DEPTH 2
+
+//the amount of data loaded and the time it took
+typedef struct LoadStats LoadStats;
+struct LoadStats
+{
+	long long numBytes; //the number of bytes read from the file
+	long long numValues; //the number of values parsed
+	double seconds; //the time from opening the file to closing it
+};
+
+//reader of integers from a text file
+typedef struct IntReader IntReader;
+struct IntReader
+{
+	FILE* file; //the file being read
+	char* buffer; //the block buffer, it has room for a terminating character after the data and for loading 8 bytes from it
+	size_t position; //the position of the next unparsed character in the buffer
+	size_t length; //the number of characters in the buffer
+	int endOfFile; //1 when the whole file has been read into the buffer
+	int error; //1 if reading the file failed
+	double startTime; //the time the file was opened
+	LoadStats stats; //the amount of data loaded so far, the time is set when the reader is closed
+};
+
+//opens a file for reading integers
+//reader: pointer to the reader
+//fileName: the path to the file, "-" reads the standard input
+//returns: 0 on success, -1 if the file could not be opened or the memory could not be allocated
+int openIntReader(IntReader* reader, const char* fileName);
+
+//reads the next integers from the file
+//reader: pointer to the reader
+//values: pointer to an array where the values are stored
+//count: the maximum number of values to read
+//returns: the number of values read, 0 at the end of the file, -1 if reading the file failed
+int readInts(IntReader* reader, int* values, int count);
+
+//closes the file and completes the statistics of the reader
+//reader: pointer to the reader
+//stats: pointer to the structure where the statistics are saved, NULL if they are not needed
+void closeIntReader(IntReader* reader, LoadStats* stats);
+
+//reader of a file in chunks of integers, a thread reads and parses the next chunk while the caller works on the current one,
+//so reading the file and using the values overlap, and the memory used doesn't depend on the size of the file
+typedef struct ChunkPipeline ChunkPipeline;
+struct ChunkPipeline
+{
+	IntReader reader; //the reader of the file, used only by the reading thread until the pipeline is closed
+	int* chunks[PIPELINE_DEPTH]; //the chunks of values, used in turn
+	int counts[PIPELINE_DEPTH]; //the number of values in every parsed chunk, 0 at the end of the file, -1 if reading failed
+	int numFull; //the number of parsed chunks the caller hasn't taken yet
+	int next; //the chunk the caller takes next
+	int held; //1 while the caller works on a chunk
+	int stop; //set to 1 when the pipeline is closed
+	pthread_t thread; //the reading thread
+	pthread_mutex_t mutex; //protects the fields above that both threads use
+	pthread_cond_t changed; //signalled when a chunk is parsed or released, or when the pipeline is closed
+};
+
+//opens a file and starts the thread that reads it in chunks of PIPELINE_CHUNK_SIZE values
+//pipeline: pointer to the pipeline
+//fileName: the path to the file, "-" reads the standard input
+//returns: 0 on success, -1 if the file could not be opened, the memory could not be allocated or the thread could not be started
+int openChunkPipeline(ChunkPipeline* pipeline, const char* fileName);
+
+//takes the next chunk of values, the previous chunk is given back to the reading thread
+//pipeline: pointer to the pipeline
+//values: pointer to where the pointer to the values of the chunk is saved, they stay valid until the next call
+//returns: the number of values in the chunk, 0 at the end of the file, -1 if reading the file failed, no more chunks may be taken after 0 or -1
+int nextChunk(ChunkPipeline* pipeline, int** values);
+
+//stops the reading thread and closes the file
+//pipeline: pointer to the pipeline
+//stats: pointer to the structure where the statistics of the loading are saved, NULL if they are not needed
+void closeChunkPipeline(ChunkPipeline* pipeline, LoadStats* stats);
+
+//prints a line with the time the loading took and its throughput
+//name: what was loaded, it is printed after "Time to load"
+//stats: pointer to the statistics of the loading
+void printLoadStats(const char* name, const LoadStats* stats);
+
+#endif
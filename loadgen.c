@@ -0,0 +1,383 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "loader.h"
+#include "server.h"
+
+//load generator for the query server of both programs (--serve): several connections, one thread each, send batches of keys
+//drawn at random from a key file for a given time, each keeping several batches in flight, and the throughput of the server
+//and the round trips of the batches are measured
+
+const int DEFAULT_CONNECTIONS = 4; //the default number of connections
+const int MAX_CONNECTIONS = SERVER_MAX_CLIENTS; //the largest number of connections
+const int DEFAULT_LOAD_BATCH = 100; //the default number of keys of a request
+const int DEFAULT_DEPTH = 4; //the default number of requests a connection keeps in flight
+const int MAX_DEPTH = 1024; //the largest number of requests in flight per connection
+const double DEFAULT_DURATION = 5.0; //the default time the load runs, in seconds
+
+//optional command line settings, given after the two required arguments
+typedef struct LoadOptions LoadOptions;
+struct LoadOptions
+{
+	int numConnections; //the number of connections (--connections)
+	int batchSize; //the number of keys of a request (--batch)
+	int depth; //the number of requests a connection keeps in flight (--depth)
+	double duration; //the time new requests are sent for, in seconds (--duration)
+	unsigned int seed; //the seed of the random choice of the keys (--seed)
+	int shutdown; //whether the server is stopped after the load, 1 with --shutdown
+};
+
+//the arguments and the results of one connection
+typedef struct LoadThread LoadThread;
+struct LoadThread
+{
+	pthread_t thread; //the thread
+	int id; //the number of the connection
+	const char* path; //the path of the socket of the server
+	const int* keys; //the keys the requests are drawn from
+	int numKeys; //the number of keys
+	const LoadOptions* options; //the settings of the load
+	long long numBatches; //the number of answered requests
+	long long numSearched; //the number of keys searched
+	long long numFound; //the number of keys found
+	LatencyHistogram latencies; //the round trips of the requests, from sending them to receiving their responses
+	double seconds; //the time from the first request to the last response
+	int failed; //1 if the connection failed
+};
+
+//advances a xorshift random number generator
+//state: pointer to the state of the generator, not 0
+//returns: the next random number
+unsigned int nextRandom(unsigned int* state)
+{
+	unsigned int x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+
+	return x;
+}
+
+//sends requests on one connection for the duration of the load, keeping up to depth of them in flight,
+//and receives their responses in order
+//argument: pointer to the LoadThread
+//returns: NULL
+void* runConnection(void* argument)
+{
+	LoadThread* load = (LoadThread*)argument;
+	const LoadOptions* options = load->options;
+	int batchSize = options->batchSize;
+
+	int* requests = (int*)malloc((size_t)options->depth * batchSize * sizeof(int));
+	int* positions = (int*)malloc((size_t)batchSize * sizeof(int));
+	double* sendTimes = (double*)malloc((size_t)options->depth * sizeof(double));
+	int fd = requests != NULL && positions != NULL && sendTimes != NULL ? connectServer(load->path) : -1;
+	if (fd == -1)
+	{
+		free(requests);
+		free(positions);
+		free(sendTimes);
+		load->failed = 1;
+		return NULL;
+	}
+
+	unsigned int state = options->seed + 0x9e3779b9u * (unsigned int)(load->id + 1);
+	if (state == 0)
+	{
+		state = 1;
+	}
+
+	//the requests in flight form a ring, the oldest one is answered first
+	int oldest = 0;
+	int numInFlight = 0;
+	double start = serverNow();
+	double end = start + options->duration;
+	while (1)
+	{
+		while (numInFlight < options->depth && serverNow() < end)
+		{
+			int slot = (oldest + numInFlight) % options->depth;
+			int* request = &requests[(size_t)slot * batchSize];
+			for (int i = 0; i < batchSize; ++i)
+			{
+				request[i] = load->keys[nextRandom(&state) % (unsigned int)load->numKeys];
+			}
+
+			sendTimes[slot] = serverNow();
+			if (sendRequest(fd, request, (unsigned int)batchSize) == -1)
+			{
+				load->failed = 1;
+				break;
+			}
+			numInFlight++;
+		}
+		if (numInFlight == 0 || load->failed)
+		{
+			break;
+		}
+
+		if (receiveResponse(fd, positions, batchSize) == -1)
+		{
+			load->failed = 1;
+			break;
+		}
+		addLatency(&load->latencies, (serverNow() - sendTimes[oldest]) * 1e6);
+		for (int i = 0; i < batchSize; ++i)
+		{
+			if (positions[i] != -1)
+			{
+				load->numFound++;
+			}
+		}
+		load->numBatches++;
+		load->numSearched += batchSize;
+		oldest = (oldest + 1) % options->depth;
+		numInFlight--;
+	}
+	load->seconds = serverNow() - start;
+
+	close(fd);
+	free(requests);
+	free(positions);
+	free(sendTimes);
+
+	return NULL;
+}
+
+//reads all the keys of a file
+//fileName: the path to the file
+//numKeys: the number of keys is saved here
+//returns: pointer to the keys, NULL if the file could not be read, was empty or the memory could not be allocated
+int* readKeys(const char* fileName, int* numKeys)
+{
+	IntReader reader;
+	if (openIntReader(&reader, fileName) == -1)
+	{
+		printf("Error: cannot open file %s!\n", fileName);
+		return NULL;
+	}
+
+	int capacity = 1 << 16;
+	int* keys = (int*)malloc((size_t)capacity * sizeof(int));
+	*numKeys = 0;
+	int count = 0;
+	while (keys != NULL && (count = readInts(&reader, keys + *numKeys, capacity - *numKeys)) > 0)
+	{
+		*numKeys += count;
+		if (*numKeys == capacity)
+		{
+			int* grown = capacity <= 0x7fffffff / 2 ? (int*)realloc(keys, 2 * (size_t)capacity * sizeof(int)) : NULL;
+			if (grown == NULL)
+			{
+				free(keys);
+				keys = NULL;
+				break;
+			}
+			keys = grown;
+			capacity *= 2;
+		}
+	}
+	closeIntReader(&reader, NULL);
+
+	if (keys == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return NULL;
+	}
+	if (count == -1 || *numKeys == 0)
+	{
+		printf("Error: No keys loaded from file %s!\n", fileName);
+		free(keys);
+		return NULL;
+	}
+
+	return keys;
+}
+
+//parses the optional arguments
+//argc: the number of arguments
+//argv: the arguments, the options start after the two required arguments
+//options: pointer to the structure where the settings are saved, options that are not given keep their default values
+//returns: 0 on success, -1 if an option is unknown or has an invalid value
+int parseLoadOptions(int argc, char* argv[], LoadOptions* options)
+{
+	options->numConnections = DEFAULT_CONNECTIONS;
+	options->batchSize = DEFAULT_LOAD_BATCH;
+	options->depth = DEFAULT_DEPTH;
+	options->duration = DEFAULT_DURATION;
+	options->seed = 1;
+	options->shutdown = 0;
+
+	for (int i = 3; i < argc; ++i)
+	{
+		//options without a value
+		if (strcmp(argv[i], "--shutdown") == 0)
+		{
+			options->shutdown = 1;
+			continue;
+		}
+
+		//all the other options take a value
+		if (i + 1 >= argc)
+		{
+			printf("Error: option %s requires a value!\n", argv[i]);
+			return -1;
+		}
+
+		if (strcmp(argv[i], "--connections") == 0)
+		{
+			options->numConnections = atoi(argv[++i]);
+			if (options->numConnections < 1 || options->numConnections > MAX_CONNECTIONS)
+			{
+				printf("Error: the number of connections must be from 1 to %d!\n", MAX_CONNECTIONS);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--batch") == 0)
+		{
+			options->batchSize = atoi(argv[++i]);
+			if (options->batchSize < 1 || options->batchSize > SERVER_MAX_BATCH)
+			{
+				printf("Error: the batch size must be from 1 to %d!\n", SERVER_MAX_BATCH);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--depth") == 0)
+		{
+			options->depth = atoi(argv[++i]);
+			if (options->depth < 1 || options->depth > MAX_DEPTH)
+			{
+				printf("Error: the number of requests in flight must be from 1 to %d!\n", MAX_DEPTH);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--duration") == 0)
+		{
+			options->duration = atof(argv[++i]);
+			if (options->duration <= 0.0)
+			{
+				printf("Error: the duration must be greater than 0!\n");
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--seed") == 0)
+		{
+			options->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		}
+		else
+		{
+			printf("Error: unknown option %s!\n", argv[i]);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	//check the number of arguments
+	if (argc < 3)
+	{
+		printf("Error: 2 arguments required!\n");
+		return -1;
+	}
+
+	LoadOptions options;
+	if (parseLoadOptions(argc, argv, &options) == -1)
+	{
+		return -1;
+	}
+
+	int numKeys;
+	int* keys = readKeys(argv[2], &numKeys);
+	if (keys == NULL)
+	{
+		return -1;
+	}
+
+	LoadThread* threads = (LoadThread*)calloc((size_t)options.numConnections, sizeof(LoadThread));
+	if (threads == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		free(keys);
+		return -1;
+	}
+
+	int numStarted = 0;
+	for (int i = 0; i < options.numConnections; ++i)
+	{
+		LoadThread* load = &threads[i];
+		load->id = i;
+		load->path = argv[1];
+		load->keys = keys;
+		load->numKeys = numKeys;
+		load->options = &options;
+		initLatencyHistogram(&load->latencies);
+		if (pthread_create(&load->thread, NULL, runConnection, load) != 0)
+		{
+			printf("Error: cannot start a thread!\n");
+			break;
+		}
+		numStarted++;
+	}
+
+	//the throughput is the keys of all the connections over the time of the longest one
+	LatencyHistogram latencies;
+	initLatencyHistogram(&latencies);
+	long long numBatches = 0;
+	long long numSearched = 0;
+	long long numFound = 0;
+	double seconds = 0.0;
+	int result = numStarted == options.numConnections ? 0 : -1;
+	for (int i = 0; i < numStarted; ++i)
+	{
+		LoadThread* load = &threads[i];
+		pthread_join(load->thread, NULL);
+		if (load->failed)
+		{
+			printf("Error: connection %d to the server failed!\n", i);
+			result = -1;
+		}
+		mergeLatencyHistogram(&latencies, &load->latencies);
+		numBatches += load->numBatches;
+		numSearched += load->numSearched;
+		numFound += load->numFound;
+		seconds = load->seconds > seconds ? load->seconds : seconds;
+	}
+
+	if (options.shutdown)
+	{
+		int fd = connectServer(argv[1]);
+		if (fd == -1 || sendRequest(fd, NULL, SERVER_SHUTDOWN) == -1)
+		{
+			printf("Error: cannot stop the server!\n");
+			result = -1;
+		}
+		if (fd != -1)
+		{
+			close(fd);
+		}
+	}
+
+	printf("Load generator:\n");
+	printf("================================\n\n");
+	printf("Server socket: %s\n", argv[1]);
+	printf("Keys loaded from file %s: %d\n", argv[2], numKeys);
+	printf("%d connections, batches of %d keys, %d batches in flight per connection, %.1f s\n\n", numStarted, options.batchSize, options.depth,
+		options.duration);
+	printf("  %lld batches, %lld keys searched, %lld found in %.3f s\n", numBatches, numSearched, numFound, seconds);
+	printf("  Throughput: %.0f keys per second, %.0f batches per second\n", seconds > 0.0 ? numSearched / seconds : 0.0,
+		seconds > 0.0 ? numBatches / seconds : 0.0);
+	printLatencyHistogram("Round trip of a batch", &latencies);
+	printf("\n================================\n\n");
+
+	free(threads);
+	free(keys);
+
+	return result;
+}
@@ -0,0 +1,199 @@
+#define _GNU_SOURCE //for syscall
+
+#include <string.h>
+#include <errno.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "perfcounters.h"
+
+#ifdef __linux__
+//the type and configuration of every event for perf_event_open, in the order of PerfEvent
+static const unsigned int EVENT_TYPES[PERF_NUM_EVENTS] =
+{
+	PERF_TYPE_HARDWARE,
+	PERF_TYPE_HARDWARE,
+	PERF_TYPE_HW_CACHE,
+	PERF_TYPE_HW_CACHE,
+	PERF_TYPE_HW_CACHE,
+	PERF_TYPE_HARDWARE,
+	PERF_TYPE_SOFTWARE
+};
+static const unsigned long long EVENT_CONFIGS[PERF_NUM_EVENTS] =
+{
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+	PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+	PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+	PERF_COUNT_HW_BRANCH_MISSES,
+	PERF_COUNT_SW_PAGE_FAULTS
+};
+#endif
+
+int openPerfCounters(PerfCounters* counters)
+{
+	counters->numAvailable = 0;
+	counters->error = 0;
+
+	for (int i = 0; i < PERF_NUM_EVENTS; ++i)
+	{
+		counters->descriptors[i] = -1;
+
+#ifdef __linux__
+		struct perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = EVENT_TYPES[i];
+		attributes.config = EVENT_CONFIGS[i];
+		attributes.disabled = 1;
+		attributes.inherit = 1; //the threads of a parallel build or sort are counted too
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		//the calling process on any processor
+		counters->descriptors[i] = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+		if (counters->descriptors[i] == -1)
+		{
+			if (counters->error == 0)
+			{
+				counters->error = errno;
+			}
+			continue;
+		}
+		counters->numAvailable++;
+#else
+		counters->error = ENOSYS;
+#endif
+	}
+
+	return counters->numAvailable;
+}
+
+void startPerfCounters(PerfCounters* counters)
+{
+#ifdef __linux__
+	for (int i = 0; i < PERF_NUM_EVENTS; ++i)
+	{
+		if (counters->descriptors[i] != -1)
+		{
+			ioctl(counters->descriptors[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#else
+	(void)counters;
+#endif
+}
+
+void stopPerfCounters(PerfCounters* counters)
+{
+#ifdef __linux__
+	for (int i = 0; i < PERF_NUM_EVENTS; ++i)
+	{
+		if (counters->descriptors[i] != -1)
+		{
+			ioctl(counters->descriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+#else
+	(void)counters;
+#endif
+}
+
+void readPerfCounters(PerfCounters* counters, PerfCounts* counts)
+{
+	counts->measured = 1;
+	counts->error = counters->error;
+
+	for (int i = 0; i < PERF_NUM_EVENTS; ++i)
+	{
+		counts->values[i] = 0.0;
+		counts->available[i] = 0;
+
+#ifdef __linux__
+		//the count, the time the counter was enabled and the time it was actually counting
+		unsigned long long values[3];
+		if (counters->descriptors[i] == -1 || read(counters->descriptors[i], values, sizeof(values)) != (ssize_t)sizeof(values))
+		{
+			continue;
+		}
+
+		//a counter that was multiplexed counted only part of the time, its count is scaled to the whole time
+		counts->available[i] = 1;
+		counts->values[i] = values[2] > 0 ? (double)values[0] * ((double)values[1] / values[2]) : 0.0;
+#else
+		(void)counters;
+#endif
+	}
+}
+
+void scalePerfCounts(PerfCounts* counts, double divisor)
+{
+	for (int i = 0; i < PERF_NUM_EVENTS; ++i)
+	{
+		counts->values[i] /= divisor;
+	}
+}
+
+void closePerfCounters(PerfCounters* counters)
+{
+	for (int i = 0; i < PERF_NUM_EVENTS; ++i)
+	{
+#ifdef __linux__
+		if (counters->descriptors[i] != -1)
+		{
+			close(counters->descriptors[i]);
+		}
+#endif
+		counters->descriptors[i] = -1;
+	}
+	counters->numAvailable = 0;
+}
+
+const char* perfEventName(PerfEvent event)
+{
+	switch (event)
+	{
+	case PERF_CYCLES:
+		return "cycles";
+	case PERF_INSTRUCTIONS:
+		return "instructions";
+	case PERF_L1D_MISSES:
+		return "L1 data cache misses";
+	case PERF_LLC_MISSES:
+		return "last level cache misses";
+	case PERF_DTLB_MISSES:
+		return "data TLB misses";
+	case PERF_BRANCH_MISSES:
+		return "branch mispredictions";
+	default:
+		return "page faults";
+	}
+}
+
+const char* perfEventColumn(PerfEvent event)
+{
+	switch (event)
+	{
+	case PERF_CYCLES:
+		return "cycles";
+	case PERF_INSTRUCTIONS:
+		return "instructions";
+	case PERF_L1D_MISSES:
+		return "l1d_misses";
+	case PERF_LLC_MISSES:
+		return "llc_misses";
+	case PERF_DTLB_MISSES:
+		return "dtlb_misses";
+	case PERF_BRANCH_MISSES:
+		return "branch_misses";
+	default:
+		return "page_faults";
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+//hardware performance counters of the calling thread and the threads it starts, read with perf_event_open on Linux
+//every counter is opened on its own, so a counter the processor or the kernel doesn't offer (in a virtual machine, or with
+//kernel.perf_event_paranoid set too high) is only marked as not available and the others are still counted;
+//when the processor has fewer counters than are opened, the kernel multiplexes them and the counts are scaled to the whole time
+//only events in user space are counted
+
+//the counted events
+typedef enum PerfEvent PerfEvent;
+enum PerfEvent
+{
+	PERF_CYCLES, //processor cycles
+	PERF_INSTRUCTIONS, //retired instructions
+	PERF_L1D_MISSES, //loads that missed the level 1 data cache
+	PERF_LLC_MISSES, //loads that missed the last level cache
+	PERF_DTLB_MISSES, //loads that missed the data TLB
+	PERF_BRANCH_MISSES, //mispredicted branches
+	PERF_PAGE_FAULTS, //page faults, a software event of the kernel
+	PERF_NUM_EVENTS //the number of events
+};
+
+//the counters of all the events
+typedef struct PerfCounters PerfCounters;
+struct PerfCounters
+{
+	int descriptors[PERF_NUM_EVENTS]; //the file descriptors of the counters, -1 if an event is not available
+	int numAvailable; //the number of events that are counted
+	int error; //the errno of opening the first counter that could not be opened, 0 if all of them were opened
+};
+
+//the counts of the events, accumulated over the periods the counters were running
+typedef struct PerfCounts PerfCounts;
+struct PerfCounts
+{
+	double values[PERF_NUM_EVENTS]; //the count of every event, scaled for multiplexing
+	int available[PERF_NUM_EVENTS]; //1 for the events that were counted
+	int measured; //1 if the counts were measured at all
+	int error; //the errno of opening the first counter that could not be opened, 0 if all of them were opened
+};
+
+//opens the counters of all the events, they are stopped and zero
+//counters: pointer to the counters
+//returns: the number of events that can be counted, 0 if none can, which is not an error
+int openPerfCounters(PerfCounters* counters);
+
+//starts all the counters that are open
+//counters: pointer to the counters
+void startPerfCounters(PerfCounters* counters);
+
+//stops all the counters that are open, they keep their counts
+//counters: pointer to the counters
+void stopPerfCounters(PerfCounters* counters);
+
+//reads the counts of all the events
+//counters: pointer to the counters
+//counts: pointer to the structure where the counts are saved
+void readPerfCounters(PerfCounters* counters, PerfCounts* counts);
+
+//divides all the counts, for getting the counts per operation
+//counts: pointer to the counts
+//divisor: the number the counts are divided by, greater than 0
+void scalePerfCounts(PerfCounts* counts, double divisor);
+
+//closes all the counters
+//counters: pointer to the counters
+void closePerfCounters(PerfCounters* counters);
+
+//returns the name of an event as it is printed
+//event: the event
+//returns: the name of the event
+const char* perfEventName(PerfEvent event);
+
+//returns the name of an event as it is used for a column of a report
+//event: the event
+//returns: the name of the column, in lower case with underscores
+const char* perfEventColumn(PerfEvent event);
+
+#endif
@@ -0,0 +1,481 @@
+#include <stdlib.h>
+
+#include "perfecthash.h"
+
+#define PERFECT_DENSE_KEYS 2576980378u //60% of 2^32, the keys whose high hash bits are below it go into the dense buckets
+#define PERFECT_SEED_STEP 0x9e3779b97f4a7c15ull //the distance between the seeds, 2^64 divided by the golden ratio
+#define PERFECT_PILOT_STEP 0xc2b2ae3d27d4eb4full //the multiplier spreading the pilots over the bits of the hash
+#define PERFECT_MAX_PILOT 0xffffu //the largest pilot, pilots are 16 bits, the build gives up on a seed that needs a larger one
+
+//a key together with its hash, sorted by bucket during the build
+typedef struct PerfectItem PerfectItem;
+struct PerfectItem
+{
+	unsigned long long hash; //the hash of the key
+	int key; //the key
+};
+
+//the finalizer of the 64-bit murmur3 hash, every bit of the input affects every bit of the result
+//it is a bijection, so distinct inputs never get the same hash
+//x: the input
+//returns: the mixed input
+static inline unsigned long long mix64(unsigned long long x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+
+	return x;
+}
+
+//maps a 64-bit hash onto the range from 0 to n - 1 with a multiplication instead of a division
+//hash: the hash
+//n: the size of the range
+//returns: the index in the range
+static inline unsigned int reduce64(unsigned long long hash, unsigned int n)
+{
+	return (unsigned int)(((unsigned __int128)hash * n) >> 64);
+}
+
+//computes the hash of a key, distinct keys get distinct hashes
+//key: the key
+//seed: the seed of the hash
+//returns: the hash of the key
+static inline unsigned long long perfectHash(int key, unsigned long long seed)
+{
+	return mix64((unsigned long long)(unsigned int)key + seed);
+}
+
+//computes the bucket of a key from its hash
+//the high 32 bits select whether the key goes into the dense or the sparse buckets, the low 32 bits select the bucket
+//hash: the hash of the key
+//numBuckets: the number of buckets
+//numDense: the number of dense buckets
+//returns: the index of the bucket
+static inline unsigned int perfectBucket(unsigned long long hash, unsigned int numBuckets, unsigned int numDense)
+{
+	unsigned int low = (unsigned int)hash;
+	if ((unsigned int)(hash >> 32) < PERFECT_DENSE_KEYS || numDense == numBuckets)
+	{
+		return (unsigned int)(((unsigned long long)low * numDense) >> 32);
+	}
+
+	return numDense + (unsigned int)(((unsigned long long)low * (numBuckets - numDense)) >> 32);
+}
+
+//computes the slot of a key from its hash and the pilot of its bucket
+//hash: the hash of the key
+//pilot: the pilot of the bucket of the key
+//size: the number of slots
+//returns: the index of the slot
+static inline unsigned int perfectPosition(unsigned long long hash, unsigned int pilot, unsigned int size)
+{
+	return reduce64(mix64(hash ^ (pilot * PERFECT_PILOT_STEP)), size);
+}
+
+//compares the hashes of two items for qsort
+//a, b: pointers to the items
+//returns: negative, zero or positive as the hash of a is less than, equal to or greater than the hash of b
+static int compareItems(const void* a, const void* b)
+{
+	unsigned long long x = ((const PerfectItem*)a)->hash;
+	unsigned long long y = ((const PerfectItem*)b)->hash;
+
+	return (x > y) - (x < y);
+}
+
+void initPerfect(PerfectHash* table)
+{
+	table->pilots = NULL;
+	table->keys = NULL;
+	table->freeSlots = NULL;
+	table->size = 0;
+	table->numPositions = 0;
+	table->numBuckets = 0;
+	table->numDenseBuckets = 0;
+	table->seed = 0;
+	table->numSeeds = 0;
+	table->maxPilot = 0;
+	table->numPilotTries = 0;
+	table->numDuplicates = 0;
+}
+
+//the memory of one build
+typedef struct PerfectBuild PerfectBuild;
+struct PerfectBuild
+{
+	PerfectItem* items; //the keys and their hashes, sorted by bucket and within a bucket by hash
+	int* bucketStarts; //the index of the first item of every bucket, and the number of items after the last bucket
+	int* order; //the buckets from the largest to the smallest
+	unsigned long long* taken; //one bit per position, set for the positions that are taken
+	unsigned int* positions; //the positions of the items of the bucket that is being placed
+	int maxSize; //the number of items of the largest bucket
+};
+
+//frees the memory of one build
+//build: pointer to the memory of the build
+static void deletePerfectBuild(PerfectBuild* build)
+{
+	free(build->items);
+	free(build->bucketStarts);
+	free(build->order);
+	free(build->taken);
+	free(build->positions);
+}
+
+//returns the number of positions for a number of keys
+//count: the number of keys
+//returns: the number of positions
+static int perfectPositions(int count)
+{
+	return count + (count + PERFECT_SLACK - 1) / PERFECT_SLACK;
+}
+
+//sets the number of buckets of the table for a number of keys
+//about PERFECT_BUCKET_FACTOR / log2(n) buckets per key, the dense buckets are 30% of them
+//table: pointer to the table
+//count: the number of keys, greater than 0
+static void setPerfectBuckets(PerfectHash* table, int count)
+{
+	int bits = 32 - __builtin_clz((unsigned int)count);
+	long long numBuckets = ((long long)PERFECT_BUCKET_FACTOR * count + bits - 1) / bits;
+	table->numBuckets = (int)(numBuckets < count ? numBuckets : count);
+	table->numDenseBuckets = table->numBuckets > 1 ? (int)((3LL * table->numBuckets + 9) / 10) : 1;
+}
+
+//hashes the keys with the seed of the table and sorts them by bucket, a key that is repeated is kept once
+//the number of distinct keys is saved as the size of the table, and the number of positions is set for them
+//table: pointer to the table with the number of buckets and the seed set
+//build: pointer to the memory of the build, allocated for count keys
+//keys: the keys
+//count: the number of keys
+static void bucketPerfectItems(PerfectHash* table, PerfectBuild* build, const int* keys, int count)
+{
+	unsigned int numBuckets = (unsigned int)table->numBuckets;
+	unsigned int numDense = (unsigned int)table->numDenseBuckets;
+	int* starts = build->bucketStarts;
+
+	//sort the keys by bucket with a counting sort, the order array counts the items written into every bucket
+	for (unsigned int b = 0; b <= numBuckets; ++b)
+	{
+		starts[b] = 0;
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		starts[perfectBucket(perfectHash(keys[i], table->seed), numBuckets, numDense) + 1]++;
+	}
+	for (unsigned int b = 0; b < numBuckets; ++b)
+	{
+		starts[b + 1] += starts[b];
+		build->order[b] = 0;
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		unsigned long long hash = perfectHash(keys[i], table->seed);
+		unsigned int b = perfectBucket(hash, numBuckets, numDense);
+		PerfectItem* item = &build->items[starts[b] + build->order[b]++];
+		item->hash = hash;
+		item->key = keys[i];
+	}
+
+	//a repeated key has the same hash and so the same bucket, sort every bucket by hash and keep one item per hash
+	int numItems = 0;
+	int maxSize = 0;
+	for (unsigned int b = 0; b < numBuckets; ++b)
+	{
+		int start = starts[b];
+		int end = starts[b + 1];
+		if (end - start > 1)
+		{
+			qsort(&build->items[start], (size_t)(end - start), sizeof(PerfectItem), compareItems);
+		}
+
+		starts[b] = numItems;
+		for (int i = start; i < end; ++i)
+		{
+			if (i == start || build->items[i].hash != build->items[i - 1].hash)
+			{
+				build->items[numItems++] = build->items[i];
+			}
+		}
+		if (numItems - starts[b] > maxSize)
+		{
+			maxSize = numItems - starts[b];
+		}
+	}
+	starts[numBuckets] = numItems;
+	table->size = numItems;
+	table->numPositions = perfectPositions(numItems);
+	build->maxSize = maxSize;
+}
+
+//places the buckets of the items sorted by bucketPerfectItems, moves the positions above the size to free slots and writes the verification array
+//table: pointer to the table, its pilots, free slots and keys are allocated
+//build: pointer to the memory of the build with the sorted items
+//returns: 1 on success, 0 if a bucket could not be placed with this seed, -1 if it was not possible to allocate the memory
+static int placePerfectBuckets(PerfectHash* table, PerfectBuild* build)
+{
+	unsigned int numBuckets = (unsigned int)table->numBuckets;
+	unsigned int numDense = (unsigned int)table->numDenseBuckets;
+	int* starts = build->bucketStarts;
+	int numItems = table->size;
+	int maxSize = build->maxSize;
+
+	//order the buckets from the largest to the smallest with a counting sort by size
+	int* sizeStarts = (int*)calloc((size_t)maxSize + 2, sizeof(int));
+	unsigned int* positions = (unsigned int*)realloc(build->positions, ((size_t)maxSize + 1) * sizeof(unsigned int));
+	if (sizeStarts == NULL || positions == NULL)
+	{
+		free(sizeStarts);
+		build->positions = positions != NULL ? positions : build->positions;
+		return -1;
+	}
+	build->positions = positions;
+
+	for (unsigned int b = 0; b < numBuckets; ++b)
+	{
+		sizeStarts[maxSize - (starts[b + 1] - starts[b]) + 1]++;
+	}
+	for (int s = 0; s <= maxSize; ++s)
+	{
+		sizeStarts[s + 1] += sizeStarts[s];
+	}
+	for (unsigned int b = 0; b < numBuckets; ++b)
+	{
+		build->order[sizeStarts[maxSize - (starts[b + 1] - starts[b])]++] = (int)b;
+	}
+	free(sizeStarts);
+
+	//place the buckets, every one with the smallest pilot that sends its items to positions that are free
+	unsigned int size = (unsigned int)numItems;
+	unsigned int numPositions = (unsigned int)table->numPositions;
+	size_t numWords = (numPositions + 63) / 64;
+	for (size_t w = 0; w < numWords; ++w)
+	{
+		build->taken[w] = 0;
+	}
+	table->maxPilot = 0;
+	table->numPilotTries = 0;
+
+	for (unsigned int o = 0; o < numBuckets; ++o)
+	{
+		int b = build->order[o];
+		int start = starts[b];
+		int bucketSize = starts[b + 1] - start;
+		table->pilots[b] = 0;
+
+		//an empty bucket keeps the pilot 0
+		if (bucketSize == 0)
+		{
+			continue;
+		}
+
+		unsigned int pilot = 0;
+		for (;; ++pilot)
+		{
+			if (pilot > PERFECT_MAX_PILOT)
+			{
+				return 0;
+			}
+			table->numPilotTries++;
+
+			int placed = 1;
+			for (int i = 0; i < bucketSize && placed; ++i)
+			{
+				unsigned int position = perfectPosition(build->items[start + i].hash, pilot, numPositions);
+				if (build->taken[position / 64] & (1ull << (position % 64)))
+				{
+					placed = 0;
+				}
+
+				//two items of the bucket must not take the same position either
+				for (int j = 0; j < i && placed; ++j)
+				{
+					if (positions[j] == position)
+					{
+						placed = 0;
+					}
+				}
+				positions[i] = position;
+			}
+
+			if (placed)
+			{
+				break;
+			}
+		}
+
+		for (int i = 0; i < bucketSize; ++i)
+		{
+			build->taken[positions[i] / 64] |= 1ull << (positions[i] % 64);
+		}
+		table->pilots[b] = (unsigned short)pilot;
+		if (pilot > table->maxPilot)
+		{
+			table->maxPilot = pilot;
+		}
+	}
+
+	//there are as many taken positions from the size up as there are free slots below it, pair them in order
+	unsigned int freeSlot = 0;
+	for (unsigned int position = size; position < numPositions; ++position)
+	{
+		table->freeSlots[position - size] = 0;
+		if (build->taken[position / 64] & (1ull << (position % 64)))
+		{
+			while (build->taken[freeSlot / 64] & (1ull << (freeSlot % 64)))
+			{
+				freeSlot++;
+			}
+			table->freeSlots[position - size] = freeSlot++;
+		}
+	}
+
+	//every item now has a slot of its own, write the verification array
+	for (int i = 0; i < numItems; ++i)
+	{
+		unsigned int b = perfectBucket(build->items[i].hash, numBuckets, numDense);
+		unsigned int position = perfectPosition(build->items[i].hash, table->pilots[b], numPositions);
+		table->keys[position < size ? position : table->freeSlots[position - size]] = build->items[i].key;
+	}
+
+	return 1;
+}
+
+int buildPerfect(PerfectHash* table, const int* keys, int count)
+{
+	deletePerfect(table);
+	if (count <= 0)
+	{
+		return 0;
+	}
+
+	setPerfectBuckets(table, count);
+
+	PerfectBuild build;
+	build.items = (PerfectItem*)malloc((size_t)count * sizeof(PerfectItem));
+	build.bucketStarts = (int*)malloc(((size_t)table->numBuckets + 1) * sizeof(int));
+	build.order = (int*)malloc((size_t)table->numBuckets * sizeof(int));
+	build.taken = (unsigned long long*)malloc(((size_t)perfectPositions(count) + 63) / 64 * sizeof(unsigned long long));
+	build.positions = NULL;
+	table->pilots = (unsigned short*)malloc((size_t)table->numBuckets * sizeof(unsigned short));
+	table->keys = (int*)malloc((size_t)count * sizeof(int));
+	table->freeSlots = (unsigned int*)malloc(((size_t)perfectPositions(count) - count) * sizeof(unsigned int));
+	if (build.items == NULL || build.bucketStarts == NULL || build.order == NULL || build.taken == NULL || table->pilots == NULL || table->keys == NULL ||
+		table->freeSlots == NULL)
+	{
+		deletePerfectBuild(&build);
+		deletePerfect(table);
+		return -1;
+	}
+
+	//with the first seed, the repeated keys are found
+	table->numSeeds = 1;
+	table->seed = PERFECT_SEED_STEP;
+	bucketPerfectItems(table, &build, keys, count);
+	int numKeys = table->size;
+	table->numDuplicates = count - numKeys;
+
+	//the number of buckets depends on the number of distinct keys, bucket them again without the repeated ones
+	int* distinctKeys = NULL;
+	if (numKeys < count)
+	{
+		distinctKeys = (int*)malloc((size_t)numKeys * sizeof(int));
+		if (distinctKeys == NULL)
+		{
+			deletePerfectBuild(&build);
+			deletePerfect(table);
+			return -1;
+		}
+		for (int i = 0; i < numKeys; ++i)
+		{
+			distinctKeys[i] = build.items[i].key;
+		}
+
+		//fewer keys can have more buckets, since the divisor log2 of the number of keys can shrink by one,
+		//so the arrays with one entry per bucket are allocated again when they are too small
+		int allocatedBuckets = table->numBuckets;
+		setPerfectBuckets(table, numKeys);
+		if (table->numBuckets > allocatedBuckets)
+		{
+			free(build.bucketStarts);
+			free(build.order);
+			free(table->pilots);
+			build.bucketStarts = (int*)malloc(((size_t)table->numBuckets + 1) * sizeof(int));
+			build.order = (int*)malloc((size_t)table->numBuckets * sizeof(int));
+			table->pilots = (unsigned short*)malloc((size_t)table->numBuckets * sizeof(unsigned short));
+			if (build.bucketStarts == NULL || build.order == NULL || table->pilots == NULL)
+			{
+				free(distinctKeys);
+				deletePerfectBuild(&build);
+				deletePerfect(table);
+				return -1;
+			}
+		}
+		bucketPerfectItems(table, &build, distinctKeys, numKeys);
+		keys = distinctKeys;
+	}
+
+	//try the seeds until all the buckets can be placed
+	int result = placePerfectBuckets(table, &build);
+	while (result == 0 && table->numSeeds < PERFECT_MAX_SEEDS)
+	{
+		table->numSeeds++;
+		table->seed = (unsigned long long)table->numSeeds * PERFECT_SEED_STEP;
+		bucketPerfectItems(table, &build, keys, numKeys);
+		result = placePerfectBuckets(table, &build);
+	}
+	deletePerfectBuild(&build);
+	free(distinctKeys);
+
+	if (result != 1)
+	{
+		deletePerfect(table);
+		return -1;
+	}
+
+	//the verification array holds only the distinct keys
+	if (table->size < count)
+	{
+		int* keysArray = (int*)realloc(table->keys, (size_t)table->size * sizeof(int));
+		table->keys = keysArray != NULL ? keysArray : table->keys;
+	}
+
+	return 0;
+}
+
+int searchPerfect(const PerfectHash* table, int key)
+{
+	if (table->size == 0)
+	{
+		return -1;
+	}
+
+	//one pilot and one slot are read, and the free slot of the few positions above the size
+	unsigned long long hash = perfectHash(key, table->seed);
+	unsigned int pilot = table->pilots[perfectBucket(hash, (unsigned int)table->numBuckets, (unsigned int)table->numDenseBuckets)];
+	unsigned int position = perfectPosition(hash, pilot, (unsigned int)table->numPositions);
+	if (position >= (unsigned int)table->size)
+	{
+		position = table->freeSlots[position - (unsigned int)table->size];
+	}
+
+	return table->keys[position] == key ? (int)position : -1;
+}
+
+void perfectMemory(const PerfectHash* table, long long* pilotBytes, long long* keyBytes)
+{
+	*pilotBytes = (long long)table->numBuckets * (long long)sizeof(unsigned short) +
+		((long long)table->numPositions - table->size) * (long long)sizeof(unsigned int);
+	*keyBytes = (long long)table->size * (long long)sizeof(int);
+}
+
+void deletePerfect(PerfectHash* table)
+{
+	free(table->pilots);
+	free(table->keys);
+	free(table->freeSlots);
+	initPerfect(table);
+}
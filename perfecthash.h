@@ -0,0 +1,67 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+//static minimal perfect hash over a set of keys that doesn't change after it is built, in the style of PTHash
+//the keys are hashed into buckets, about PERFECT_BUCKET_FACTOR * n / log2(n) of them, and 60% of the keys go into 30% of the buckets,
+//so the buckets are uneven; the buckets are placed from the largest to the smallest, and every bucket gets the smallest pilot
+//that sends all of its keys to positions no other key has taken, the position of a key being its hash mixed with the pilot of its bucket
+//the positions range over 1% more than n, because finding free positions for the last buckets in a range of exactly n takes
+//about n tries each; the few keys at positions n and above are moved to the free slots below n through a small table,
+//so the table still has exactly one slot per distinct key and holds the key itself there
+//a lookup reads the pilot of its bucket and one slot, and compares the key in the slot with the searched one to reject keys that were not stored
+
+//the number of buckets per key is PERFECT_BUCKET_FACTOR / log2(n), more buckets build faster but take more memory
+#define PERFECT_BUCKET_FACTOR 5
+
+//the positions range over n + n / PERFECT_SLACK
+#define PERFECT_SLACK 99
+
+//the number of seeds of the hash of the keys that are tried before the build fails
+#define PERFECT_MAX_SEEDS 16
+
+//the minimal perfect hash table
+typedef struct PerfectHash PerfectHash;
+struct PerfectHash
+{
+	unsigned short* pilots; //array of the pilots of the buckets
+	int* keys; //the verification array, slot i holds the key whose position is i
+	unsigned int* freeSlots; //the slots below size the positions from size up to numPositions are moved to
+	int size; //the number of slots, which is the number of distinct keys
+	int numPositions; //the number of positions the keys are hashed to, at least size
+	int numBuckets; //the number of buckets
+	int numDenseBuckets; //the number of buckets the 60% of the keys are hashed into, the first buckets of the array
+	unsigned long long seed; //the seed of the hash of the keys
+	int numSeeds; //the number of seeds the last build tried, the last one succeeded
+	unsigned int maxPilot; //the largest pilot
+	long long numPilotTries; //the number of pilots tried by the last build over all the buckets
+	int numDuplicates; //the number of keys that were given more than once and are stored once
+};
+
+//initializes an empty minimal perfect hash table
+//table: pointer to the table
+void initPerfect(PerfectHash* table);
+
+//builds the minimal perfect hash table over a set of keys, the previous contents of the table are freed
+//table: pointer to the table
+//keys: the keys, repeated keys are stored once
+//count: the number of keys
+//returns: 0 on success, -1 if it was not possible to allocate the memory or no seed led to a perfect hash
+int buildPerfect(PerfectHash* table, const int* keys, int count);
+
+//searches for a key in the minimal perfect hash table
+//table: pointer to the table
+//key: the key to search for
+//returns: the index of the slot where the key was found, -1 if it was not found
+int searchPerfect(const PerfectHash* table, int key);
+
+//returns the memory used by the table
+//table: pointer to the table
+//pilotBytes: the number of bytes of the pilots and of the moved positions, which are the perfect hash function itself, is saved here
+//keyBytes: the number of bytes of the verification array is saved here
+void perfectMemory(const PerfectHash* table, long long* pilotBytes, long long* keyBytes);
+
+//frees the dynamically allocated memory associated with the minimal perfect hash table
+//table: pointer to the table
+void deletePerfect(PerfectHash* table);
+
+#endif
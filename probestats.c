@@ -0,0 +1,213 @@
+#include "probestats.h"
+
+//returns the bucket of a probe length
+//length: the probe length, at least 1
+//returns: the index of the bucket
+static int probeBucket(int length)
+{
+	if (length <= PROBE_EXACT_BUCKETS)
+	{
+		return length - 1;
+	}
+
+	//the lengths above 2^(k-1) up to 2^k share a bucket
+	int bits = 32 - __builtin_clz((unsigned int)(length - 1));
+
+	return PROBE_EXACT_BUCKETS + bits - 4;
+}
+
+void initProbeHistogram(ProbeHistogram* histogram)
+{
+	for (int i = 0; i < PROBE_HISTOGRAM_BUCKETS; ++i)
+	{
+		histogram->counts[i] = 0;
+	}
+	histogram->numRecorded = 0;
+	histogram->total = 0;
+	histogram->max = 0;
+}
+
+void recordProbeLength(ProbeHistogram* histogram, int length)
+{
+	histogram->counts[probeBucket(length)]++;
+	histogram->numRecorded++;
+	histogram->total += length;
+	if (length > histogram->max)
+	{
+		histogram->max = length;
+	}
+}
+
+void probeBucketRange(int bucket, long long* low, long long* high)
+{
+	if (bucket < PROBE_EXACT_BUCKETS)
+	{
+		*low = bucket + 1;
+		*high = bucket + 1;
+		return;
+	}
+
+	int bits = bucket - PROBE_EXACT_BUCKETS + 4;
+	*low = (1LL << (bits - 1)) + 1;
+	*high = 1LL << bits;
+}
+
+void initProbeStats(ProbeStats* stats, int size)
+{
+	stats->size = size;
+	stats->numOccupied = 0;
+	initProbeHistogram(&stats->stored);
+	initProbeHistogram(&stats->hits);
+	initProbeHistogram(&stats->misses);
+	stats->numRuns = 0;
+	stats->maxRun = 0;
+}
+
+void recordProbeRun(ProbeStats* stats, int length)
+{
+	stats->numRuns++;
+	if (length > stats->maxRun)
+	{
+		stats->maxRun = length;
+	}
+}
+
+//returns the mean probe length of a histogram
+//histogram: pointer to the histogram
+//returns: the mean, 0 if nothing was recorded
+static double meanProbeLength(const ProbeHistogram* histogram)
+{
+	return histogram->numRecorded > 0 ? (double)histogram->total / histogram->numRecorded : 0.0;
+}
+
+//returns the clustering of the occupied entries: the mean length of their runs divided by the mean length
+//the runs would have if the same number of entries were occupied at random, which is 1 / (1 - load factor)
+//stats: pointer to the telemetry
+//returns: the clustering, 1 for randomly placed entries and more the more they cluster, 0 if there is no run or no empty entry
+static double probeClustering(const ProbeStats* stats)
+{
+	if (stats->numRuns == 0 || stats->numOccupied >= stats->size)
+	{
+		return 0.0;
+	}
+
+	double meanRun = (double)stats->numOccupied / stats->numRuns;
+	double load = (double)stats->numOccupied / stats->size;
+
+	return meanRun * (1.0 - load);
+}
+
+void printProbeStats(const ProbeStats* stats)
+{
+	printf("\nProbe details:\n\n");
+
+	printf("  Load factor: %.3f (%d of %d entries occupied)\n", stats->size > 0 ? (double)stats->numOccupied / stats->size : 0.0,
+		stats->numOccupied, stats->size);
+	printf("  Displacement of the stored items (probes past the home index): mean %.3f, maximum %d\n",
+		stats->stored.numRecorded > 0 ? meanProbeLength(&stats->stored) - 1.0 : 0.0, stats->stored.max > 0 ? stats->stored.max - 1 : 0);
+	printf("  Probe length of %lld searches of found items: mean %.3f, maximum %d\n", stats->hits.numRecorded, meanProbeLength(&stats->hits),
+		stats->hits.max);
+	printf("  Probe length of %lld searches of items not found: mean %.3f, maximum %d\n", stats->misses.numRecorded,
+		meanProbeLength(&stats->misses), stats->misses.max);
+	if (stats->numOccupied >= stats->size)
+	{
+		printf("  Occupied runs: the table is full\n");
+	}
+	else if (stats->numRuns > 0)
+	{
+		printf("  Occupied runs: %lld, mean length %.3f, longest %d, clustering %.3f (1 for randomly placed items)\n", stats->numRuns,
+			(double)stats->numOccupied / stats->numRuns, stats->maxRun, probeClustering(stats));
+	}
+
+	//the buckets from the first to the last one used by any histogram
+	int first = PROBE_HISTOGRAM_BUCKETS;
+	int last = -1;
+	for (int i = 0; i < PROBE_HISTOGRAM_BUCKETS; ++i)
+	{
+		if (stats->stored.counts[i] > 0 || stats->hits.counts[i] > 0 || stats->misses.counts[i] > 0)
+		{
+			first = i < first ? i : first;
+			last = i;
+		}
+	}
+
+	if (last == -1)
+	{
+		return;
+	}
+
+	printf("  Probe length histogram:\n");
+	printf("  %15s %15s %15s %15s\n", "probes", "stored", "found", "not found");
+	for (int i = first; i <= last; ++i)
+	{
+		long long low;
+		long long high;
+		probeBucketRange(i, &low, &high);
+
+		char range[32];
+		if (low == high)
+		{
+			snprintf(range, sizeof(range), "%lld", low);
+		}
+		else
+		{
+			snprintf(range, sizeof(range), "%lld-%lld", low, high);
+		}
+
+		printf("  %15s %15lld %15lld %15lld\n", range, stats->stored.counts[i], stats->hits.counts[i], stats->misses.counts[i]);
+	}
+}
+
+//writes a histogram as a JSON object
+//file: the file
+//histogram: pointer to the histogram
+static void writeProbeHistogramJson(FILE* file, const ProbeHistogram* histogram)
+{
+	fprintf(file, "{\"count\":%lld,\"mean\":%.6f,\"max\":%d,\"buckets\":[", histogram->numRecorded, meanProbeLength(histogram), histogram->max);
+
+	//only the buckets that were used, each with its range of probe lengths
+	int separator = 0;
+	for (int i = 0; i < PROBE_HISTOGRAM_BUCKETS; ++i)
+	{
+		if (histogram->counts[i] == 0)
+		{
+			continue;
+		}
+
+		long long low;
+		long long high;
+		probeBucketRange(i, &low, &high);
+		fprintf(file, "%s{\"low\":%lld,\"high\":%lld,\"count\":%lld}", separator ? "," : "", low, high, histogram->counts[i]);
+		separator = 1;
+	}
+
+	fprintf(file, "]}");
+}
+
+int writeProbeStatsJson(const ProbeStats* stats, const char* fileName)
+{
+	FILE* file = fopen(fileName, "w");
+	if (file == NULL)
+	{
+		printf("Error: cannot open file %s!\n", fileName);
+		return -1;
+	}
+
+	fprintf(file, "{\"size\":%d,\"occupied\":%d,\"load_factor\":%.6f,", stats->size, stats->numOccupied,
+		stats->size > 0 ? (double)stats->numOccupied / stats->size : 0.0);
+	fprintf(file, "\"stored\":");
+	writeProbeHistogramJson(file, &stats->stored);
+	fprintf(file, ",\"hits\":");
+	writeProbeHistogramJson(file, &stats->hits);
+	fprintf(file, ",\"misses\":");
+	writeProbeHistogramJson(file, &stats->misses);
+	fprintf(file, ",\"runs\":%lld,\"max_run\":%d,\"clustering\":%.6f}\n", stats->numRuns, stats->maxRun, probeClustering(stats));
+
+	if (fclose(file) != 0)
+	{
+		printf("Error: cannot write file %s!\n", fileName);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+#ifndef PROBESTATS_H
+#define PROBESTATS_H
+
+#include <stdio.h>
+
+//telemetry of the probing of a hash table: how many entries a lookup reads and how the occupied entries cluster
+//the probe lengths are collected into histograms whose buckets are exact for short probes and double in width for long ones,
+//so a histogram has a fixed size however long the probes get
+
+//the number of probe lengths that have a bucket of their own, from 1 up to this number
+#define PROBE_EXACT_BUCKETS 8
+
+//the number of buckets of a histogram: the exact ones, then one for the lengths up to every power of two up to 2^31
+#define PROBE_HISTOGRAM_BUCKETS (PROBE_EXACT_BUCKETS + 28)
+
+//histogram of probe lengths, a probe length is the number of entries a lookup read, at least 1
+typedef struct ProbeHistogram ProbeHistogram;
+struct ProbeHistogram
+{
+	long long counts[PROBE_HISTOGRAM_BUCKETS]; //the number of lookups in every bucket
+	long long numRecorded; //the number of recorded lookups
+	long long total; //the sum of the recorded probe lengths
+	int max; //the longest recorded probe length, 0 if nothing was recorded
+};
+
+//the telemetry of a hash table and of the lookups of the searched elements
+typedef struct ProbeStats ProbeStats;
+struct ProbeStats
+{
+	int size; //the size of the array of entries
+	int numOccupied; //the number of occupied entries
+	ProbeHistogram stored; //the probe lengths of looking up every stored key, the displacement of a key is its probe length minus 1
+	ProbeHistogram hits; //the probe lengths of the searched elements that were found
+	ProbeHistogram misses; //the probe lengths of the searched elements that were not found, including the empty entry that ended them
+	long long numRuns; //the number of runs of consecutive occupied entries, the array wraps around
+	int maxRun; //the length of the longest run
+};
+
+//empties a histogram
+//histogram: pointer to the histogram
+void initProbeHistogram(ProbeHistogram* histogram);
+
+//records the probe length of one lookup
+//histogram: pointer to the histogram
+//length: the number of entries the lookup read, at least 1
+void recordProbeLength(ProbeHistogram* histogram, int length);
+
+//returns the range of probe lengths of a bucket
+//bucket: the index of the bucket
+//low: the shortest probe length of the bucket is saved here
+//high: the longest probe length of the bucket is saved here
+void probeBucketRange(int bucket, long long* low, long long* high);
+
+//empties the telemetry
+//stats: pointer to the telemetry
+//size: the size of the array of entries
+void initProbeStats(ProbeStats* stats, int size);
+
+//records one run of consecutive occupied entries
+//stats: pointer to the telemetry
+//length: the number of entries of the run
+void recordProbeRun(ProbeStats* stats, int length);
+
+//prints the telemetry as a section of the statistics
+//stats: pointer to the telemetry
+void printProbeStats(const ProbeStats* stats);
+
+//writes the telemetry into a file as one JSON object, the file is overwritten
+//stats: pointer to the telemetry
+//fileName: the path to the file
+//returns: 0 on success, -1 if the file could not be written
+int writeProbeStatsJson(const ProbeStats* stats, const char* fileName);
+
+#endif
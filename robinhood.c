@@ -0,0 +1,276 @@
+#include <stdlib.h>
+
+#include "robinhood.h"
+
+//computes the home index of a key
+//table: pointer to the robin hood table
+//key: the key
+//returns: the home index of the key
+static unsigned int homeIndex(const RobinHoodTable* table, int key)
+{
+	switch (table->hashFunction)
+	{
+	case HASH_FIBONACCI:
+		return reduceHash(hashFibonacci(key), table->size);
+	case HASH_MURMUR:
+		return reduceHash(hashMurmur(key), table->size);
+	default:
+	{
+		int index = key % table->size;
+		return (unsigned int)(index < 0 ? index + table->size : index);
+	}
+	}
+}
+
+//allocates an array of entries and sets all of them to empty
+//size: the number of entries
+//returns: pointer to the array, NULL if it was not possible to allocate the memory
+static RobinHoodEntry* allocateEntries(int size)
+{
+	RobinHoodEntry* array = (RobinHoodEntry*)malloc((size_t)size * sizeof(RobinHoodEntry));
+	if (array == NULL)
+	{
+		return NULL;
+	}
+
+	for (int i = 0; i < size; ++i)
+	{
+		array[i].distance = -1;
+	}
+
+	return array;
+}
+
+//places a key with robin hood insertion, the table must have an empty entry
+//the probe passes every entry the key could be stored in before it displaces a key, so a key already in the table is found there and kept once
+//table: pointer to the robin hood table
+//key: the key to place
+//returns: the index where the key was placed or found
+static int placeKey(RobinHoodTable* table, int key)
+{
+	unsigned int index = homeIndex(table, key);
+	int distance = 0;
+	int placedIndex = -1;
+
+	while (1)
+	{
+		RobinHoodEntry* entry = &table->array[index];
+
+		if (entry->distance == -1)
+		{
+			entry->key = key;
+			entry->distance = distance;
+			table->numOccupied++;
+			return placedIndex == -1 ? (int)index : placedIndex;
+		}
+
+		if (placedIndex == -1 && entry->key == key)
+		{
+			table->numDuplicates++;
+			return (int)index;
+		}
+
+		//the key in the entry is closer to its home than the key being placed, take its entry and continue placing it
+		if (entry->distance < distance)
+		{
+			int displacedKey = entry->key;
+			int displacedDistance = entry->distance;
+			entry->key = key;
+			entry->distance = distance;
+			key = displacedKey;
+			distance = displacedDistance;
+
+			if (placedIndex == -1)
+			{
+				placedIndex = (int)index;
+			}
+			table->numDisplacements++;
+		}
+
+		distance++;
+		index++;
+		if (index == (unsigned int)table->size)
+		{
+			index = 0;
+		}
+	}
+}
+
+//doubles the size of the robin hood table and places all the keys again
+//table: pointer to the robin hood table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+static int growRobinHood(RobinHoodTable* table)
+{
+	if (table->size > 0x7fffffff / 2)
+	{
+		return -1;
+	}
+
+	RobinHoodEntry* oldArray = table->array;
+	int oldSize = table->size;
+
+	table->array = allocateEntries(2 * oldSize);
+	if (table->array == NULL)
+	{
+		table->array = oldArray;
+		return -1;
+	}
+	table->size = 2 * oldSize;
+
+	//displacements while moving the keys are not counted, they are not caused by inserts
+	long long numDisplacements = table->numDisplacements;
+	table->numOccupied = 0;
+	for (int i = 0; i < oldSize; ++i)
+	{
+		if (oldArray[i].distance != -1)
+		{
+			placeKey(table, oldArray[i].key);
+		}
+	}
+	table->numDisplacements = numDisplacements;
+
+	free(oldArray);
+	table->numGrowths++;
+
+	return 0;
+}
+
+int initRobinHood(RobinHoodTable* table, int size, double maxLoad, HashFunction hashFunction)
+{
+	table->array = allocateEntries(size);
+	table->size = size;
+	table->numOccupied = 0;
+	table->initialSize = size;
+	table->maxLoad = maxLoad;
+	table->hashFunction = hashFunction;
+	table->numGrowths = 0;
+	table->numDisplacements = 0;
+	table->numDeleted = 0;
+	table->numDuplicates = 0;
+
+	return table->array == NULL ? -1 : 0;
+}
+
+int resetRobinHood(RobinHoodTable* table)
+{
+	table->numOccupied = 0;
+	table->numGrowths = 0;
+	table->numDisplacements = 0;
+	table->numDeleted = 0;
+	table->numDuplicates = 0;
+
+	//if the table grew, go back to the initial size
+	if (table->size != table->initialSize)
+	{
+		free(table->array);
+		table->size = table->initialSize;
+		table->array = allocateEntries(table->size);
+
+		return table->array == NULL ? -1 : 0;
+	}
+
+	for (int i = 0; i < table->size; ++i)
+	{
+		table->array[i].distance = -1;
+	}
+
+	return 0;
+}
+
+int insertRobinHood(RobinHoodTable* table, int key)
+{
+	//grow the table if the insert would exceed the maximum load factor or fill the last empty entry
+	if ((table->numOccupied + 1 > table->maxLoad * table->size || table->numOccupied + 1 >= table->size) && growRobinHood(table) == -1)
+	{
+		return -1;
+	}
+
+	return placeKey(table, key);
+}
+
+int searchRobinHood(const RobinHoodTable* table, int key)
+{
+	unsigned int index = homeIndex(table, key);
+
+	for (int distance = 0; distance < table->size; ++distance)
+	{
+		const RobinHoodEntry* entry = &table->array[index];
+
+		//an empty entry, or a key closer to its home than the searched key would be here, means the searched key is not in the table
+		if (entry->distance < distance)
+		{
+			return -1;
+		}
+		else if (entry->key == key)
+		{
+			return (int)index;
+		}
+
+		index++;
+		if (index == (unsigned int)table->size)
+		{
+			index = 0;
+		}
+	}
+
+	return -1;
+}
+
+int deleteRobinHoodKey(RobinHoodTable* table, int key)
+{
+	int found = searchRobinHood(table, key);
+	if (found == -1)
+	{
+		return -1;
+	}
+
+	//shift the following entries back until an empty entry or a key at its home index
+	unsigned int index = (unsigned int)found;
+	while (1)
+	{
+		unsigned int next = index + 1 == (unsigned int)table->size ? 0 : index + 1;
+
+		if (table->array[next].distance <= 0)
+		{
+			table->array[index].distance = -1;
+			break;
+		}
+
+		table->array[index].key = table->array[next].key;
+		table->array[index].distance = table->array[next].distance - 1;
+		index = next;
+	}
+
+	table->numOccupied--;
+	table->numDeleted++;
+
+	return found;
+}
+
+void robinHoodDistances(const RobinHoodTable* table, double* meanDistance, int* maxDistance)
+{
+	long long totalDistance = 0;
+	*maxDistance = 0;
+
+	for (int i = 0; i < table->size; ++i)
+	{
+		if (table->array[i].distance != -1)
+		{
+			totalDistance += table->array[i].distance;
+			if (table->array[i].distance > *maxDistance)
+			{
+				*maxDistance = table->array[i].distance;
+			}
+		}
+	}
+
+	*meanDistance = table->numOccupied > 0 ? (double)totalDistance / table->numOccupied : 0.0;
+}
+
+void deleteRobinHood(RobinHoodTable* table)
+{
+	free(table->array);
+	table->array = NULL;
+	table->size = 0;
+	table->numOccupied = 0;
+}
@@ -0,0 +1,84 @@
+#ifndef ROBINHOOD_H
+#define ROBINHOOD_H
+
+#include "hashpolicy.h"
+
+//hash table with linear probing and robin hood insertion
+//every slot remembers how far its key is from the key's home index (its probe distance)
+//an insert that reaches a slot whose key is closer to home than the inserted key swaps the two keys and continues with the displaced one,
+//which keeps the probe distances even, so the longest probe stays short even at load factors above 90%
+//a lookup stops as soon as it reaches a slot whose key is closer to home than the searched key would be at that point,
+//and a delete shifts the following keys one slot back instead of leaving a tombstone
+
+//the maximum load factor the table grows at when no other is given: the probe distances stay short up to about 90%,
+//but the run of occupied slots a key can be pushed along grows without bound as the table fills its last empty slots
+#define ROBINHOOD_MAX_LOAD 0.9
+
+//entry in the robin hood table
+typedef struct RobinHoodEntry RobinHoodEntry;
+struct RobinHoodEntry
+{
+	int key; //the value of the stored element
+	int distance; //the distance of the entry from the home index of its key, -1 if the entry is empty
+};
+
+//the robin hood table
+typedef struct RobinHoodTable RobinHoodTable;
+struct RobinHoodTable
+{
+	RobinHoodEntry* array; //array of entries
+	int size; //the size of the array of entries
+	int numOccupied; //the number of entries that are occupied
+	int initialSize; //the size of the array when the table is (re)created
+	double maxLoad; //the maximum allowed ratio of occupied entries to the size of the array
+	HashFunction hashFunction; //the hash function giving the home index of a key
+	int numGrowths; //the number of times the table has grown since it was (re)created
+	long long numDisplacements; //the number of times an insert displaced a key closer to its home
+	int numDeleted; //the number of keys deleted since the table was (re)created
+	int numDuplicates; //the number of keys that were inserted again and are stored once
+};
+
+//initializes an empty robin hood table
+//table: pointer to the robin hood table
+//size: the initial size of the array of entries
+//maxLoad: the maximum allowed ratio of occupied entries to the size of the array, at least one entry is always kept empty
+//hashFunction: the hash function giving the home index of a key
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int initRobinHood(RobinHoodTable* table, int size, double maxLoad, HashFunction hashFunction);
+
+//empties the robin hood table and shrinks it back to its initial size
+//table: pointer to the robin hood table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int resetRobinHood(RobinHoodTable* table);
+
+//inserts a key into the robin hood table, the table doubles its size when the maximum load factor would be exceeded
+//a key that is already stored is not stored again
+//table: pointer to the robin hood table
+//key: the key to insert
+//returns: the index where the key was placed or found (later inserts may move it), -1 if it was not possible to allocate the memory
+int insertRobinHood(RobinHoodTable* table, int key);
+
+//searches for a key in the robin hood table
+//table: pointer to the robin hood table
+//key: the key to search for
+//returns: the index where the key was found, -1 if it was not found
+int searchRobinHood(const RobinHoodTable* table, int key);
+
+//deletes a key from the robin hood table using backward-shift deletion
+//the keys following the deleted one are moved one entry back until an empty entry or a key at its home index is reached
+//table: pointer to the robin hood table
+//key: the key to delete
+//returns: the index where the key was found, -1 if it was not in the table
+int deleteRobinHoodKey(RobinHoodTable* table, int key);
+
+//computes the probe distances of the keys currently in the table
+//table: pointer to the robin hood table
+//meanDistance: the mean distance of the keys from their home index is saved here
+//maxDistance: the largest distance of a key from its home index is saved here
+void robinHoodDistances(const RobinHoodTable* table, double* meanDistance, int* maxDistance);
+
+//frees the dynamically allocated memory associated with the robin hood table
+//table: pointer to the robin hood table
+void deleteRobinHood(RobinHoodTable* table);
+
+#endif
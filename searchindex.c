@@ -0,0 +1,576 @@
+#include <stdlib.h>
+#include <limits.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "searchindex.h"
+
+#define FORCE_INLINE static inline __attribute__((always_inline)) //for functions that are specialized by inlining them with constant arguments
+
+//allocates an array of ints aligned to a cache line
+//count: the number of ints
+//returns: pointer to the array, NULL if it was not possible to allocate the memory
+static int* allocateLines(size_t count)
+{
+	size_t bytes = (count + SEARCH_LINE_INTS - 1) / SEARCH_LINE_INTS * SEARCH_LINE_INTS * sizeof(int);
+
+	return (int*)aligned_alloc(SEARCH_LINE_INTS * sizeof(int), bytes);
+}
+
+//fills the subtree of a node of the Eytzinger order by an in-order walk, which visits the nodes in the order of the sorted array
+//index: pointer to the index
+//position: the index in the sorted array of the next value to place
+//node: the node whose subtree is filled
+//returns: the index in the sorted array of the next value to place after the subtree
+static int fillEytzinger(SearchIndex* index, int position, int node)
+{
+	if (node <= index->size)
+	{
+		position = fillEytzinger(index, position, 2 * node);
+		index->keys[node] = index->data[position];
+		index->ranks[node] = position;
+		position++;
+		position = fillEytzinger(index, position, 2 * node + 1);
+	}
+
+	return position;
+}
+
+//returns the child of a node of the S-tree
+//node: the node
+//i: the number of the child, from 0 to SEARCH_LINE_INTS
+//returns: the child
+static inline int sTreeChild(int node, int i)
+{
+	return node * (SEARCH_LINE_INTS + 1) + i + 1;
+}
+
+//fills the subtree of a node of the S-tree by an in-order walk, the values missing from the last nodes are padded with INT_MAX
+//index: pointer to the index
+//position: the index in the sorted array of the next value to place
+//node: the node whose subtree is filled
+//returns: the index in the sorted array of the next value to place after the subtree
+static int fillSTree(SearchIndex* index, int position, int node)
+{
+	if (node < index->numNodes)
+	{
+		for (int i = 0; i < SEARCH_LINE_INTS; ++i)
+		{
+			position = fillSTree(index, position, sTreeChild(node, i));
+			int slot = node * SEARCH_LINE_INTS + i;
+			if (position < index->size)
+			{
+				index->keys[slot] = index->data[position];
+				index->ranks[slot] = position;
+				position++;
+			}
+			else
+			{
+				index->keys[slot] = INT_MAX;
+				index->ranks[slot] = index->size;
+			}
+		}
+		position = fillSTree(index, position, sTreeChild(node, SEARCH_LINE_INTS));
+	}
+
+	return position;
+}
+
+//builds the segments of the learned model by a greedy pass over the distinct values of the array:
+//a segment starts at a value and keeps the range of slopes that predict the positions of all the values added to it within the error bound,
+//a value that would leave the range empty starts the next segment
+//index: pointer to the index, its segments are allocated with one segment per distinct value at most
+//returns: the number of segments
+static int fitSegments(SearchIndex* index)
+{
+	const int* data = index->data;
+	int numSegments = 0;
+	int start = 0;
+
+	while (start < index->size)
+	{
+		LearnedSegment* segment = &index->segments[numSegments++];
+		segment->key = data[start];
+		segment->rank = start;
+
+		double lowSlope = 0.0;
+		double highSlope = 1e300;
+		int i = start + 1;
+		while (i < index->size)
+		{
+			//skip the repeated values, only the first occurrence of a value must be predicted
+			if (data[i] == data[i - 1])
+			{
+				i++;
+				continue;
+			}
+
+			double distance = (double)data[i] - (double)segment->key;
+			double low = (i - start - LEARNED_ERROR_BOUND) / distance;
+			double high = (i - start + LEARNED_ERROR_BOUND) / distance;
+			if (low > highSlope || high < lowSlope)
+			{
+				break;
+			}
+			lowSlope = low > lowSlope ? low : lowSlope;
+			highSlope = high < highSlope ? high : highSlope;
+			i++;
+		}
+
+		segment->slope = highSlope == 1e300 ? 0.0 : (lowSlope + highSlope) / 2;
+		start = i;
+	}
+
+	return numSegments;
+}
+
+int buildSearchIndex(SearchIndex* index, SearchEngine engine, const int* data, int size)
+{
+	index->engine = engine;
+	index->data = data;
+	index->size = size;
+	index->keys = NULL;
+	index->ranks = NULL;
+	index->numNodes = 0;
+	index->height = 0;
+	index->segments = NULL;
+	index->numSegments = 0;
+	index->memory = 0;
+	index->counters.numSearches = 0;
+	index->counters.numProbes = 0;
+	index->counters.windowTotal = 0;
+
+	if (engine == SEARCH_EYTZINGER)
+	{
+		//node 0 is unused, so that the children of node k are 2k and 2k+1
+		index->keys = allocateLines((size_t)size + 1);
+		index->ranks = allocateLines((size_t)size + 1);
+		if (index->keys == NULL || index->ranks == NULL)
+		{
+			deleteSearchIndex(index);
+			return -1;
+		}
+		index->memory = 2 * ((size_t)size + SEARCH_LINE_INTS) / SEARCH_LINE_INTS * SEARCH_LINE_INTS * sizeof(int);
+		index->keys[0] = 0;
+		index->ranks[0] = -1;
+		fillEytzinger(index, 0, 1);
+	}
+	else if (engine == SEARCH_STREE)
+	{
+		index->numNodes = (size + SEARCH_LINE_INTS - 1) / SEARCH_LINE_INTS;
+		for (int node = 0; node < index->numNodes; node = sTreeChild(node, 0))
+		{
+			index->height++;
+		}
+
+		index->keys = allocateLines((size_t)index->numNodes * SEARCH_LINE_INTS);
+		index->ranks = allocateLines((size_t)index->numNodes * SEARCH_LINE_INTS);
+		if (index->keys == NULL || index->ranks == NULL)
+		{
+			deleteSearchIndex(index);
+			return -1;
+		}
+		index->memory = 2 * (size_t)index->numNodes * SEARCH_LINE_INTS * sizeof(int);
+		fillSTree(index, 0, 0);
+	}
+	else if (engine == SEARCH_LEARNED)
+	{
+		index->segments = (LearnedSegment*)malloc(sizeof(LearnedSegment) * (size_t)size);
+		if (index->segments == NULL)
+		{
+			return -1;
+		}
+		index->numSegments = fitSegments(index);
+
+		//keep only the memory of the segments that were used
+		LearnedSegment* segments = (LearnedSegment*)realloc(index->segments, sizeof(LearnedSegment) * (size_t)index->numSegments);
+		if (segments != NULL)
+		{
+			index->segments = segments;
+		}
+		index->memory = sizeof(LearnedSegment) * (size_t)index->numSegments;
+	}
+
+	return 0;
+}
+
+int branchlessSearch(const int* data, int size, int value)
+{
+	const int* base = data;
+	int length = size;
+
+	while (length > 1)
+	{
+		int half = length / 2;
+		__builtin_prefetch(base + half / 2);
+		__builtin_prefetch(base + half + half / 2);
+		base = base[half] < value ? base + half : base;
+		length -= half;
+	}
+
+	int position = (int)(base - data) + (*base < value);
+
+	return position < size && data[position] == value ? position : -1;
+}
+
+int eytzingerSearch(const SearchIndex* index, int value)
+{
+	const int* keys = index->keys;
+	unsigned int node = 1;
+
+	while (node <= (unsigned int)index->size)
+	{
+		__builtin_prefetch(keys + SEARCH_LINE_INTS * node);
+		node = 2 * node + (keys[node] < value);
+	}
+
+	//the walk went right after the last node that is not smaller than the value and left ever since,
+	//removing the trailing ones and the following zero of the path gives that node, 0 if all the values are smaller
+	node >>= __builtin_ffs((int)~node);
+
+	return node != 0 && keys[node] == value ? index->ranks[node] : -1;
+}
+
+//counts the values of a node of the S-tree that are smaller than a value
+//node: pointer to the SEARCH_LINE_INTS sorted values of the node, aligned to a cache line
+//value: the value
+//returns: the number of smaller values, the number of the child to descend to
+static inline int rankInNode(const int* node, int value)
+{
+#if defined(__AVX2__)
+	__m256i broadcast = _mm256_set1_epi32(value);
+	__m256i low = _mm256_cmpgt_epi32(broadcast, _mm256_load_si256((const __m256i*)node));
+	__m256i high = _mm256_cmpgt_epi32(broadcast, _mm256_load_si256((const __m256i*)(node + 8)));
+	unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(low)) | (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(high)) << 8;
+	return __builtin_popcount(mask);
+#elif defined(__SSE2__)
+	__m128i broadcast = _mm_set1_epi32(value);
+	__m128i smaller = _mm_add_epi32(_mm_cmpgt_epi32(broadcast, _mm_load_si128((const __m128i*)node)),
+		_mm_cmpgt_epi32(broadcast, _mm_load_si128((const __m128i*)(node + 4))));
+	smaller = _mm_add_epi32(smaller, _mm_cmpgt_epi32(broadcast, _mm_load_si128((const __m128i*)(node + 8))));
+	smaller = _mm_add_epi32(smaller, _mm_cmpgt_epi32(broadcast, _mm_load_si128((const __m128i*)(node + 12))));
+	//every lane holds minus the number of smaller values among its four, add up the lanes
+	smaller = _mm_add_epi32(smaller, _mm_shuffle_epi32(smaller, 0x4E));
+	smaller = _mm_add_epi32(smaller, _mm_shuffle_epi32(smaller, 0xB1));
+	return -_mm_cvtsi128_si32(smaller);
+#else
+	int count = 0;
+	for (int i = 0; i < SEARCH_LINE_INTS; ++i)
+	{
+		count += node[i] < value;
+	}
+	return count;
+#endif
+}
+
+int sTreeSearch(const SearchIndex* index, int value)
+{
+	int candidate = -1;
+	int node = 0;
+
+	while (node < index->numNodes)
+	{
+		int i = rankInNode(index->keys + node * SEARCH_LINE_INTS, value);
+		if (i < SEARCH_LINE_INTS)
+		{
+			candidate = node * SEARCH_LINE_INTS + i;
+		}
+		node = sTreeChild(node, i);
+	}
+
+	if (candidate == -1)
+	{
+		return -1;
+	}
+
+	int rank = index->ranks[candidate];
+
+	return index->keys[candidate] == value && rank < index->size ? rank : -1;
+}
+
+//a searched value and its position in the batch
+typedef struct BatchQuery BatchQuery;
+struct BatchQuery
+{
+	unsigned int key; //the value with the sign bit flipped, so that the unsigned order is the order of the values
+	int position; //the position of the value in the batch
+};
+
+//finds the first value of the sorted array that is not smaller than a value, searching forward from a position
+//the distance from the position doubles until it passes the value, then the last step is searched by binary search
+//data: pointer to the sorted array
+//size: the size of the sorted array
+//start: the position the search starts at, no value before it is searched for
+//value: the value to search for
+//returns: the index of the first value that is not smaller, size if there is none
+static int gallop(const int* data, int size, int start, int value)
+{
+	if (start >= size || data[start] >= value)
+	{
+		return start;
+	}
+
+	//data[low] is smaller than the value, data[high] is not or high is size
+	int low = start;
+	int step = 1;
+	int high = start + 1;
+	while (high < size && data[high] < value)
+	{
+		low = high;
+		step *= 2;
+		high = size - start > step ? start + step : size;
+	}
+
+	while (high - low > 1)
+	{
+		int middle = low + (high - low) / 2;
+		if (data[middle] < value)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return high;
+}
+
+int mergeSearch(const int* data, int size, const int* values, int count, int* positions)
+{
+	BatchQuery* queries = (BatchQuery*)malloc(sizeof(BatchQuery) * (size_t)(count > 0 ? count : 1) * 2);
+	if (queries == NULL)
+	{
+		return -1;
+	}
+
+	BatchQuery* source = queries;
+	BatchQuery* destination = queries + count;
+	for (int i = 0; i < count; ++i)
+	{
+		source[i].key = (unsigned int)values[i] ^ 0x80000000u;
+		source[i].position = i;
+	}
+
+	//sort the queries by 8 bits of the key per pass, a pass in which all the keys have the same digit is skipped
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		int counts[256] = { 0 };
+		for (int i = 0; i < count; ++i)
+		{
+			counts[(source[i].key >> shift) & 0xFF]++;
+		}
+		if (count == 0 || counts[(source[0].key >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		int start = 0;
+		for (int digit = 0; digit < 256; ++digit)
+		{
+			int digitCount = counts[digit];
+			counts[digit] = start;
+			start += digitCount;
+		}
+		for (int i = 0; i < count; ++i)
+		{
+			destination[counts[(source[i].key >> shift) & 0xFF]++] = source[i];
+		}
+
+		BatchQuery* aux = source;
+		source = destination;
+		destination = aux;
+	}
+
+	//one sweep over the sorted array, repeated values are found again at the same place
+	int position = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		int value = (int)(source[i].key ^ 0x80000000u);
+		position = gallop(data, size, position, value);
+		positions[source[i].position] = position < size && data[position] == value ? position : -1;
+	}
+
+	free(queries);
+
+	return 0;
+}
+
+//finds the first value of a range of the sorted array that is not smaller than a value by binary search
+//index: pointer to the index
+//low: the first index of the range
+//high: one past the last index of the range, the value is known not to be greater than the value at high, if it is in the array
+//value: the value to search for
+//counters: the counters the probes are added to, NULL for a search that isn't counted
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+FORCE_INLINE int searchWindow(const SearchIndex* index, int low, int high, int value, SearchCounters* counters)
+{
+	const int* data = index->data;
+	if (counters != NULL)
+	{
+		counters->windowTotal += high - low;
+	}
+
+	while (low < high)
+	{
+		int middle = low + (high - low) / 2;
+		if (counters != NULL)
+		{
+			counters->numProbes++;
+		}
+		if (data[middle] < value)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	if (low < index->size)
+	{
+		if (counters != NULL)
+		{
+			counters->numProbes++;
+		}
+		if (data[low] == value)
+		{
+			return low;
+		}
+	}
+
+	return -1;
+}
+
+//searches for a value by interpolation, see interpolationSearch
+//index: pointer to an index built with SEARCH_INTERPOLATION
+//value: the value to search for
+//counters: the counters the search is added to, NULL for a search that isn't counted
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+FORCE_INLINE int interpolationSearchWith(const SearchIndex* index, int value, SearchCounters* counters)
+{
+	const int* data = index->data;
+
+	//the first value that is not smaller than the searched one is in the range from low to high
+	int low = 0;
+	int high = index->size - 1;
+	if (counters != NULL)
+	{
+		counters->numSearches++;
+		counters->numProbes += 2;
+	}
+	if (value > data[high])
+	{
+		return -1;
+	}
+	if (value <= data[low])
+	{
+		return data[low] == value ? 0 : -1;
+	}
+
+	//the value at low is smaller than the searched one and the value at high is not
+	for (int step = 0; step < MAX_INTERPOLATION_STEPS && high - low > INTERPOLATION_WINDOW; ++step)
+	{
+		double fraction = ((double)value - data[low]) / ((double)data[high] - data[low]);
+		int guess = low + 1 + (int)(fraction * (high - low - 1));
+		guess = guess >= high ? high - 1 : guess;
+
+		if (counters != NULL)
+		{
+			counters->numProbes++;
+		}
+		if (data[guess] < value)
+		{
+			low = guess;
+		}
+		else
+		{
+			high = guess;
+		}
+	}
+
+	return searchWindow(index, low + 1, high, value, counters);
+}
+
+//searches for a value with the learned model, see learnedSearch
+//index: pointer to an index built with SEARCH_LEARNED
+//value: the value to search for
+//counters: the counters the search is added to, NULL for a search that isn't counted
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+FORCE_INLINE int learnedSearchWith(const SearchIndex* index, int value, SearchCounters* counters)
+{
+	const LearnedSegment* segments = index->segments;
+	if (counters != NULL)
+	{
+		counters->numSearches++;
+	}
+
+	//find the last segment whose first value is not greater than the searched one
+	int first = 0;
+	int count = index->numSegments;
+	while (count > 1)
+	{
+		int half = count / 2;
+		if (counters != NULL)
+		{
+			counters->numProbes++;
+		}
+		first = segments[first + half].key <= value ? first + half : first;
+		count -= half;
+	}
+	if (counters != NULL)
+	{
+		counters->numProbes++;
+	}
+	if (value < segments[first].key)
+	{
+		return -1;
+	}
+
+	//the prediction is within the error bound of the first occurrence, one more position on each side covers the rounding
+	const LearnedSegment* segment = &segments[first];
+	int end = first + 1 < index->numSegments ? segments[first + 1].rank : index->size;
+	//the window is clamped to the positions the segment covers, a value that is not in the array may be predicted far outside them
+	double predicted = segment->rank + segment->slope * ((double)value - segment->key);
+	double windowLow = predicted - LEARNED_ERROR_BOUND - 1;
+	double windowHigh = predicted + LEARNED_ERROR_BOUND + 2;
+	int low = windowLow <= segment->rank ? segment->rank : windowLow >= end ? end : (int)windowLow;
+	int high = windowHigh >= end ? end : windowHigh <= low ? low : (int)windowHigh;
+
+	return searchWindow(index, low, high, value, counters);
+}
+
+int interpolationSearch(const SearchIndex* index, int value)
+{
+	return interpolationSearchWith(index, value, NULL);
+}
+
+int learnedSearch(const SearchIndex* index, int value)
+{
+	return learnedSearchWith(index, value, NULL);
+}
+
+int countedSearch(SearchIndex* index, int value)
+{
+	if (index->engine == SEARCH_LEARNED)
+	{
+		return learnedSearchWith(index, value, &index->counters);
+	}
+
+	return interpolationSearchWith(index, value, &index->counters);
+}
+
+void deleteSearchIndex(SearchIndex* index)
+{
+	free(index->keys);
+	free(index->ranks);
+	free(index->segments);
+	index->keys = NULL;
+	index->ranks = NULL;
+	index->segments = NULL;
+	index->memory = 0;
+}
@@ -0,0 +1,140 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <stddef.h>
+
+//search engines over the sorted array of sorted.c, alternatives to its branching binary search
+//an engine may build an index from the sorted array once, every search returns the index of the value in the sorted array,
+//with repeated values it is the index of the first of them
+
+//the number of ints in a cache line, the blocks the indices are aligned to
+#define SEARCH_LINE_INTS 16
+
+//the interpolation search probes at most this many times before it finishes with a binary search
+#define MAX_INTERPOLATION_STEPS 8
+
+//the interpolation search finishes with a binary search once the range is at most this long
+#define INTERPOLATION_WINDOW 16
+
+//the maximum error of the position the learned model predicts for a value of the array
+#define LEARNED_ERROR_BOUND 32
+
+//the engines that can be used for searching the sorted array
+typedef enum SearchEngine SearchEngine;
+enum SearchEngine
+{
+	SEARCH_BINARY, //the three-way branching binary search of sorted.c, no index
+	SEARCH_BRANCHLESS, //lower-bound binary search with conditional moves instead of branches, no index
+	SEARCH_EYTZINGER, //binary search over a copy of the array in Eytzinger (breadth-first) order, with prefetching of the descendants
+	SEARCH_STREE, //static B-tree (S-tree) with nodes of one cache line, the keys of a node are compared with SIMD at once
+	SEARCH_MERGE, //a batch of values is sorted and resolved by one galloping sweep over the array, no index
+	SEARCH_INTERPOLATION, //interpolation search that guesses the position from the values at the ends of the range, no index
+	SEARCH_LEARNED //piecewise linear model of the position of a value with a bounded error, followed by a binary search in the error window
+};
+
+//a segment of the learned model, it predicts the position of the values from its first value up to the first value of the next segment
+typedef struct LearnedSegment LearnedSegment;
+struct LearnedSegment
+{
+	int key; //the first value covered by the segment
+	int rank; //the index of the first occurrence of the value in the sorted array
+	double slope; //the number of positions per unit of value
+};
+
+//the counts of the values the interpolation and learned engines read, gathered outside the measured searches
+typedef struct SearchCounters SearchCounters;
+struct SearchCounters
+{
+	long long numSearches; //the number of counted searches
+	long long numProbes; //the number of values of the array and of the model these searches read
+	long long windowTotal; //the sum of the lengths of the ranges these searches finished with a binary search
+};
+
+//the index of a search engine over a sorted array
+typedef struct SearchIndex SearchIndex;
+struct SearchIndex
+{
+	SearchEngine engine; //the engine that searches the array
+	const int* data; //the sorted array, it is not copied and must stay valid while the index is used
+	int size; //the size of the sorted array
+	int* keys; //the values in the layout of the engine, NULL for engines without a copy of the array
+	           //SEARCH_EYTZINGER: in Eytzinger order starting at index 1, node k has the children 2k and 2k+1
+	           //SEARCH_STREE: in nodes of SEARCH_LINE_INTS values, node k has the children k * (SEARCH_LINE_INTS + 1) + i + 1 for i from 0 to SEARCH_LINE_INTS
+	int* ranks; //the index in the sorted array of every value of keys, the size of the array for padding, NULL for engines without it
+	int numNodes; //the number of nodes of the S-tree
+	int height; //the number of levels of the S-tree, i.e. the number of nodes a search visits
+	LearnedSegment* segments; //the segments of the learned model sorted by their first value, NULL for engines without it
+	int numSegments; //the number of segments of the learned model
+	size_t memory; //the number of bytes allocated by the index
+	SearchCounters counters; //the counts of the searches of countedSearch
+};
+
+//builds the index of a search engine over a sorted array
+//index: pointer to the index
+//engine: the search engine
+//data: pointer to the sorted array
+//size: the size of the sorted array
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int buildSearchIndex(SearchIndex* index, SearchEngine engine, const int* data, int size);
+
+//searches for a value with a lower-bound binary search that halves the range with a conditional move instead of a branch,
+//so the loop runs the same number of steps for every value and no misprediction occurs, the next two possible middles are prefetched
+//data: pointer to the sorted array
+//size: the size of the sorted array
+//value: the value to search for
+//returns: the index of the first occurrence of the value in the array, -1 if it is not found
+int branchlessSearch(const int* data, int size, int value);
+
+//searches for a value in the Eytzinger copy of the array, the walk down the tree is branchless
+//and the 16 descendants four levels below the current node, which lie in one cache line, are prefetched at every step
+//index: pointer to an index built with SEARCH_EYTZINGER
+//value: the value to search for
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+int eytzingerSearch(const SearchIndex* index, int value);
+
+//searches for a value in the S-tree, every node is a cache line of SEARCH_LINE_INTS sorted values compared with the value at once
+//by AVX2 or SSE2, the number of values smaller than it selects the child, so a search reads about log17(n) cache lines
+//the first value that is not smaller than the searched one in the last node that has one is the lower bound
+//index: pointer to an index built with SEARCH_STREE
+//value: the value to search for
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+int sTreeSearch(const SearchIndex* index, int value);
+
+//searches for a batch of values at once: the values are sorted by a radix sort that remembers their positions in the batch,
+//then one sweep over the sorted array finds them in ascending order, every search gallops forward from where the previous one ended
+//(exponential search) and finishes with a binary search in the last step, so the array is read sequentially and nothing is read twice
+//data: pointer to the sorted array
+//size: the size of the sorted array
+//values: pointer to the values to search for, in any order
+//count: the number of values
+//positions: pointer to an array of count ints where the index of the first occurrence of every value in the sorted array is saved, -1 if it is not found
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int mergeSearch(const int* data, int size, const int* values, int count, int* positions);
+
+//searches for a value by interpolation: the position of the value is guessed from the values at the ends of the range,
+//which takes about log log n probes on uniformly distributed values, after MAX_INTERPOLATION_STEPS probes
+//or once the range is at most INTERPOLATION_WINDOW long, the rest of the range is searched by binary search
+//index: pointer to an index built with SEARCH_INTERPOLATION
+//value: the value to search for
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+int interpolationSearch(const SearchIndex* index, int value);
+
+//searches for a value with the learned model: the segment that covers the value is found by binary search over the segments,
+//its line predicts the position of the value to within LEARNED_ERROR_BOUND, and the window around the prediction is searched by binary search
+//index: pointer to an index built with SEARCH_LEARNED
+//value: the value to search for
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+int learnedSearch(const SearchIndex* index, int value);
+
+//searches for a value like interpolationSearch or learnedSearch and counts the values it reads into the counters of the index,
+//a separate pass over the values so that the measured searches don't pay for the counting
+//index: pointer to an index built with SEARCH_INTERPOLATION or SEARCH_LEARNED, its counters are updated
+//value: the value to search for
+//returns: the index of the first occurrence of the value in the sorted array, -1 if it is not found
+int countedSearch(SearchIndex* index, int value);
+
+//frees the memory of the index
+//index: pointer to the index
+void deleteSearchIndex(SearchIndex* index);
+
+#endif
@@ -0,0 +1,811 @@
+#define _GNU_SOURCE //for S_ISSOCK and the POSIX socket and poll interfaces
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "server.h"
+
+#define SERVER_FRAME_BYTES (4 * (SERVER_MAX_BATCH + 1)) //the size of the largest request or response
+#define SERVER_MAX_OUTPUT (4 * SERVER_FRAME_BYTES) //the queued responses of a client at which its requests are not read until it takes them
+
+//set by SIGINT and SIGTERM, the event loop stops when it is set
+static volatile sig_atomic_t serverInterrupted = 0;
+
+//a client of the server and its buffered data
+typedef struct ServerConnection ServerConnection;
+struct ServerConnection
+{
+	int inputFd; //the descriptor the requests are read from
+	int outputFd; //the descriptor the responses are written to, the same socket as inputFd unless the standard input and output are served
+	unsigned char* input; //the received bytes of the requests that are not complete yet, room for SERVER_FRAME_BYTES
+	size_t inputSize; //the number of received bytes
+	unsigned char* output; //the responses that are not written yet
+	size_t outputStart; //the position of the first byte that is not written yet
+	size_t outputEnd; //the position after the last byte of the responses
+	size_t outputCapacity; //the size of the output buffer
+	int inputClosed; //1 when the client has closed its side, the connection ends when its responses are written
+	int failed; //1 when the connection failed and is to be closed at once
+};
+
+//signal handler of SIGINT and SIGTERM
+//signal: the number of the signal
+static void interruptServer(int signal)
+{
+	(void)signal;
+	serverInterrupted = 1;
+}
+
+double serverNow()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+//returns the bucket of a latency histogram a latency is counted in
+//latency: the latency in microseconds
+//returns: the index of the bucket
+static int latencyBucket(double latency)
+{
+	const unsigned long long largest = (2ull << (LATENCY_BUCKETS / LATENCY_SUB_BUCKETS - 2)) * LATENCY_SUB_BUCKETS - 1;
+	double nanoseconds = latency * 1e3 + 0.5;
+	unsigned long long value = nanoseconds <= 0.0 ? 0 : (nanoseconds >= (double)largest ? largest : (unsigned long long)nanoseconds);
+	if (value < 2 * LATENCY_SUB_BUCKETS)
+	{
+		return (int)value;
+	}
+
+	//the power of two of the value picks a group of buckets, its next bits the bucket in the group
+	int shift = 63 - __builtin_clzll(value) - __builtin_ctz(LATENCY_SUB_BUCKETS);
+
+	return (shift + 1) * LATENCY_SUB_BUCKETS + (int)(value >> shift) - LATENCY_SUB_BUCKETS;
+}
+
+//returns the latency in the middle of a bucket of a latency histogram
+//bucket: the index of the bucket
+//returns: the latency in microseconds
+static double bucketLatency(int bucket)
+{
+	if (bucket < 2 * LATENCY_SUB_BUCKETS)
+	{
+		return bucket / 1e3;
+	}
+
+	int shift = bucket / LATENCY_SUB_BUCKETS - 1;
+	unsigned long long lowest = (unsigned long long)(bucket % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS) << shift;
+
+	return (lowest + ((1ull << shift) - 1) / 2.0) / 1e3;
+}
+
+void initLatencyHistogram(LatencyHistogram* histogram)
+{
+	memset(histogram->buckets, 0, sizeof(histogram->buckets));
+	histogram->count = 0;
+	histogram->total = 0.0;
+	histogram->maximum = 0.0;
+}
+
+void addLatency(LatencyHistogram* histogram, double latency)
+{
+	histogram->buckets[latencyBucket(latency)]++;
+	histogram->count++;
+	histogram->total += latency;
+	if (latency > histogram->maximum)
+	{
+		histogram->maximum = latency;
+	}
+}
+
+void mergeLatencyHistogram(LatencyHistogram* histogram, const LatencyHistogram* other)
+{
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+	{
+		histogram->buckets[i] += other->buckets[i];
+	}
+	histogram->count += other->count;
+	histogram->total += other->total;
+	if (other->maximum > histogram->maximum)
+	{
+		histogram->maximum = other->maximum;
+	}
+}
+
+//returns a percentile of the latencies of a histogram, the nearest rank
+//histogram: pointer to the histogram, with at least one latency
+//percentile: the percentile, from 0 to 100
+//returns: the middle of the bucket of the latency, at most the largest latency
+static double latencyPercentile(const LatencyHistogram* histogram, double percentile)
+{
+	long long rank = (long long)(percentile / 100.0 * histogram->count + 0.5);
+	rank = rank < 1 ? 1 : (rank > histogram->count ? histogram->count : rank);
+
+	int bucket = 0;
+	long long seen = histogram->buckets[0];
+	while (seen < rank)
+	{
+		seen += histogram->buckets[++bucket];
+	}
+	double latency = bucketLatency(bucket);
+
+	return latency < histogram->maximum ? latency : histogram->maximum;
+}
+
+void printLatencyHistogram(const char* name, const LatencyHistogram* histogram)
+{
+	if (histogram->count == 0)
+	{
+		return;
+	}
+
+	printf("  %s: mean %.2f us, median %.2f us, p90 %.2f us, p99 %.2f us, p99.9 %.2f us, maximum %.2f us (%lld batches)\n", name,
+		histogram->total / histogram->count, latencyPercentile(histogram, 50.0), latencyPercentile(histogram, 90.0),
+		latencyPercentile(histogram, 99.0), latencyPercentile(histogram, 99.9), histogram->maximum, histogram->count);
+}
+
+//makes a descriptor non-blocking
+//fd: the descriptor
+//flags: its file status flags before the change are saved here, NULL if they are not needed
+//returns: 0 on success, -1 if the flags could not be changed
+static int setNonBlocking(int fd, int* flags)
+{
+	int current = fcntl(fd, F_GETFL);
+	if (current == -1 || fcntl(fd, F_SETFL, current | O_NONBLOCK) == -1)
+	{
+		return -1;
+	}
+	if (flags != NULL)
+	{
+		*flags = current;
+	}
+
+	return 0;
+}
+
+int openServer(Server* server, const char* address)
+{
+	server->address = address;
+	server->listenFd = -1;
+	server->outputFd = -1;
+	server->inputFlags = -1;
+	server->outputFlags = -1;
+	server->numConnections = 0;
+	server->numBatches = 0;
+	server->numKeys = 0;
+	server->numFound = 0;
+	initLatencyHistogram(&server->latencies);
+	initLatencyHistogram(&server->recentLatencies);
+	server->seconds = 0.0;
+
+	if (strcmp(address, "-") == 0)
+	{
+		//the responses keep the standard output, everything the program prints goes to the standard error
+		fflush(stdout);
+		server->outputFd = dup(STDOUT_FILENO);
+		if (server->outputFd == -1 || dup2(STDERR_FILENO, STDOUT_FILENO) == -1)
+		{
+			printf("Error: cannot set the standard output aside for the server!\n");
+			return -1;
+		}
+		return 0;
+	}
+
+	struct sockaddr_un socketAddress;
+	memset(&socketAddress, 0, sizeof(socketAddress));
+	socketAddress.sun_family = AF_UNIX;
+	if (strlen(address) >= sizeof(socketAddress.sun_path))
+	{
+		printf("Error: socket path %s is too long!\n", address);
+		return -1;
+	}
+	strcpy(socketAddress.sun_path, address);
+
+	//only an old socket is removed, never any other file
+	struct stat status;
+	if (stat(address, &status) == 0 && S_ISSOCK(status.st_mode))
+	{
+		unlink(address);
+	}
+
+	server->listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server->listenFd == -1 || bind(server->listenFd, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) == -1
+		|| listen(server->listenFd, SERVER_MAX_CLIENTS) == -1 || setNonBlocking(server->listenFd, NULL) == -1)
+	{
+		printf("Error: cannot listen on socket %s!\n", address);
+		if (server->listenFd != -1)
+		{
+			close(server->listenFd);
+			server->listenFd = -1;
+		}
+		return -1;
+	}
+
+	return 0;
+}
+
+//sets up a new connection
+//connection: pointer to the connection
+//inputFd: the descriptor the requests are read from
+//outputFd: the descriptor the responses are written to
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+static int openConnection(ServerConnection* connection, int inputFd, int outputFd)
+{
+	connection->inputFd = inputFd;
+	connection->outputFd = outputFd;
+	connection->input = (unsigned char*)malloc(SERVER_FRAME_BYTES);
+	connection->inputSize = 0;
+	connection->output = (unsigned char*)malloc(SERVER_FRAME_BYTES);
+	connection->outputStart = 0;
+	connection->outputEnd = 0;
+	connection->outputCapacity = SERVER_FRAME_BYTES;
+	connection->inputClosed = 0;
+	connection->failed = 0;
+
+	if (connection->input == NULL || connection->output == NULL)
+	{
+		free(connection->input);
+		free(connection->output);
+		return -1;
+	}
+
+	return 0;
+}
+
+//frees the buffers of a connection, its descriptors are closed by the caller
+//connection: pointer to the connection
+static void closeConnection(ServerConnection* connection)
+{
+	free(connection->input);
+	free(connection->output);
+}
+
+//makes room for a response at the end of the output buffer, the written bytes are dropped from its beginning first
+//the requests of a client are read only while less than SERVER_MAX_OUTPUT bytes of responses are queued and the input buffer
+//holds at most SERVER_FRAME_BYTES of requests, so the buffer grows to at most SERVER_MAX_OUTPUT + SERVER_FRAME_BYTES bytes
+//connection: pointer to the connection
+//bytes: the size of the response
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+static int reserveOutput(ServerConnection* connection, size_t bytes)
+{
+	if (connection->outputStart > 0)
+	{
+		memmove(connection->output, connection->output + connection->outputStart, connection->outputEnd - connection->outputStart);
+		connection->outputEnd -= connection->outputStart;
+		connection->outputStart = 0;
+	}
+
+	if (connection->outputEnd + bytes > connection->outputCapacity)
+	{
+		size_t capacity = 2 * connection->outputCapacity;
+		while (connection->outputEnd + bytes > capacity)
+		{
+			capacity *= 2;
+		}
+		unsigned char* output = (unsigned char*)realloc(connection->output, capacity);
+		if (output == NULL)
+		{
+			return -1;
+		}
+		connection->output = output;
+		connection->outputCapacity = capacity;
+	}
+
+	return 0;
+}
+
+//answers the complete requests in the input buffer of a connection and queues their responses
+//the requests and responses are whole multiples of 4 bytes, so the keys and positions in the buffers are aligned ints
+//server: pointer to the server, its statistics are updated
+//connection: pointer to the connection
+//lookup: the function searching for a batch of keys
+//context: the structure passed to lookup
+//returns: 1 if a request stopped the server, 0 otherwise, -1 if a request was invalid or the memory could not be allocated
+static int answerRequests(Server* server, ServerConnection* connection, ServerLookup lookup, void* context)
+{
+	size_t offset = 0;
+	int result = 0;
+
+	while (connection->inputSize - offset >= 4)
+	{
+		unsigned int count;
+		memcpy(&count, connection->input + offset, 4);
+		if (count == SERVER_SHUTDOWN)
+		{
+			result = 1;
+			break;
+		}
+		if (count > SERVER_MAX_BATCH)
+		{
+			printf("Error: a request of %u keys is larger than %d keys!\n", count, SERVER_MAX_BATCH);
+			result = -1;
+			break;
+		}
+
+		size_t bytes = 4 * ((size_t)count + 1);
+		if (connection->inputSize - offset < bytes)
+		{
+			break;
+		}
+
+		//the latency of a batch runs from its complete request to its queued response
+		double start = serverNow();
+		if (reserveOutput(connection, bytes) == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			result = -1;
+			break;
+		}
+		memcpy(connection->output + connection->outputEnd, &count, 4);
+		int numFound = lookup(context, (const int*)(connection->input + offset + 4), (int)count, (int*)(connection->output + connection->outputEnd + 4));
+		if (numFound == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			result = -1;
+			break;
+		}
+		connection->outputEnd += bytes;
+
+		double latency = (serverNow() - start) * 1e6;
+		addLatency(&server->latencies, latency);
+		addLatency(&server->recentLatencies, latency);
+		server->numBatches++;
+		server->numKeys += count;
+		server->numFound += numFound;
+		offset += bytes;
+	}
+
+	//the beginning of the next request moves to the front of the buffer
+	memmove(connection->input, connection->input + offset, connection->inputSize - offset);
+	connection->inputSize -= offset;
+
+	return result;
+}
+
+//reads what a client has sent, as much as fits into the input buffer
+//connection: pointer to the connection, it is marked as closed or failed
+static void readRequests(ServerConnection* connection)
+{
+	ssize_t received = read(connection->inputFd, connection->input + connection->inputSize, SERVER_FRAME_BYTES - connection->inputSize);
+	if (received > 0)
+	{
+		connection->inputSize += (size_t)received;
+	}
+	else if (received == 0)
+	{
+		connection->inputClosed = 1;
+	}
+	else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+	{
+		connection->failed = 1;
+	}
+}
+
+//writes as many of the queued responses as the client takes without waiting
+//connection: pointer to the connection, it is marked as failed if the client is gone
+static void writeResponses(ServerConnection* connection)
+{
+	while (connection->outputStart < connection->outputEnd)
+	{
+		ssize_t written = write(connection->outputFd, connection->output + connection->outputStart, connection->outputEnd - connection->outputStart);
+		if (written < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			{
+				connection->failed = 1;
+			}
+			return;
+		}
+		connection->outputStart += (size_t)written;
+	}
+
+	connection->outputStart = 0;
+	connection->outputEnd = 0;
+}
+
+//prints the throughput and the latencies of the batches answered since the last report and starts the next interval
+//server: pointer to the server, its latencies since the last report are cleared
+//numKeys: the number of keys searched since the last report
+//seconds: the time since the last report
+//elapsed: the time since the server started
+static void reportInterval(Server* server, long long numKeys, double seconds, double elapsed)
+{
+	LatencyHistogram* recent = &server->recentLatencies;
+	printf("  %.1f s: %lld batches, %.0f keys per second, batch latency median %.2f us, p99 %.2f us, maximum %.2f us\n", elapsed, recent->count,
+		numKeys / seconds, latencyPercentile(recent, 50.0), latencyPercentile(recent, 99.0), recent->maximum);
+	fflush(stdout);
+
+	initLatencyHistogram(recent);
+}
+
+int runServer(Server* server, ServerLookup lookup, void* context)
+{
+	ServerConnection connections[SERVER_MAX_CLIENTS];
+	int numConnections = 0;
+
+	//a client that disconnects while a response is written must not end the server
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &action, NULL);
+	action.sa_handler = interruptServer;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	int pipeMode = server->listenFd == -1;
+	if (pipeMode)
+	{
+		if (setNonBlocking(STDIN_FILENO, &server->inputFlags) == -1 || setNonBlocking(server->outputFd, &server->outputFlags) == -1
+			|| openConnection(&connections[0], STDIN_FILENO, server->outputFd) == -1)
+		{
+			printf("Error: couldn't set up the standard input and output for the server!\n");
+			return -1;
+		}
+		numConnections = 1;
+		server->numConnections = 1;
+		printf("Server log:\n\n  Serving the standard input and output\n");
+	}
+	else
+	{
+		printf("Server log:\n\n  Serving on socket %s\n", server->address);
+	}
+	fflush(stdout);
+
+	//one descriptor for the listening socket, two for each connection at most
+	struct pollfd fds[1 + 2 * SERVER_MAX_CLIENTS];
+	int inputIndex[SERVER_MAX_CLIENTS];
+	int outputIndex[SERVER_MAX_CLIENTS];
+
+	double start = serverNow();
+	double lastReport = start;
+	long long reportKeys = 0;
+	int stop = 0;
+	int result = 0;
+
+	while (!stop && !serverInterrupted)
+	{
+		int numFds = 0;
+		if (!pipeMode)
+		{
+			fds[numFds].fd = server->listenFd;
+			fds[numFds].events = numConnections < SERVER_MAX_CLIENTS ? POLLIN : 0;
+			numFds++;
+		}
+		for (int i = 0; i < numConnections; ++i)
+		{
+			ServerConnection* connection = &connections[i];
+			short outputEvents = connection->outputStart < connection->outputEnd ? POLLOUT : 0;
+
+			//a client with a full backlog of responses is not read from until it takes some of them
+			inputIndex[i] = -1;
+			if (!connection->inputClosed && connection->outputEnd - connection->outputStart < SERVER_MAX_OUTPUT)
+			{
+				inputIndex[i] = numFds;
+				fds[numFds].fd = connection->inputFd;
+				fds[numFds].events = POLLIN;
+				numFds++;
+			}
+
+			//a socket is waited for once, for both directions
+			if (inputIndex[i] != -1 && connection->outputFd == connection->inputFd)
+			{
+				fds[inputIndex[i]].events |= outputEvents;
+				outputIndex[i] = inputIndex[i];
+			}
+			else
+			{
+				outputIndex[i] = numFds;
+				fds[numFds].fd = connection->outputFd;
+				fds[numFds].events = outputEvents;
+				numFds++;
+			}
+		}
+
+		//wake up for the next report while batches are being answered
+		int timeout = -1;
+		if (server->recentLatencies.count > 0)
+		{
+			double wait = lastReport + SERVER_REPORT_INTERVAL - serverNow();
+			timeout = wait > 0.0 ? (int)(wait * 1000.0) + 1 : 0;
+		}
+
+		int ready = poll(fds, (nfds_t)numFds, timeout);
+		if (ready == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			printf("Error: waiting for the clients failed!\n");
+			result = -1;
+			break;
+		}
+
+		for (int i = 0; i < numConnections && !stop; ++i)
+		{
+			ServerConnection* connection = &connections[i];
+
+			if (inputIndex[i] != -1 && (fds[inputIndex[i]].revents & (POLLIN | POLLHUP | POLLERR)))
+			{
+				readRequests(connection);
+				int answered = answerRequests(server, connection, lookup, context);
+				if (answered == 1)
+				{
+					stop = 1;
+				}
+				else if (answered == -1)
+				{
+					connection->failed = 1;
+				}
+			}
+
+			//the responses are written at once, poll() is only needed for a client that doesn't take them all
+			if (!connection->failed && (connection->outputStart < connection->outputEnd || (fds[outputIndex[i]].revents & POLLOUT)))
+			{
+				writeResponses(connection);
+			}
+		}
+
+		//remove the connections that ended, a pipe ends the server
+		for (int i = 0; i < numConnections; ++i)
+		{
+			ServerConnection* connection = &connections[i];
+			if (connection->failed || (connection->inputClosed && connection->outputStart == connection->outputEnd))
+			{
+				closeConnection(connection);
+				if (pipeMode)
+				{
+					stop = 1;
+				}
+				else
+				{
+					close(connection->inputFd);
+				}
+				connections[i--] = connections[--numConnections];
+			}
+		}
+
+		//accept the clients that are waiting
+		if (!pipeMode && !stop && (fds[0].revents & POLLIN))
+		{
+			while (numConnections < SERVER_MAX_CLIENTS)
+			{
+				int fd = accept(server->listenFd, NULL, NULL);
+				if (fd == -1)
+				{
+					break;
+				}
+				if (setNonBlocking(fd, NULL) == -1 || openConnection(&connections[numConnections], fd, fd) == -1)
+				{
+					close(fd);
+					continue;
+				}
+				numConnections++;
+				server->numConnections++;
+			}
+		}
+
+		double now = serverNow();
+		if (now - lastReport >= SERVER_REPORT_INTERVAL)
+		{
+			if (server->recentLatencies.count > 0)
+			{
+				reportInterval(server, server->numKeys - reportKeys, now - lastReport, now - start);
+			}
+			lastReport = now;
+			reportKeys = server->numKeys;
+		}
+	}
+
+	server->seconds = serverNow() - start;
+
+	//the remaining clients are disconnected, their unanswered requests are dropped
+	for (int i = 0; i < numConnections; ++i)
+	{
+		closeConnection(&connections[i]);
+		if (!pipeMode)
+		{
+			close(connections[i].inputFd);
+		}
+	}
+
+	return result;
+}
+
+void printServerStats(Server* server)
+{
+	printf("\nServer details:\n\n");
+	printf("  Served %lld connections, %lld batches of %.1f keys on average, %lld of %lld keys found\n", server->numConnections,
+		server->numBatches, server->numBatches > 0 ? (double)server->numKeys / server->numBatches : 0.0, server->numFound, server->numKeys);
+	printf("  Served for %.3f s, %.0f keys per second over the whole time\n", server->seconds,
+		server->seconds > 0.0 ? server->numKeys / server->seconds : 0.0);
+	printLatencyHistogram("Batch latency (complete request to queued response)", &server->latencies);
+	fflush(stdout);
+}
+
+void closeServer(Server* server)
+{
+	if (server->listenFd != -1)
+	{
+		close(server->listenFd);
+		unlink(server->address);
+		server->listenFd = -1;
+	}
+	if (server->outputFd != -1)
+	{
+		//the standard input and output are left as they were found
+		if (server->inputFlags != -1)
+		{
+			fcntl(STDIN_FILENO, F_SETFL, server->inputFlags);
+		}
+		if (server->outputFlags != -1)
+		{
+			fcntl(server->outputFd, F_SETFL, server->outputFlags);
+		}
+		close(server->outputFd);
+		server->outputFd = -1;
+	}
+}
+
+int connectServer(const char* path)
+{
+	struct sockaddr_un socketAddress;
+	memset(&socketAddress, 0, sizeof(socketAddress));
+	socketAddress.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(socketAddress.sun_path))
+	{
+		printf("Error: socket path %s is too long!\n", path);
+		return -1;
+	}
+	strcpy(socketAddress.sun_path, path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd == -1 || connect(fd, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) == -1)
+	{
+		printf("Error: cannot connect to socket %s!\n", path);
+		if (fd != -1)
+		{
+			close(fd);
+		}
+		return -1;
+	}
+
+	return fd;
+}
+
+int spawnServer(const char* command, int* requestFd, int* responseFd, pid_t* pid)
+{
+	int requestPipe[2];
+	int responsePipe[2];
+	if (pipe(requestPipe) == -1)
+	{
+		printf("Error: cannot create a pipe!\n");
+		return -1;
+	}
+	if (pipe(responsePipe) == -1)
+	{
+		printf("Error: cannot create a pipe!\n");
+		close(requestPipe[0]);
+		close(requestPipe[1]);
+		return -1;
+	}
+
+	fflush(stdout);
+	*pid = fork();
+	if (*pid == -1)
+	{
+		printf("Error: cannot start the server!\n");
+		close(requestPipe[0]);
+		close(requestPipe[1]);
+		close(responsePipe[0]);
+		close(responsePipe[1]);
+		return -1;
+	}
+
+	if (*pid == 0)
+	{
+		//the server reads the requests from its standard input and writes the responses to its standard output
+		dup2(requestPipe[0], STDIN_FILENO);
+		dup2(responsePipe[1], STDOUT_FILENO);
+		close(requestPipe[0]);
+		close(requestPipe[1]);
+		close(responsePipe[0]);
+		close(responsePipe[1]);
+		execl("/bin/sh", "sh", "-c", command, (char*)NULL);
+		_exit(127);
+	}
+
+	close(requestPipe[0]);
+	close(responsePipe[1]);
+	*requestFd = requestPipe[1];
+	*responseFd = responsePipe[0];
+
+	//a server that exits early must not end the client
+	signal(SIGPIPE, SIG_IGN);
+
+	return 0;
+}
+
+//writes all the bytes of a buffer
+//fd: the descriptor
+//data: pointer to the bytes
+//size: the number of bytes
+//returns: 0 on success, -1 if writing failed
+static int writeAll(int fd, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	while (size > 0)
+	{
+		ssize_t written = write(fd, bytes, size);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return -1;
+		}
+		bytes += written;
+		size -= (size_t)written;
+	}
+
+	return 0;
+}
+
+//reads a given number of bytes
+//fd: the descriptor
+//data: pointer to where the bytes are saved
+//size: the number of bytes
+//returns: 0 on success, -1 if reading failed or the other side closed the connection first
+static int readAll(int fd, void* data, size_t size)
+{
+	unsigned char* bytes = (unsigned char*)data;
+	while (size > 0)
+	{
+		ssize_t received = read(fd, bytes, size);
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (received <= 0)
+		{
+			return -1;
+		}
+		bytes += received;
+		size -= (size_t)received;
+	}
+
+	return 0;
+}
+
+int sendRequest(int fd, const int* keys, unsigned int count)
+{
+	if (writeAll(fd, &count, 4) == -1)
+	{
+		return -1;
+	}
+
+	return count == SERVER_SHUTDOWN ? 0 : writeAll(fd, keys, 4 * (size_t)count);
+}
+
+int receiveResponse(int fd, int* positions, int count)
+{
+	unsigned int received;
+	if (readAll(fd, &received, 4) == -1 || received != (unsigned int)count)
+	{
+		return -1;
+	}
+
+	return readAll(fd, positions, 4 * (size_t)count);
+}
@@ -0,0 +1,148 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <sys/types.h>
+
+//query server that keeps a built structure resident and answers batches of lookups, so the build is paid once for any number of batches
+//it serves clients on a Unix domain socket, or a single client on the standard input and output ("-"),
+//from one thread with an event loop: poll() waits until a client has sent data or can take more of its responses,
+//every socket is non-blocking, and a client's requests are answered in order as soon as they are complete,
+//unless the client has not taken a few batches of responses yet: its requests then wait until it reads them
+//
+//the protocol is binary, with 32-bit integers in the byte order of the machine, since clients run on the same machine:
+//a request is the number of keys n followed by the n keys, the response is n followed by the n positions, -1 for a key that was not found;
+//a client may send several requests before reading the responses; a request with n = SERVER_SHUTDOWN stops the server, which then
+//closes all connections without answering it
+
+//the largest number of keys of a request
+#define SERVER_MAX_BATCH 65536
+
+//the number of keys of a request that stops the server
+#define SERVER_SHUTDOWN 0xffffffffu
+
+//the largest number of clients connected at once, more clients wait until one disconnects
+#define SERVER_MAX_CLIENTS 64
+
+//the seconds between the reports of the server while it receives requests
+#define SERVER_REPORT_INTERVAL 1.0
+
+//searches for a batch of keys in the structure the server keeps
+//context: the structure, as given to runServer
+//keys: pointer to the keys to search for
+//count: the number of keys
+//positions: pointer to an array of count ints where the position of every key is saved, -1 if it is not found
+//returns: the number of keys found, -1 if it was not possible to allocate the memory
+typedef int (*ServerLookup)(void* context, const int* keys, int count, int* positions);
+
+//the number of buckets of a latency histogram per power of two of nanoseconds, a bucket is at most 1/64 of its latencies wide
+#define LATENCY_SUB_BUCKETS 64
+
+//the number of buckets of a latency histogram, latencies are told apart up to 2^41 ns (about 36 minutes), longer ones count as that
+#define LATENCY_BUCKETS (36 * LATENCY_SUB_BUCKETS)
+
+//a histogram of latencies with buckets of a fixed relative width, for their percentiles in a fixed amount of memory
+//the latencies are counted by nanoseconds, exactly below 2 * LATENCY_SUB_BUCKETS and in LATENCY_SUB_BUCKETS buckets per power of two above
+typedef struct LatencyHistogram LatencyHistogram;
+struct LatencyHistogram
+{
+	long long buckets[LATENCY_BUCKETS]; //the number of latencies in every bucket
+	long long count; //the number of latencies
+	double total; //the sum of the latencies in microseconds
+	double maximum; //the largest latency in microseconds
+};
+
+//the server and what it has served
+typedef struct Server Server;
+struct Server
+{
+	const char* address; //the path of the Unix domain socket, "-" for the standard input and output
+	int listenFd; //the listening socket, -1 when serving the standard input and output
+	int outputFd; //the standard output the responses are written to when serving it, the program's own output goes to the standard error
+	int inputFlags; //the file status flags of the standard input before it was made non-blocking, -1 if it wasn't changed
+	int outputFlags; //the file status flags of the standard output before it was made non-blocking, -1 if it wasn't changed
+	long long numConnections; //the number of clients that connected
+	long long numBatches; //the number of answered requests
+	long long numKeys; //the number of keys searched
+	long long numFound; //the number of keys found
+	LatencyHistogram latencies; //the latencies of all the batches, from the end of the request to the queued response
+	LatencyHistogram recentLatencies; //the latencies of the batches since the last report
+	double seconds; //the time from the start of serving to its end
+};
+
+//opens the server once the structure is built
+//for a socket, the socket is created and bound, an old socket file at the path is removed first;
+//for "-", the standard output is set aside for the responses and the standard output of the program is sent to the standard error
+//server: pointer to the server
+//address: the path of the Unix domain socket, "-" for the standard input and output
+//returns: 0 on success, -1 if the socket could not be created or bound or the output could not be set aside
+int openServer(Server* server, const char* address);
+
+//answers the requests of the clients until a client stops the server, the program receives SIGINT or SIGTERM,
+//or, on the standard input and output, the input ends; while requests arrive the server reports its throughput and latency
+//every SERVER_REPORT_INTERVAL seconds
+//server: pointer to the opened server, its statistics are updated
+//lookup: the function searching for a batch of keys
+//context: the structure passed to lookup
+//returns: 0 on success, -1 if it was not possible to allocate the memory or to wait for the clients
+int runServer(Server* server, ServerLookup lookup, void* context);
+
+//prints the statistics of the server: the connections, the batches and keys served, the throughput and the latencies of the batches
+//server: pointer to the server
+void printServerStats(Server* server);
+
+//closes the server and removes its socket file
+//server: pointer to the server
+void closeServer(Server* server);
+
+//initializes an empty latency histogram
+//histogram: pointer to the histogram
+void initLatencyHistogram(LatencyHistogram* histogram);
+
+//adds a latency to the histogram
+//histogram: pointer to the histogram
+//latency: the latency in microseconds
+void addLatency(LatencyHistogram* histogram, double latency);
+
+//adds all the latencies of a histogram to another one
+//histogram: pointer to the histogram that is extended
+//other: pointer to the histogram whose latencies are added
+void mergeLatencyHistogram(LatencyHistogram* histogram, const LatencyHistogram* other);
+
+//prints a line with the mean, the percentiles and the maximum of the latencies,
+//the mean and the maximum are exact, a percentile is the middle of its bucket
+//name: what the latencies are of
+//histogram: pointer to the histogram
+void printLatencyHistogram(const char* name, const LatencyHistogram* histogram);
+
+//returns the current time of the monotonic clock
+//returns: the time in seconds
+double serverNow();
+
+//connects to a server listening on a Unix domain socket
+//path: the path of the socket
+//returns: the connected socket, -1 if it was not possible to connect
+int connectServer(const char* path);
+
+//starts a server as a child process that is served over its standard input and output
+//command: the shell command running the server with "--serve -"
+//requestFd: the pipe to the standard input of the server is saved here
+//responseFd: the pipe from the standard output of the server is saved here
+//pid: the process id of the server is saved here
+//returns: 0 on success, -1 if the pipes or the process could not be created
+int spawnServer(const char* command, int* requestFd, int* responseFd, pid_t* pid);
+
+//sends a request
+//fd: the connection to the server
+//keys: pointer to the keys to search for
+//count: the number of keys, at most SERVER_MAX_BATCH, or SERVER_SHUTDOWN with no keys to stop the server
+//returns: 0 on success, -1 if the connection failed
+int sendRequest(int fd, const int* keys, unsigned int count);
+
+//receives the response to a request
+//fd: the connection to the server
+//positions: pointer to an array of count ints where the positions of the keys are saved
+//count: the number of keys of the request
+//returns: 0 on success, -1 if the connection failed or the response doesn't match the request
+int receiveResponse(int fd, int* positions, int count);
+
+#endif
@@ -0,0 +1,204 @@
+#define _GNU_SOURCE //for the nanosecond modification time of stat
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "snapshot.h"
+
+//computes a 64-bit checksum of a block of memory, 8 bytes at a time
+//it detects corruption, it is not meant to resist deliberate tampering
+//data: pointer to the memory
+//size: the size of the memory in bytes
+//returns: the checksum
+static unsigned long long checksum(const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	unsigned long long hash = 0x243F6A8885A308D3ull ^ size;
+
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		unsigned long long word;
+		memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+	}
+
+	return hash ^ (hash >> 32);
+}
+
+//computes the checksum of a header, without its own checksum field
+//header: pointer to the header
+//returns: the checksum
+static unsigned long long headerChecksum(const SnapshotHeader* header)
+{
+	return checksum(header, offsetof(SnapshotHeader, headerChecksum));
+}
+
+int snapshotExists(const char* fileName)
+{
+	return access(fileName, F_OK) == 0;
+}
+
+int snapshotInputIdentity(const char* fileName, unsigned long long* identity)
+{
+	struct stat status;
+	if (stat(fileName, &status) == -1)
+	{
+		printf("Error: cannot open file %s!\n", fileName);
+		return -1;
+	}
+
+	identity[0] = (unsigned long long)status.st_size;
+	identity[1] = (unsigned long long)status.st_mtim.tv_sec * 1000000000ull + (unsigned long long)status.st_mtim.tv_nsec;
+
+	return 0;
+}
+
+int writeSnapshot(const char* fileName, SnapshotKind kind, const unsigned long long* config, const unsigned long long* metadata,
+	const void* payload, size_t payloadSize)
+{
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.version = SNAPSHOT_VERSION;
+	header.kind = kind;
+	memcpy(header.config, config, sizeof(header.config));
+	memcpy(header.metadata, metadata, sizeof(header.metadata));
+	header.payloadSize = payloadSize;
+	header.payloadChecksum = checksum(payload, payloadSize);
+	header.headerChecksum = headerChecksum(&header);
+
+	//the header is padded with zeros up to the payload
+	unsigned char block[SNAPSHOT_PAYLOAD_OFFSET];
+	memset(block, 0, sizeof(block));
+	memcpy(block, &header, sizeof(header));
+
+	//write under a temporary name, so that an interrupted write never leaves a snapshot that looks complete
+	size_t nameLength = strlen(fileName);
+	char* temporaryName = (char*)malloc(nameLength + 5);
+	if (temporaryName == NULL)
+	{
+		return -1;
+	}
+	memcpy(temporaryName, fileName, nameLength);
+	memcpy(temporaryName + nameLength, ".tmp", 5);
+
+	FILE* file = fopen(temporaryName, "wb");
+	if (file == NULL)
+	{
+		free(temporaryName);
+		return -1;
+	}
+
+	int failed = fwrite(block, 1, sizeof(block), file) != sizeof(block);
+	failed |= payloadSize > 0 && fwrite(payload, 1, payloadSize, file) != payloadSize;
+	failed |= fclose(file) != 0;
+	failed = failed || rename(temporaryName, fileName) != 0;
+
+	if (failed)
+	{
+		remove(temporaryName);
+	}
+	free(temporaryName);
+
+	return failed ? -1 : 0;
+}
+
+int openSnapshot(Snapshot* snapshot, const char* fileName, SnapshotKind kind, const unsigned long long* config, int verifyPayload)
+{
+	snapshot->map = NULL;
+	snapshot->mapSize = 0;
+	snapshot->header = NULL;
+	snapshot->payload = NULL;
+
+	int descriptor = open(fileName, O_RDONLY);
+	if (descriptor == -1)
+	{
+		printf("Error: cannot open snapshot %s!\n", fileName);
+		return -1;
+	}
+
+	struct stat status;
+	if (fstat(descriptor, &status) == -1 || status.st_size < SNAPSHOT_PAYLOAD_OFFSET)
+	{
+		close(descriptor);
+		printf("Error: %s is not a snapshot!\n", fileName);
+		return -1;
+	}
+
+	void* map = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (map == MAP_FAILED)
+	{
+		printf("Error: cannot map snapshot %s!\n", fileName);
+		return -1;
+	}
+
+	const SnapshotHeader* header = (const SnapshotHeader*)map;
+	const char* error = NULL;
+	if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+	{
+		error = "is not a snapshot";
+	}
+	else if (header->version != SNAPSHOT_VERSION)
+	{
+		error = "has an unsupported version";
+	}
+	else if (header->headerChecksum != headerChecksum(header))
+	{
+		error = "has a corrupt header";
+	}
+	else if (header->kind != (unsigned int)kind)
+	{
+		error = "holds another kind of structure";
+	}
+	else if (memcmp(header->config, config, sizeof(header->config)) != 0)
+	{
+		error = "was built with another configuration";
+	}
+	else if (header->payloadSize != (unsigned long long)status.st_size - SNAPSHOT_PAYLOAD_OFFSET)
+	{
+		error = "is truncated";
+	}
+	else if (verifyPayload && header->payloadChecksum != checksum((const char*)map + SNAPSHOT_PAYLOAD_OFFSET, header->payloadSize))
+	{
+		error = "has corrupt data";
+	}
+
+	if (error != NULL)
+	{
+		munmap(map, (size_t)status.st_size);
+		printf("Error: snapshot %s %s!\n", fileName, error);
+		return -1;
+	}
+
+	snapshot->map = map;
+	snapshot->mapSize = (size_t)status.st_size;
+	snapshot->header = header;
+	snapshot->payload = (const char*)map + SNAPSHOT_PAYLOAD_OFFSET;
+
+	return 0;
+}
+
+void closeSnapshot(Snapshot* snapshot)
+{
+	if (snapshot->map != NULL)
+	{
+		munmap(snapshot->map, snapshot->mapSize);
+	}
+
+	snapshot->map = NULL;
+	snapshot->mapSize = 0;
+	snapshot->header = NULL;
+	snapshot->payload = NULL;
+}
@@ -0,0 +1,99 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+
+//binary snapshots of built structures, written once and memory-mapped read-only on later runs
+//a snapshot file is a header followed by the payload, the raw array of the structure in the layout of the machine that wrote it
+//the header holds the kind of the structure, the configuration it was built with, metadata such as its size,
+//and checksums of the header itself and of the payload, so that a corrupt snapshot or one built with another configuration is rejected
+//the configuration includes the identity of the input file, its size and modification time, so a snapshot of another input is rejected too
+//the payload checksum is only verified on request, since it reads the whole mapping and opening a snapshot should not touch the payload
+//
+//layout (native byte order):
+//  offset 0: SnapshotHeader
+//  offset SNAPSHOT_PAYLOAD_OFFSET: the payload, payloadSize bytes
+
+//the first bytes of every snapshot file
+#define SNAPSHOT_MAGIC "HDSSNAP"
+
+//the version of the snapshot format, snapshots of other versions are rejected
+#define SNAPSHOT_VERSION 1
+
+//the number of configuration values and of metadata values in the header
+#define SNAPSHOT_NUM_VALUES 8
+
+//the number of configuration values filled by snapshotInputIdentity
+#define SNAPSHOT_INPUT_VALUES 2
+
+//the offset of the payload from the beginning of the file, a multiple of the cache line size
+#define SNAPSHOT_PAYLOAD_OFFSET 256
+
+//the kinds of structures a snapshot can hold
+typedef enum SnapshotKind SnapshotKind;
+enum SnapshotKind
+{
+	SNAPSHOT_HASH_TABLE = 1, //the array of entries of the hash table of hash.c
+	SNAPSHOT_SORTED_ARRAY = 2 //the sorted array of sorted.c
+};
+
+//the header of a snapshot file
+typedef struct SnapshotHeader SnapshotHeader;
+struct SnapshotHeader
+{
+	char magic[8]; //SNAPSHOT_MAGIC
+	unsigned int version; //SNAPSHOT_VERSION
+	unsigned int kind; //the SnapshotKind of the structure
+	unsigned long long config[SNAPSHOT_NUM_VALUES]; //the configuration the structure was built with, it must match when the snapshot is opened
+	unsigned long long metadata[SNAPSHOT_NUM_VALUES]; //values describing the structure, such as its size and occupancy
+	unsigned long long payloadSize; //the size of the payload in bytes
+	unsigned long long payloadChecksum; //the checksum of the payload
+	unsigned long long headerChecksum; //the checksum of all the previous fields of the header
+};
+
+//a snapshot file mapped into memory
+typedef struct Snapshot Snapshot;
+struct Snapshot
+{
+	void* map; //the mapped file, NULL if no snapshot is open
+	size_t mapSize; //the size of the mapped file
+	const SnapshotHeader* header; //the header at the beginning of the mapped file
+	const void* payload; //the payload in the mapped file
+};
+
+//checks whether a snapshot file exists
+//fileName: the path to the snapshot file
+//returns: 1 if the file exists, 0 otherwise
+int snapshotExists(const char* fileName);
+
+//fills the identity of the input file a structure is built from: its size and its modification time in nanoseconds
+//fileName: the path to the input file
+//identity: array of SNAPSHOT_INPUT_VALUES values where the identity is saved
+//returns: 0 on success, -1 if the file doesn't exist, the reason is printed
+int snapshotInputIdentity(const char* fileName, unsigned long long* identity);
+
+//writes a snapshot file, the file is written under a temporary name first and renamed when it is complete
+//fileName: the path to the snapshot file
+//kind: the kind of the structure
+//config: SNAPSHOT_NUM_VALUES values of the configuration the structure was built with
+//metadata: SNAPSHOT_NUM_VALUES values describing the structure
+//payload: pointer to the data of the structure
+//payloadSize: the size of the data in bytes
+//returns: 0 on success, -1 if the file could not be written
+int writeSnapshot(const char* fileName, SnapshotKind kind, const unsigned long long* config, const unsigned long long* metadata,
+	const void* payload, size_t payloadSize);
+
+//maps a snapshot file into memory read-only and checks it
+//snapshot: pointer to the snapshot
+//fileName: the path to the snapshot file
+//kind: the expected kind of the structure
+//config: SNAPSHOT_NUM_VALUES values of the expected configuration
+//verifyPayload: 1 to verify the checksum of the payload, which reads all of it, 0 to check only the header and the size
+//returns: 0 on success, -1 if the file could not be mapped, is corrupt, or holds another kind or configuration, the reason is printed
+int openSnapshot(Snapshot* snapshot, const char* fileName, SnapshotKind kind, const unsigned long long* config, int verifyPayload);
+
+//unmaps a snapshot file, pointers into its payload become invalid
+//snapshot: pointer to the snapshot
+void closeSnapshot(Snapshot* snapshot);
+
+#endif
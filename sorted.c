@@ -1,65 +1,153 @@
 
 #include <stdlib.h> 
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
+#include <pthread.h>
 
+#include "benchmark.h"
+#include "bloomfilter.h"
+#include "loader.h"
+#include "searchindex.h"
+#include "server.h"
+#include "snapshot.h"
 
-const int MAX_INPUT_SIZE = 1000;  //maximum number of elements for storage in the hash table
+const int INITIAL_INPUT_SIZE = 1024; //initial capacity of the input array, the array grows as more values are read
 const int MAX_SEARCH_SIZE = 1000; //maximum number of elements for search
+#define INSERTION_SORT_THRESHOLD 24 //ranges shorter than this are sorted by insertion sort in introsort and pdqsort
+#define NINTHER_THRESHOLD 128 //pdqsort takes the pivot as the median of three medians of three for ranges longer than this
+#define PARTIAL_INSERTION_SORT_LIMIT 8 //the number of moves after which pdqsort gives up sorting a partition it guesses is nearly sorted
+#define RADIX_BITS 8 //the number of bits of the key sorted by one pass of the radix sort
+#define RADIX_BUCKETS (1 << RADIX_BITS) //the number of buckets of one pass of the radix sort
+#define MAX_SORT_THREADS 64 //maximum number of threads of the parallel sort, a bucket number fits into an unsigned char
+const int MIN_SORT_THREAD_ITEMS = 16384; //minimum number of values per thread of the parallel sort, fewer threads are used for smaller inputs
+#define SAMPLES_PER_BUCKET 32 //the number of values sampled per bucket of the parallel sort for choosing the splitters
+
+//the algorithms that can be used for sorting the input data
+typedef enum SortEngine SortEngine;
+enum SortEngine { SORT_SELECTION, SORT_RADIX, SORT_INTROSORT, SORT_PDQSORT };
+
+//the counters of a sort, every engine fills in its own
+//the comparison sorts count comparisons of two values and swaps, where moving a value one place during an insertion sort counts as a swap,
+//the radix sort counts the passes it performs and the values it moves
+typedef struct SortCounters SortCounters;
+struct SortCounters
+{
+	long long comparisons; //the number of comparisons, or of passes for the radix sort
+	long long swaps; //the number of swaps, or of moved values for the radix sort
+};
 								  
 //reads the specified number of values from the specified file into the specified array
 //fileName: the path to the input file
 //data: pointer to an array of int where the values are stored
 //size: the size of the array, no more than this amount of values will be read
+//stats: pointer to the structure where the statistics of the loading are saved
 //returns: number of values that was actually read
-int readData(char* fileName, int* data, int size)
+int readData(char* fileName, int* data, int size, LoadStats* stats)
 {
 	//try to open the input file
-	FILE* file;
-	file = fopen(fileName, "r");
-	if (file == NULL) //unable to open the file
+	IntReader reader;
+	if (openIntReader(&reader, fileName) == -1) //unable to open the file
 	{
 		printf("Error: cannot open file %s!\n", fileName);
 		return 0; //nothing was read
 	}
 
-	int i; //here we count the number of values read
-
 	//read at most size values
-	for (i = 0; i < size; ++i)
+	int numRead = readInts(&reader, data, size);
+
+	//close the file
+	closeIntReader(&reader, stats);
+
+	//return the number of values read
+	return numRead > 0 ? numRead : 0;
+}
+
+//reads all the values from the specified file into an array that grows as more values are read
+//fileName: the path to the input file
+//data: the pointer to the allocated array is saved here, NULL if nothing was read
+//stats: pointer to the structure where the statistics of the loading are saved
+//returns: number of values that was actually read
+int readAllData(char* fileName, int** data, LoadStats* stats)
+{
+	*data = NULL;
+
+	//try to open the input file
+	IntReader reader;
+	if (openIntReader(&reader, fileName) == -1) //unable to open the file
+	{
+		printf("Error: cannot open file %s!\n", fileName);
+		return 0; //nothing was read
+	}
+
+	int capacity = INITIAL_INPUT_SIZE;
+	int size = 0;
+	int* array = (int*)malloc(sizeof(int) * capacity);
+
+	//read into the free space of the array, double it whenever it is full
+	while (array != NULL)
 	{
-		//if we have reached the end of the file, terminate
-		if (fscanf(file, "%d", &(data[i])) == EOF)
+		if (size == capacity)
+		{
+			int* grown = capacity <= 0x3fffffff ? (int*)realloc(array, sizeof(int) * (size_t)capacity * 2) : NULL;
+			if (grown == NULL)
+			{
+				free(array);
+				array = NULL;
+				break;
+			}
+			array = grown;
+			capacity *= 2;
+		}
+
+		int numRead = readInts(&reader, array + size, capacity - size);
+		if (numRead <= 0)
 		{
 			break;
 		}
+		size += numRead;
 	}
 
 	//close the file
-	fclose(file);
+	closeIntReader(&reader, stats);
 
-	//return the number of values read
-	return i;
+	if (array == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return 0;
+	}
+	if (size == 0)
+	{
+		free(array);
+		return 0;
+	}
+
+	*data = array;
+
+	return size;
 }
 
-//reads the values from both the input files and stores them in their respective arrays using the readData function
+//reads the values from both the input files and stores them in their respective arrays using the readAllData and readData functions
 //inputFile: path to the file with input values
-//inputData: pointer to an array where to store the input values
+//inputData: the pointer to the array of the input values is saved here
 //inputSize: the number of values that was actually read from the input file is saved here
 //searchFile: path to the file with search values
 //searchData: pointer to an array where to store the search values
 //searchSize: the number of values that was actually read fro the search file is saved here
+//inputLoad: the statistics of loading the input file are saved here
+//searchLoad: the statistics of loading the search file are saved here
 //returns: 0 if some values were read from both files, -1 otherwise
-int readInputs(char* inputFile, int* inputData, int* inputSize, char* searchFile, int* searchData, int* searchSize)
+int readInputs(char* inputFile, int** inputData, int* inputSize, char* searchFile, int* searchData, int* searchSize,
+	LoadStats* inputLoad, LoadStats* searchLoad)
 {
-	*inputSize = readData(inputFile, inputData, MAX_INPUT_SIZE);
+	*inputSize = readAllData(inputFile, inputData, inputLoad);
 	if (*inputSize == 0)
 	{
 		printf("Error: No input data loaded from file %s!\n", inputFile);
 		return -1; //nothing read from the input file
 	}
 
-	*searchSize = readData(searchFile, searchData, MAX_SEARCH_SIZE);
+	*searchSize = readData(searchFile, searchData, MAX_SEARCH_SIZE, searchLoad);
 	if (*searchSize == 0)
 	{
 		printf("Error: No retrieval data loaded from file %s!\n", searchFile);
@@ -74,7 +162,7 @@ int readInputs(char* inputFile, int* inputData, int* inputSize, char* searchFile
 //size: the size of the array
 //comparisons: the number of comparisons that the algorithm performs gets saved here
 //swaps: the number of swaps that the algorithm performs gets saved here
-void selectionSort(int* data, int size, int* comparisons, int* swaps)
+void selectionSort(int* data, int size, long long* comparisons, long long* swaps)
 {
 	//initialize the counters
 	*comparisons = 0;
@@ -110,219 +198,2187 @@ void selectionSort(int* data, int size, int* comparisons, int* swaps)
 	}
 }
 
-//performs binary search on a sorted array (in ascending order)
-//data: pointer to the sorted array
-//size: the size of the sorted array
-//value: the value to search for
-//returns: the index in the array where the searched value is located, -1 if it is not found
-int binarySearch(int* data, int size, int value)
+//compares two values and counts the comparison
+//a: the first value
+//b: the second value
+//counters: pointer to the counters of the sort
+//returns: 1 if a is smaller than b, 0 otherwise
+static inline int lessThan(int a, int b, SortCounters* counters)
 {
-	//the boundaries of the currently searched range in the array
-	//initially the whole array
-	int left = 0;
-	int right = size - 1;
-	
-	while (left <= right)
+	counters->comparisons++;
+	return a < b;
+}
+
+//swaps two elements of an array and counts the swap
+//data: pointer to the array
+//i: the index of the first element
+//j: the index of the second element
+//counters: pointer to the counters of the sort
+static inline void swapElements(int* data, int i, int j, SortCounters* counters)
+{
+	int aux = data[i];
+	data[i] = data[j];
+	data[j] = aux;
+	counters->swaps++;
+}
+
+//returns the base 2 logarithm of a positive number, rounded down
+//n: the number
+//returns: the logarithm
+static int floorLog2(int n)
+{
+	int log = 0;
+	while (n > 1)
 	{
-		//divide the range in half
-		int middle = (left + right) / 2;
+		n >>= 1;
+		log++;
+	}
 
-		//if the searched value is greater than the middle element, continue searching in the right portion of the original range
-		if (data[middle] < value)
+	return log;
+}
+
+//sorts a range of an array by insertion sort
+//data: pointer to the array
+//begin: the index of the first element of the range
+//end: the index after the last element of the range
+//counters: pointer to the counters of the sort
+static void insertionSortRange(int* data, int begin, int end, SortCounters* counters)
+{
+	for (int i = begin + 1; i < end; ++i)
+	{
+		int value = data[i];
+		int j = i;
+		while (j > begin && lessThan(value, data[j - 1], counters))
 		{
-			left = middle + 1;
+			data[j] = data[j - 1];
+			counters->swaps++;
+			j--;
 		}
-		//if the searched value is smaller than the middle element, continue searching in the left portion of the original range
-		else if (data[middle] > value)
+		data[j] = value;
+	}
+}
+
+//sorts a range of an array by insertion sort without checking the beginning of the range,
+//the element before the range must not be greater than any element of the range
+//data: pointer to the array
+//begin: the index of the first element of the range, greater than 0
+//end: the index after the last element of the range
+//counters: pointer to the counters of the sort
+static void unguardedInsertionSortRange(int* data, int begin, int end, SortCounters* counters)
+{
+	for (int i = begin + 1; i < end; ++i)
+	{
+		int value = data[i];
+		int j = i;
+		while (lessThan(value, data[j - 1], counters))
 		{
-			right = middle - 1;
+			data[j] = data[j - 1];
+			counters->swaps++;
+			j--;
 		}
-		//if the searched value is equal to the middle element, we have found our value
-		else
+		data[j] = value;
+	}
+}
+
+//moves an element of a heap down until it is not smaller than its children
+//data: pointer to the array, the heap starts at its first element
+//root: the index of the element in the heap
+//size: the size of the heap
+//counters: pointer to the counters of the sort
+static void siftDown(int* data, int root, int size, SortCounters* counters)
+{
+	while (2 * root + 1 < size)
+	{
+		int child = 2 * root + 1;
+		if (child + 1 < size && lessThan(data[child], data[child + 1], counters))
 		{
-			return middle;
+			child++;
+		}
+		if (!lessThan(data[root], data[child], counters))
+		{
+			return;
 		}
+		swapElements(data, root, child, counters);
+		root = child;
 	}
-
-	return -1; //the searched value is not in the array
 }
 
-//prints the statistics
-//inputFile: the path to the input file
-//searchFile: the path to the search file
-//inputSize: the size of the input array
-//searchData: pointer to an array where the search values are stored
-//searchSize: the size of the search array
-//positions: pointer to an array of the same size as searchData that contains the indices where the corresponding search elements were found in the input array
-//comparisons: the number of comparisons performed by the selection sort algorithm
-//swaps: the number of swaps performed by the selection sort algorithm
-//storageTime: the time in miliseconds that the storage took
-//searchTime: the time in miliseconds that the search took
-void printStats(char* inputFile, char* searchFile, int inputSize, int* searchData, int searchSize,
-	int* positions, int comparisons, int swaps, float storageTime, float searchTime)
+//sorts a range of an array by heapsort, the fallback of introsort and pdqsort that guarantees O(n log n)
+//data: pointer to the array
+//begin: the index of the first element of the range
+//end: the index after the last element of the range
+//counters: pointer to the counters of the sort
+static void heapSortRange(int* data, int begin, int end, SortCounters* counters)
 {
-	printf("Data storage and retrieval:\n");
-	printf("a comparison of hashing and directed search of sorted data\n");
-	printf("================================\n\n");
+	int* heap = data + begin;
+	int size = end - begin;
 
-	printf("Input data loaded from file %s\n", inputFile);
-	printf("Retrieval data loaded from file %s\n", searchFile);
-	printf("Storage Method: Directed search of sorted data\n");
-	printf("Number of items stored in the array: %d\n", inputSize);
-	printf("Number of items searched: %d\n", searchSize);
+	for (int i = size / 2 - 1; i >= 0; --i)
+	{
+		siftDown(heap, i, size, counters);
+	}
+	for (int i = size - 1; i > 0; --i)
+	{
+		swapElements(heap, 0, i, counters);
+		siftDown(heap, 0, i, counters);
+	}
+}
 
-	int numFound = 0;
-	for (int i = 0; i < searchSize; ++i)
+//sorts three elements of an array
+//data: pointer to the array
+//a: the index of the element that gets the smallest value
+//b: the index of the element that gets the middle value
+//c: the index of the element that gets the largest value
+//counters: pointer to the counters of the sort
+static void sortThree(int* data, int a, int b, int c, SortCounters* counters)
+{
+	if (lessThan(data[b], data[a], counters))
 	{
-		if (positions[i] != -1)
+		swapElements(data, a, b, counters);
+	}
+	if (lessThan(data[c], data[b], counters))
+	{
+		swapElements(data, b, c, counters);
+		if (lessThan(data[b], data[a], counters))
 		{
-			numFound++;
+			swapElements(data, a, b, counters);
 		}
 	}
+}
 
-	printf("Number of items found: %d\n\n", numFound);
+//sorts a range of an array by quicksort with the median of three as the pivot,
+//switches to heapsort when the recursion gets too deep and leaves short ranges for the final insertion sort
+//data: pointer to the array
+//begin: the index of the first element of the range
+//end: the index after the last element of the range
+//depthLimit: the number of partitionings left before switching to heapsort
+//counters: pointer to the counters of the sort
+static void introSortLoop(int* data, int begin, int end, int depthLimit, SortCounters* counters)
+{
+	while (end - begin > INSERTION_SORT_THRESHOLD)
+	{
+		if (depthLimit == 0)
+		{
+			heapSortRange(data, begin, end, counters);
+			return;
+		}
+		depthLimit--;
 
-	printf("Storage details:\n\n");
+		//the median of the first, middle and last elements becomes the pivot at the beginning of the range,
+		//the smallest and largest of them stop the partitioning loops at both ends
+		sortThree(data, begin + 1, begin + (end - begin) / 2, end - 1, counters);
+		swapElements(data, begin, begin + (end - begin) / 2, counters);
+		int pivot = data[begin];
 
-	printf("  <%d> comparisons performed\n", comparisons);
-	printf("  <%d> swaps performed\n\n", swaps);
+		int first = begin + 1;
+		int last = end;
+		while (1)
+		{
+			while (lessThan(data[first], pivot, counters))
+			{
+				first++;
+			}
+			last--;
+			while (lessThan(pivot, data[last], counters))
+			{
+				last--;
+			}
+			if (first >= last)
+			{
+				break;
+			}
+			swapElements(data, first, last, counters);
+			first++;
+		}
 
-	printf("Retrieval details:\n\n");
+		//sort the right part recursively and continue with the left part
+		introSortLoop(data, first, end, depthLimit, counters);
+		end = first;
+	}
+}
 
-	for (int i = 0; i < searchSize; ++i)
+//performs the introsort algorithm to sort an array in an ascending order:
+//quicksort that switches to heapsort when it recurses deeper than 2 log n, followed by one insertion sort over the whole array
+//data: pointer to an array to be sorted
+//size: the size of the array
+//comparisons: the number of comparisons that the algorithm performs gets saved here
+//swaps: the number of swaps that the algorithm performs gets saved here
+void introSort(int* data, int size, long long* comparisons, long long* swaps)
+{
+	SortCounters counters = { 0, 0 };
+
+	if (size > 1)
 	{
-		if (positions[i] != -1)
+		introSortLoop(data, 0, size, 2 * floorLog2(size), &counters);
+		insertionSortRange(data, 0, size, &counters);
+	}
+
+	*comparisons = counters.comparisons;
+	*swaps = counters.swaps;
+}
+
+//sorts a range of an array by insertion sort unless it takes too many moves, used by pdqsort on partitions that look sorted
+//data: pointer to the array
+//begin: the index of the first element of the range
+//end: the index after the last element of the range
+//counters: pointer to the counters of the sort
+//returns: 1 if the range was sorted, 0 if the sorting was given up
+static int partialInsertionSort(int* data, int begin, int end, SortCounters* counters)
+{
+	int numMoves = 0;
+
+	for (int i = begin + 1; i < end; ++i)
+	{
+		if (lessThan(data[i], data[i - 1], counters))
 		{
-			printf("  Value %d found in the sorted array at position %d\n", searchData[i], positions[i]);
+			int value = data[i];
+			int j = i;
+			do
+			{
+				data[j] = data[j - 1];
+				counters->swaps++;
+				j--;
+			} while (j > begin && lessThan(value, data[j - 1], counters));
+			data[j] = value;
+			numMoves += i - j;
 		}
-		else
+
+		if (numMoves > PARTIAL_INSERTION_SORT_LIMIT)
 		{
-			printf("  Value %d not found in the sorted array\n", searchData[i]);
+			return 0;
 		}
 	}
 
-	printf("\nExecution times:\n\n");
-
-	printf("  Time to store data: %f ms\n", storageTime);
-	printf("  Time to retrieve data: %f ms\n\n", searchTime);
-
-	printf("================================\n\n");
+	return 1;
 }
 
-//copies one array into another array
-//source: pointer to the array that is copied
-//destination: pointer to the array that is copied into
-//size: the number of elements to be copied
-void copyArray(int* source, int* destination, int size)
+//partitions a range of an array around its first element, the elements equal to the pivot go to the right part
+//data: pointer to the array
+//begin: the index of the first element of the range, the pivot
+//end: the index after the last element of the range
+//alreadyPartitioned: set to 1 if no elements had to be swapped
+//counters: pointer to the counters of the sort
+//returns: the final index of the pivot
+static int partitionRight(int* data, int begin, int end, int* alreadyPartitioned, SortCounters* counters)
 {
-	for (int i = 0; i < size; ++i)
+	int pivot = data[begin];
+	int first = begin;
+	int last = end;
+
+	//the median of three guarantees an element that is not smaller than the pivot, so the first loop needs no bound,
+	//the second loop is bounded only if the first one found no smaller element
+	while (lessThan(data[++first], pivot, counters));
+	if (first - 1 == begin)
 	{
-		destination[i] = source[i];
+		while (first < last && !lessThan(data[--last], pivot, counters));
+	}
+	else
+	{
+		while (!lessThan(data[--last], pivot, counters));
+	}
+
+	*alreadyPartitioned = first >= last;
+
+	while (first < last)
+	{
+		swapElements(data, first, last, counters);
+		while (lessThan(data[++first], pivot, counters));
+		while (!lessThan(data[--last], pivot, counters));
 	}
+
+	//put the pivot between the parts
+	int pivotIndex = first - 1;
+	data[begin] = data[pivotIndex];
+	data[pivotIndex] = pivot;
+	counters->swaps++;
+
+	return pivotIndex;
 }
 
-int main(int argc, char* argv[])
+//partitions a range of an array around its first element, the elements equal to the pivot go to the left part,
+//used when the pivot equals the element before the range, so all of the left part is equal and needs no more sorting
+//data: pointer to the array
+//begin: the index of the first element of the range, the pivot
+//end: the index after the last element of the range
+//counters: pointer to the counters of the sort
+//returns: the final index of the pivot
+static int partitionLeft(int* data, int begin, int end, SortCounters* counters)
 {
-	//check the number of arguments
-	if (argc != 3)
+	int pivot = data[begin];
+	int first = begin;
+	int last = end;
+
+	while (lessThan(pivot, data[--last], counters));
+	if (last + 1 == end)
 	{
-		//wrong number of arguments
-		printf("Error: 2 arguments required!\n");
-		return -1;
+		while (first < last && !lessThan(pivot, data[++first], counters));
 	}
-
-	//try to allocate memory for the input array
-	int* inputData = (int*)malloc(sizeof(int) * MAX_INPUT_SIZE);
-	if (inputData == NULL)
+	else
 	{
-		//unable to allocate memory, exit
-		printf("Error: couldn't allocate memory!\n");
-		return -1;
+		while (!lessThan(pivot, data[++first], counters));
 	}
 
-	//try to allocate memory for the search array
-	int* searchData = (int*)malloc(sizeof(int) * MAX_SEARCH_SIZE);
-	if (searchData == NULL)
+	while (first < last)
 	{
-		//unable to allocate memory, free memory and exit
-		printf("Error: couldn't allocate memory!\n");
-		free(inputData); 
-		return -1;
+		swapElements(data, first, last, counters);
+		while (lessThan(pivot, data[--last], counters));
+		while (!lessThan(pivot, data[++first], counters));
 	}
 
-	//try to read the data from the input files
-	int inputSize;
-	int searchSize;
-	if (readInputs(argv[1], inputData, &inputSize, argv[2], searchData, &searchSize) == -1)
+	data[begin] = data[last];
+	data[last] = pivot;
+	counters->swaps++;
+
+	return last;
+}
+
+//sorts a range of an array by pattern-defeating quicksort
+//data: pointer to the array
+//begin: the index of the first element of the range
+//end: the index after the last element of the range
+//badAllowed: the number of highly unbalanced partitionings left before switching to heapsort
+//leftmost: 1 if the range is at the beginning of the array, otherwise the element before the range is not greater than any element in it
+//counters: pointer to the counters of the sort
+static void pdqSortLoop(int* data, int begin, int end, int badAllowed, int leftmost, SortCounters* counters)
+{
+	while (1)
 	{
-		//error while reading, free memory and exit
-		free(inputData);
-		free(searchData);
-		return -1;
+		int size = end - begin;
+
+		if (size < INSERTION_SORT_THRESHOLD)
+		{
+			if (leftmost)
+			{
+				insertionSortRange(data, begin, end, counters);
+			}
+			else
+			{
+				unguardedInsertionSortRange(data, begin, end, counters);
+			}
+			return;
+		}
+
+		//move the pivot to the beginning of the range, the median of three or the median of three medians of three for long ranges
+		int half = size / 2;
+		if (size > NINTHER_THRESHOLD)
+		{
+			sortThree(data, begin, begin + half, end - 1, counters);
+			sortThree(data, begin + 1, begin + half - 1, end - 2, counters);
+			sortThree(data, begin + 2, begin + half + 1, end - 3, counters);
+			sortThree(data, begin + half - 1, begin + half, begin + half + 1, counters);
+			swapElements(data, begin, begin + half, counters);
+		}
+		else
+		{
+			sortThree(data, begin + half, begin, end - 1, counters);
+		}
+
+		//a pivot equal to the element before the range is the smallest value of the range, put all the elements equal to it on the left and skip them
+		if (!leftmost && !lessThan(data[begin - 1], data[begin], counters))
+		{
+			begin = partitionLeft(data, begin, end, counters) + 1;
+			continue;
+		}
+
+		int alreadyPartitioned;
+		int pivotIndex = partitionRight(data, begin, end, &alreadyPartitioned, counters);
+
+		int leftSize = pivotIndex - begin;
+		int rightSize = end - (pivotIndex + 1);
+		if (leftSize < size / 8 || rightSize < size / 8)
+		{
+			//too many bad pivots, the input defeats the pivot selection
+			if (--badAllowed == 0)
+			{
+				heapSortRange(data, begin, end, counters);
+				return;
+			}
+
+			//break the patterns that led to the bad pivot by swapping some elements of both parts
+			if (leftSize >= INSERTION_SORT_THRESHOLD)
+			{
+				swapElements(data, begin, begin + leftSize / 4, counters);
+				swapElements(data, pivotIndex - 1, pivotIndex - leftSize / 4, counters);
+				if (leftSize > NINTHER_THRESHOLD)
+				{
+					swapElements(data, begin + 1, begin + (leftSize / 4 + 1), counters);
+					swapElements(data, begin + 2, begin + (leftSize / 4 + 2), counters);
+					swapElements(data, pivotIndex - 2, pivotIndex - (leftSize / 4 + 1), counters);
+					swapElements(data, pivotIndex - 3, pivotIndex - (leftSize / 4 + 2), counters);
+				}
+			}
+			if (rightSize >= INSERTION_SORT_THRESHOLD)
+			{
+				swapElements(data, pivotIndex + 1, pivotIndex + 1 + rightSize / 4, counters);
+				swapElements(data, end - 1, end - rightSize / 4, counters);
+				if (rightSize > NINTHER_THRESHOLD)
+				{
+					swapElements(data, pivotIndex + 2, pivotIndex + 2 + rightSize / 4, counters);
+					swapElements(data, pivotIndex + 3, pivotIndex + 3 + rightSize / 4, counters);
+					swapElements(data, end - 2, end - (1 + rightSize / 4), counters);
+					swapElements(data, end - 3, end - (2 + rightSize / 4), counters);
+				}
+			}
+		}
+		else if (alreadyPartitioned && partialInsertionSort(data, begin, pivotIndex, counters)
+			&& partialInsertionSort(data, pivotIndex + 1, end, counters))
+		{
+			//a balanced partitioning that moved nothing suggests sorted input, both parts were sorted with few moves
+			return;
+		}
+
+		//sort the left part recursively and continue with the right part
+		pdqSortLoop(data, begin, pivotIndex, badAllowed, leftmost, counters);
+		begin = pivotIndex + 1;
+		leftmost = 0;
 	}
+}
 
-	//try to allocate memory for the sorted array
-	int* sortedData = (int*)malloc(sizeof(int) * MAX_INPUT_SIZE);
-	if (sortedData == NULL)
+//performs pattern-defeating quicksort to sort an array in an ascending order:
+//quicksort that detects partitions that are already sorted and finishes them by insertion sort, so ascending and descending inputs take linear time,
+//groups runs of equal values, breaks up patterns that lead to bad pivots and switches to heapsort if they keep occurring
+//data: pointer to an array to be sorted
+//size: the size of the array
+//comparisons: the number of comparisons that the algorithm performs gets saved here
+//swaps: the number of swaps that the algorithm performs gets saved here
+void pdqSort(int* data, int size, long long* comparisons, long long* swaps)
+{
+	SortCounters counters = { 0, 0 };
+
+	if (size > 1)
 	{
-		//unable to allocate memory, free memory and exit
-		printf("Error: couldn't allocate memory!\n");
-		free(inputData);
-		free(searchData);
-		return -1;
+		pdqSortLoop(data, 0, size, floorLog2(size), 1, &counters);
 	}
-	
-	int comparisons;
-	int swaps;
-	clock_t totalTime = 0;
-	clock_t lastTime;
-	//do the selection sort many times, measure the total time
-	for (int i = 0; i < 100000; ++i)
-	{
-		//replace the sorted data with the original data and repeat the sorting
-		copyArray(inputData, sortedData, inputSize);
-		lastTime = clock();
-		selectionSort(sortedData, inputSize, &comparisons, &swaps);
-		totalTime += clock() - lastTime;
-	}
-	//compute the time of one execution of selection sort
-	float storageTime = ((((float)totalTime) / CLOCKS_PER_SEC) * 1000) / (100000);
-	
-	//try to allocate memory for the array of the indices where the corresponding search elements were found in the input array
-	int* positions = (int*)malloc(sizeof(int) * MAX_SEARCH_SIZE);
-	if (positions == NULL)
+
+	*comparisons = counters.comparisons;
+	*swaps = counters.swaps;
+}
+
+//performs LSD radix sort to sort an array in an ascending order, RADIX_BITS bits of the key per pass from the lowest,
+//the sign bit is flipped in the last pass so that negative values come first
+//a pass in which all the values have the same digit is skipped
+//data: pointer to an array to be sorted
+//size: the size of the array
+//passes: the number of passes that the algorithm performs gets saved here
+//moves: the number of values that the algorithm moves gets saved here
+//returns: 0 on success, -1 if the memory for the buffer could not be allocated
+int radixSort(int* data, int size, long long* passes, long long* moves)
+{
+	*passes = 0;
+	*moves = 0;
+
+	int* buffer = (int*)malloc(sizeof(int) * (size_t)(size > 0 ? size : 1));
+	if (buffer == NULL)
 	{
-		//unable to allocate memory, free memory and exit
-		printf("Error: couldn't allocate memory!\n");
-		free(inputData);
-		free(sortedData);
-		free(searchData);
 		return -1;
 	}
 
-	//do the binary search many times, measure the total time
-	totalTime = 0;
-	for (int i = 0; i < 100000; ++i)
+	int* source = data;
+	int* destination = buffer;
+	for (int shift = 0; shift < 32; shift += RADIX_BITS)
 	{
-		for (int j = 0; j < searchSize; ++j)
+		unsigned int flip = shift + RADIX_BITS >= 32 ? 0x80000000u : 0;
+
+		//count the values with every digit
+		int counts[RADIX_BUCKETS] = { 0 };
+		for (int i = 0; i < size; ++i)
 		{
-			lastTime = clock();
-			positions[j] = binarySearch(sortedData, inputSize, searchData[j]);
-			totalTime += clock() - lastTime;
+			counts[(((unsigned int)source[i] ^ flip) >> shift) & (RADIX_BUCKETS - 1)]++;
 		}
-	}
-	//compute the time of one execution of binary search
-	//totalTime = clock() - lastTime;
-	float searchTime = ((((float)totalTime) / CLOCKS_PER_SEC) * 1000) / (100000 * searchSize);
-	
-	//print the stats
-	printStats(argv[1], argv[2], inputSize, searchData, searchSize, positions, comparisons, swaps, storageTime, searchTime);
 
-	//free the memory
-	free(inputData);
-	free(sortedData);
-	free(searchData);
-	free(positions);
+		//skip the pass if all the values fall into one bucket
+		if (size == 0 || counts[(((unsigned int)source[0] ^ flip) >> shift) & (RADIX_BUCKETS - 1)] == size)
+		{
+			continue;
+		}
 
-	return 0;
-}
\ No newline at end of file
+		//turn the counts into the starting positions of the buckets and scatter the values into them
+		int position = 0;
+		for (int digit = 0; digit < RADIX_BUCKETS; ++digit)
+		{
+			int count = counts[digit];
+			counts[digit] = position;
+			position += count;
+		}
+		for (int i = 0; i < size; ++i)
+		{
+			destination[counts[(((unsigned int)source[i] ^ flip) >> shift) & (RADIX_BUCKETS - 1)]++] = source[i];
+		}
+
+		int* aux = source;
+		source = destination;
+		destination = aux;
+		(*passes)++;
+		*moves += size;
+	}
+
+	//after an odd number of passes the sorted values are in the buffer
+	if (source != data)
+	{
+		memcpy(data, source, sizeof(int) * (size_t)size);
+		*moves += size;
+	}
+
+	free(buffer);
+
+	return 0;
+}
+
+//sorts an array in an ascending order with the selected engine
+//engine: the sorting algorithm
+//data: pointer to an array to be sorted
+//size: the size of the array
+//comparisons: the number of comparisons, or of passes for the radix sort, gets saved here
+//swaps: the number of swaps, or of moved values for the radix sort, gets saved here
+//returns: 0 on success, -1 if the memory the engine needs could not be allocated
+int sortData(SortEngine engine, int* data, int size, long long* comparisons, long long* swaps)
+{
+	switch (engine)
+	{
+	case SORT_RADIX:
+		return radixSort(data, size, comparisons, swaps);
+	case SORT_INTROSORT:
+		introSort(data, size, comparisons, swaps);
+		return 0;
+	case SORT_PDQSORT:
+		pdqSort(data, size, comparisons, swaps);
+		return 0;
+	default:
+		selectionSort(data, size, comparisons, swaps);
+		return 0;
+	}
+}
+
+//returns the name of a sort engine as it is given on the command line
+//engine: the sort engine
+//returns: the name of the engine
+const char* sortEngineName(SortEngine engine)
+{
+	switch (engine)
+	{
+	case SORT_RADIX:
+		return "radix";
+	case SORT_INTROSORT:
+		return "introsort";
+	case SORT_PDQSORT:
+		return "pdqsort";
+	default:
+		return "selection";
+	}
+}
+
+//the time of every phase of the parallel sort, summed over all the repetitions
+typedef struct SortPhaseTimes SortPhaseTimes;
+struct SortPhaseTimes
+{
+	int numThreads; //the number of threads of the last sort, 1 if it was sorted on one thread and no phases were timed
+	double sampleTime; //the time in miliseconds of sampling the values and choosing the splitters
+	double partitionTime; //the time in miliseconds of counting the values of every bucket and scattering them into the buckets
+	double sortTime; //the time in miliseconds of sorting the buckets and copying them back
+};
+
+//the work of one thread of a parallel sample sort
+//the array is split into equal chunks, one per thread, and the values into buckets by the splitters, one bucket per thread
+typedef struct SortThread SortThread;
+struct SortThread
+{
+	pthread_t thread; //the thread
+	int id; //the number of the thread, it is also the number of its bucket
+	int numThreads; //the number of threads of the sort
+	SortEngine engine; //the algorithm that sorts the buckets
+	int* data; //the array being sorted
+	int* buffer; //the array the values are partitioned into, shared by all threads
+	unsigned char* buckets; //the bucket of every value of the array, shared by all threads
+	const int* splitters; //the numThreads - 1 sorted values that separate the buckets, shared by all threads
+	int first; //the first value of the chunk of the thread
+	int last; //one past the last value of the chunk of the thread
+	int offsets[MAX_SORT_THREADS]; //the number of values of the chunk in every bucket, then the positions in buffer where they are written
+	int start; //the position in buffer of the first value of the bucket of the thread
+	int end; //one past the position in buffer of the last value of the bucket of the thread
+	long long comparisons; //the number of comparisons, or of passes, of sorting the bucket
+	long long swaps; //the number of swaps, or of moved values, of sorting the bucket
+	int failed; //1 if it was not possible to allocate the memory
+};
+
+//returns the current time of the monotonic clock
+//returns: the time in miliseconds
+double wallTime()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+//finds the bucket of every value of the chunk of the thread and counts the values of the chunk in every bucket
+//the bucket of a value is the number of splitters that are not greater than it
+//arg: pointer to the SortThread
+//returns: NULL
+void* countBuckets(void* arg)
+{
+	SortThread* sort = (SortThread*)arg;
+	int numSplitters = sort->numThreads - 1;
+
+	for (int b = 0; b < sort->numThreads; ++b)
+	{
+		sort->offsets[b] = 0;
+	}
+
+	for (int i = sort->first; i < sort->last; ++i)
+	{
+		int value = sort->data[i];
+		int bucket = 0;
+		int count = numSplitters;
+		while (count > 0)
+		{
+			int half = count / 2;
+			if (sort->splitters[bucket + half] <= value)
+			{
+				bucket += half + 1;
+				count -= half + 1;
+			}
+			else
+			{
+				count = half;
+			}
+		}
+
+		sort->buckets[i] = (unsigned char)bucket;
+		sort->offsets[bucket]++;
+	}
+
+	return NULL;
+}
+
+//writes the values of the chunk of the thread to their buckets in the buffer
+//arg: pointer to the SortThread, its offsets are the positions where the values of each bucket are written
+//returns: NULL
+void* scatterBuckets(void* arg)
+{
+	SortThread* sort = (SortThread*)arg;
+
+	for (int i = sort->first; i < sort->last; ++i)
+	{
+		sort->buffer[sort->offsets[sort->buckets[i]]++] = sort->data[i];
+	}
+
+	return NULL;
+}
+
+//sorts the bucket of the thread in the buffer and copies it back to its final place in the array
+//arg: pointer to the SortThread
+//returns: NULL
+void* sortBucket(void* arg)
+{
+	SortThread* sort = (SortThread*)arg;
+
+	if (sortData(sort->engine, sort->buffer + sort->start, sort->end - sort->start, &sort->comparisons, &sort->swaps) == -1)
+	{
+		sort->failed = 1;
+		return NULL;
+	}
+	memcpy(sort->data + sort->start, sort->buffer + sort->start, sizeof(int) * (size_t)(sort->end - sort->start));
+
+	return NULL;
+}
+
+//runs a phase of a parallel sort on all the threads and waits for them to finish
+//threads: the threads of the sort
+//numThreads: the number of threads
+//work: the function the threads run
+void runSortThreads(SortThread* threads, int numThreads, void* (*work)(void*))
+{
+	int numStarted = 0;
+	for (; numStarted < numThreads; ++numStarted)
+	{
+		if (pthread_create(&threads[numStarted].thread, NULL, work, &threads[numStarted]) != 0)
+		{
+			break;
+		}
+	}
+
+	for (int t = 0; t < numStarted; ++t)
+	{
+		pthread_join(threads[t].thread, NULL);
+	}
+
+	//the threads that couldn't be started do their part on this thread
+	for (int t = numStarted; t < numThreads; ++t)
+	{
+		work(&threads[t]);
+	}
+}
+
+//sorts an array in an ascending order by parallel sample sort
+//a sample of the values is sorted and numThreads - 1 evenly spaced values of it become the splitters of numThreads buckets,
+//the threads count the values of their chunk of the array in every bucket and scatter them into a buffer, bucket after bucket,
+//then every thread sorts one bucket with the selected engine and copies it back, no bucket overlaps another, so no locking is needed
+//engine: the algorithm that sorts the buckets
+//data: pointer to an array to be sorted
+//size: the size of the array
+//numThreads: the maximum number of threads, from 1 to MAX_SORT_THREADS, at most one thread per MIN_SORT_THREAD_ITEMS values is used
+//comparisons: the number of comparisons, or of passes, summed over the buckets gets saved here
+//swaps: the number of swaps, or of moved values, summed over the buckets gets saved here
+//times: the time of every phase is added here and the number of threads is saved here
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int parallelSort(SortEngine engine, int* data, int size, int numThreads, long long* comparisons, long long* swaps, SortPhaseTimes* times)
+{
+	//starting the threads costs more than sorting a small input
+	if (numThreads > size / MIN_SORT_THREAD_ITEMS)
+	{
+		numThreads = size / MIN_SORT_THREAD_ITEMS;
+	}
+	if (numThreads <= 1)
+	{
+		times->numThreads = 1;
+		return sortData(engine, data, size, comparisons, swaps);
+	}
+	times->numThreads = numThreads;
+
+	double startTime = wallTime();
+
+	int numSamples = numThreads * SAMPLES_PER_BUCKET;
+	int* samples = (int*)malloc(sizeof(int) * numSamples);
+	int* buffer = (int*)malloc(sizeof(int) * (size_t)size);
+	unsigned char* buckets = (unsigned char*)malloc((size_t)size);
+	SortThread* threads = (SortThread*)malloc(sizeof(SortThread) * numThreads);
+	if (samples == NULL || buffer == NULL || buckets == NULL || threads == NULL)
+	{
+		free(samples);
+		free(buffer);
+		free(buckets);
+		free(threads);
+		return -1;
+	}
+
+	//sample the values at pseudo-random positions, the same ones on every run, and take the splitters from the sorted sample
+	unsigned long long state = 0x9E3779B97F4A7C15ull;
+	for (int i = 0; i < numSamples; ++i)
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		samples[i] = data[(state >> 33) % (unsigned long long)size];
+	}
+	long long sampleComparisons;
+	long long sampleSwaps;
+	pdqSort(samples, numSamples, &sampleComparisons, &sampleSwaps);
+
+	int splitters[MAX_SORT_THREADS];
+	for (int b = 1; b < numThreads; ++b)
+	{
+		splitters[b - 1] = samples[b * SAMPLES_PER_BUCKET];
+	}
+	free(samples);
+
+	for (int t = 0; t < numThreads; ++t)
+	{
+		threads[t].id = t;
+		threads[t].numThreads = numThreads;
+		threads[t].engine = engine;
+		threads[t].data = data;
+		threads[t].buffer = buffer;
+		threads[t].buckets = buckets;
+		threads[t].splitters = splitters;
+		threads[t].first = (int)((long long)size * t / numThreads);
+		threads[t].last = (int)((long long)size * (t + 1) / numThreads);
+		threads[t].comparisons = 0;
+		threads[t].swaps = 0;
+		threads[t].failed = 0;
+	}
+
+	double partitionTime = wallTime();
+	times->sampleTime += partitionTime - startTime;
+
+	//count the values of every chunk in every bucket, then turn the counts into the positions where every chunk writes its values of every bucket
+	runSortThreads(threads, numThreads, countBuckets);
+
+	int position = 0;
+	for (int b = 0; b < numThreads; ++b)
+	{
+		threads[b].start = position;
+		for (int t = 0; t < numThreads; ++t)
+		{
+			int count = threads[t].offsets[b];
+			threads[t].offsets[b] = position;
+			position += count;
+		}
+		threads[b].end = position;
+	}
+
+	runSortThreads(threads, numThreads, scatterBuckets);
+
+	double sortTime = wallTime();
+	times->partitionTime += sortTime - partitionTime;
+
+	runSortThreads(threads, numThreads, sortBucket);
+
+	times->sortTime += wallTime() - sortTime;
+
+	*comparisons = 0;
+	*swaps = 0;
+	int failed = 0;
+	for (int t = 0; t < numThreads; ++t)
+	{
+		*comparisons += threads[t].comparisons;
+		*swaps += threads[t].swaps;
+		failed |= threads[t].failed;
+	}
+
+	free(buffer);
+	free(buckets);
+	free(threads);
+
+	return failed ? -1 : 0;
+}
+
+//performs binary search on a sorted array (in ascending order)
+//data: pointer to the sorted array
+//size: the size of the sorted array
+//value: the value to search for
+//returns: the index in the array where the searched value is located, -1 if it is not found
+int binarySearch(int* data, int size, int value)
+{
+	//the boundaries of the currently searched range in the array
+	//initially the whole array
+	int left = 0;
+	int right = size - 1;
+	
+	while (left <= right)
+	{
+		//divide the range in half
+		int middle = (left + right) / 2;
+
+		//if the searched value is greater than the middle element, continue searching in the right portion of the original range
+		if (data[middle] < value)
+		{
+			left = middle + 1;
+		}
+		//if the searched value is smaller than the middle element, continue searching in the left portion of the original range
+		else if (data[middle] > value)
+		{
+			right = middle - 1;
+		}
+		//if the searched value is equal to the middle element, we have found our value
+		else
+		{
+			return middle;
+		}
+	}
+
+	return -1; //the searched value is not in the array
+}
+
+//returns the name of a search engine as it is given on the command line
+//engine: the search engine
+//returns: the name of the engine
+const char* searchEngineName(SearchEngine engine)
+{
+	switch (engine)
+	{
+	case SEARCH_BRANCHLESS:
+		return "branchless";
+	case SEARCH_EYTZINGER:
+		return "eytzinger";
+	case SEARCH_STREE:
+		return "stree";
+	case SEARCH_MERGE:
+		return "merge";
+	case SEARCH_INTERPOLATION:
+		return "interpolation";
+	case SEARCH_LEARNED:
+		return "learned";
+	default:
+		return "binary";
+	}
+}
+
+//searches for a value in the sorted array with the engine of the index
+//index: pointer to the index over the sorted array
+//value: the value to search for
+//returns: the index in the sorted array where the value is located, -1 if it is not found
+int searchSorted(const SearchIndex* index, int value)
+{
+	switch (index->engine)
+	{
+	case SEARCH_BRANCHLESS:
+		return branchlessSearch(index->data, index->size, value);
+	case SEARCH_EYTZINGER:
+		return eytzingerSearch(index, value);
+	case SEARCH_STREE:
+		return sTreeSearch(index, value);
+	case SEARCH_MERGE:
+		//a single value is the sweep of a batch of one, a lower bound from the beginning
+		return branchlessSearch(index->data, index->size, value);
+	case SEARCH_INTERPOLATION:
+		return interpolationSearch(index, value);
+	case SEARCH_LEARNED:
+		return learnedSearch(index, value);
+	default:
+		return binarySearch((int*)index->data, index->size, value);
+	}
+}
+
+//searches for a batch of values in the sorted array with the engine of the index
+//the merge engine resolves the whole batch in one sweep, the other engines search the values one by one
+//index: pointer to the index over the sorted array
+//values: pointer to the values to search for
+//count: the number of values
+//positions: pointer to an array of count ints where the index of every value in the sorted array is saved, -1 if it is not found
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int searchSortedBatch(const SearchIndex* index, const int* values, int count, int* positions)
+{
+	if (index->engine == SEARCH_MERGE)
+	{
+		return mergeSearch(index->data, index->size, values, count, positions);
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		positions[i] = searchSorted(index, values[i]);
+	}
+
+	return 0;
+}
+
+//builds the Bloom filter over the sorted array, repeated values are added once
+//filter: pointer to the filter
+//data: pointer to the sorted array
+//size: the size of the sorted array
+//bitsPerKey: the number of bits of the filter per value
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int buildSortedFilter(BloomFilter* filter, const int* data, int size, int bitsPerKey)
+{
+	if (createBloomFilter(filter, size, bitsPerKey) == -1)
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < size; ++i)
+	{
+		if (i == 0 || data[i] != data[i - 1])
+		{
+			bloomAdd(filter, data[i]);
+		}
+	}
+
+	return 0;
+}
+
+//searches for a batch of values with the Bloom filter in front of the engine of the index
+//the values the filter rejects get the position -1 without reading the sorted array; for the merge engine the values that pass
+//are gathered into a smaller batch, so the sweep only sorts and looks for them
+//index: pointer to the index over the sorted array
+//filter: pointer to the filter, without blocks the batch is searched without it
+//values: pointer to the values to search for
+//count: the number of values
+//positions: pointer to an array of count ints where the index of every value in the sorted array is saved, -1 if it is not found
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int searchFilteredBatch(const SearchIndex* index, const BloomFilter* filter, const int* values, int count, int* positions)
+{
+	if (filter->blocks == NULL)
+	{
+		return searchSortedBatch(index, values, count, positions);
+	}
+
+	if (index->engine != SEARCH_MERGE)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			positions[i] = bloomMayContain(filter, values[i]) ? searchSorted(index, values[i]) : -1;
+		}
+
+		return 0;
+	}
+
+	//the values that pass the filter are gathered in the positions array, which is overwritten afterwards
+	int* passedPositions = (int*)malloc(sizeof(int) * (size_t)(count > 0 ? count : 1));
+	if (passedPositions == NULL)
+	{
+		return -1;
+	}
+
+	int* passed = positions;
+	int numPassed = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		if (bloomMayContain(filter, values[i]))
+		{
+			passed[numPassed++] = values[i];
+		}
+	}
+
+	int result = mergeSearch(index->data, index->size, passed, numPassed, passedPositions);
+	if (result == 0)
+	{
+		//the passing values are in the order of the batch, so their positions are handed back in the same order;
+		//going from the last value, the passing value at index next is never behind the position i that is written
+		int next = numPassed - 1;
+		for (int i = count - 1; i >= 0; --i)
+		{
+			if (next >= 0 && values[i] == passed[next])
+			{
+				positions[i] = passedPositions[next--];
+			}
+			else
+			{
+				positions[i] = -1;
+			}
+		}
+	}
+
+	free(passedPositions);
+
+	return result;
+}
+
+//counts the searched values that were not found and how many of them the Bloom filter passed, for its false positive rate
+//the filter is checked again after the timed searches, so the searches don't count anything
+//filter: pointer to the filter
+//values: pointer to the searched values
+//positions: pointer to the positions where the values were found, -1 if they were not found
+//count: the number of values
+//numMisses: the number of values that were not found is increased
+//numFalsePositives: the number of those values that the filter passed is increased
+void countFilterMisses(const BloomFilter* filter, const int* values, const int* positions, int count, long long* numMisses, long long* numFalsePositives)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		if (positions[i] == -1)
+		{
+			(*numMisses)++;
+			*numFalsePositives += bloomMayContain(filter, values[i]);
+		}
+	}
+}
+
+//prints the title, the sources of the data, the storage method and the number of stored items
+//inputFile: the path to the input file, NULL if the sorted array was mapped from a snapshot
+//searchFile: the path to the search file, NULL if the retrieval data is received by the server
+//inputSize: the size of the input array
+//engine: the algorithm that sorted the input data
+//searchEngine: the algorithm that searches the sorted array
+void printStatsHeader(char* inputFile, char* searchFile, int inputSize, SortEngine engine, SearchEngine searchEngine)
+{
+	printf("Data storage and retrieval:\n");
+	printf("a comparison of hashing and directed search of sorted data\n");
+	printf("================================\n\n");
+
+	if (inputFile != NULL)
+	{
+		printf("Input data loaded from file %s\n", inputFile);
+	}
+	else
+	{
+		printf("Input data loaded from snapshot\n");
+	}
+	if (searchFile != NULL)
+	{
+		printf("Retrieval data loaded from file %s\n", searchFile);
+	}
+	if (engine != SORT_SELECTION)
+	{
+		printf("Storage Method: Directed search of sorted data (sorted by %s)\n", sortEngineName(engine));
+	}
+	else
+	{
+		printf("Storage Method: Directed search of sorted data\n");
+	}
+	if (searchEngine != SEARCH_BINARY)
+	{
+		printf("Search Method: %s search\n", searchEngineName(searchEngine));
+	}
+	printf("Number of items stored in the array: %d\n", inputSize);
+}
+
+//prints the counters of the sorting
+//engine: the algorithm that sorted the input data
+//comparisons: the number of comparisons performed by the sorting algorithm, or of passes for the radix sort
+//swaps: the number of swaps performed by the sorting algorithm, or of moved values for the radix sort
+//index: pointer to the index of the search engine
+//indexTime: the time in miliseconds that building the index took
+void printStorageDetails(SortEngine engine, long long comparisons, long long swaps, const SearchIndex* index, float indexTime)
+{
+	printf("Storage details:\n\n");
+
+	if (engine == SORT_RADIX)
+	{
+		printf("  <%lld> passes performed\n", comparisons);
+		printf("  <%lld> moves performed\n", swaps);
+	}
+	else
+	{
+		printf("  <%lld> comparisons performed\n", comparisons);
+		printf("  <%lld> swaps performed\n", swaps);
+	}
+	if (index->memory > 0)
+	{
+		printf("  %s search index built in %f ms, %zu bytes (%.2f bytes per item)\n", searchEngineName(index->engine), indexTime,
+			index->memory, (double)index->memory / index->size);
+	}
+	if (index->engine == SEARCH_STREE)
+	{
+		printf("  %d nodes of %d keys in %d levels\n", index->numNodes, SEARCH_LINE_INTS, index->height);
+	}
+	if (index->engine == SEARCH_LEARNED)
+	{
+		printf("  learned model of %d segments with an error bound of %d positions\n", index->numSegments, LEARNED_ERROR_BOUND);
+	}
+	printf("\n");
+}
+
+//prints the result of one search
+//value: the searched value
+//position: the index where the value was found in the sorted array, -1 if it was not found
+void printRetrieval(int value, int position)
+{
+	if (position != -1)
+	{
+		printf("  Value %d found in the sorted array at position %d\n", value, position);
+	}
+	else
+	{
+		printf("  Value %d not found in the sorted array\n", value);
+	}
+}
+
+//searches for a batch of values again with the interpolation or learned engine and counts the values the searches read,
+//after the measured searches, which don't count them; other engines are not counted
+//index: pointer to the index over the sorted array, its counters are updated
+//filter: pointer to the Bloom filter in front of the searches, the values it rejects are not searched, without blocks if there is none
+//values: pointer to the searched values
+//count: the number of values
+void countSearchProbes(SearchIndex* index, const BloomFilter* filter, const int* values, int count)
+{
+	if (index->engine != SEARCH_INTERPOLATION && index->engine != SEARCH_LEARNED)
+	{
+		return;
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		if (filter->blocks == NULL || bloomMayContain(filter, values[i]))
+		{
+			countedSearch(index, values[i]);
+		}
+	}
+}
+
+//prints the average number of probes and the average search window of the engines that count them
+//index: pointer to the index over the sorted array
+void printSearchCounters(const SearchIndex* index)
+{
+	const SearchCounters* counters = &index->counters;
+	if (counters->numSearches == 0)
+	{
+		return;
+	}
+
+	double log2Size = 0.0;
+	for (int size = index->size; size > 1; size /= 2)
+	{
+		log2Size++;
+	}
+
+	printf("\nSearch counters:\n\n");
+	printf("  %.2f probes per search on average (log2 of the array size: %.0f)\n", (double)counters->numProbes / counters->numSearches, log2Size);
+	printf("  %.2f values in the search window on average\n", (double)counters->windowTotal / counters->numSearches);
+}
+
+//prints the execution times
+//inputFile: the path to the input file, NULL if the sorted array was mapped from a snapshot
+//inputLoad: pointer to the statistics of loading the input file
+//searchLoad: pointer to the statistics of loading the search file
+//storeResult: pointer to the measured time of sorting the data
+//phases: pointer to the times of the phases of one parallel sort, NULL or with one thread if the data was not sorted in parallel
+//searchResult: pointer to the measured time of one search
+void printExecutionTimes(char* inputFile, LoadStats* inputLoad, LoadStats* searchLoad, BenchResult* storeResult, SortPhaseTimes* phases, BenchResult* searchResult)
+{
+	printf("\nExecution times:\n\n");
+
+	if (inputFile != NULL)
+	{
+		printLoadStats("input data", inputLoad);
+		printLoadStats("retrieval data", searchLoad);
+		printBenchResult("store data", storeResult, NULL);
+		if (phases != NULL && phases->numThreads > 1)
+		{
+			printf("    Parallel sort with %d threads, average times of its phases:\n", phases->numThreads);
+			printf("    Time to sample the splitters: %f ms\n", phases->sampleTime);
+			printf("    Time to partition the data into buckets: %f ms\n", phases->partitionTime);
+			printf("    Time to sort the buckets: %f ms\n", phases->sortTime);
+		}
+	}
+	else
+	{
+		printLoadStats("retrieval data", searchLoad);
+		printBenchResult("store data", storeResult, "snapshot mapped and checked");
+	}
+	printBenchResult("retrieve data", searchResult, NULL);
+	printf("\n");
+
+	const BenchResult* results[] = { storeResult, searchResult };
+	printBenchCounters(results, 2);
+
+	printf("================================\n\n");
+}
+
+//prints the statistics
+//inputFile: the path to the input file, NULL if the sorted array was mapped from a snapshot
+//searchFile: the path to the search file
+//inputSize: the size of the input array
+//searchData: pointer to an array where the search values are stored
+//searchSize: the size of the search array
+//positions: pointer to an array of the same size as searchData that contains the indices where the corresponding search elements were found in the input array
+//engine: the algorithm that sorted the input data
+//comparisons: the number of comparisons performed by the sorting algorithm, or of passes for the radix sort
+//swaps: the number of swaps performed by the sorting algorithm, or of moved values for the radix sort
+//index: pointer to the index of the search engine
+//indexTime: the time in miliseconds that building the index took
+//inputLoad: pointer to the statistics of loading the input file
+//searchLoad: pointer to the statistics of loading the search file
+//storeResult: pointer to the measured time of sorting the data
+//phases: pointer to the times of the phases of one parallel sort, NULL or with one thread if the data was not sorted in parallel
+//searchResult: pointer to the measured time of one search
+//filter: pointer to the Bloom filter in front of the searches, without blocks if there is none
+//filterTime: the time in miliseconds that building the filter took
+void printStats(char* inputFile, char* searchFile, int inputSize, int* searchData, int searchSize,
+	int* positions, SortEngine engine, long long comparisons, long long swaps, const SearchIndex* index, float indexTime, LoadStats* inputLoad, LoadStats* searchLoad, BenchResult* storeResult,
+	SortPhaseTimes* phases, BenchResult* searchResult, const BloomFilter* filter, float filterTime)
+{
+	printStatsHeader(inputFile, searchFile, inputSize, engine, index->engine);
+	printf("Number of items searched: %d\n", searchSize);
+
+	int numFound = 0;
+	for (int i = 0; i < searchSize; ++i)
+	{
+		if (positions[i] != -1)
+		{
+			numFound++;
+		}
+	}
+
+	printf("Number of items found: %d\n\n", numFound);
+
+	printStorageDetails(engine, comparisons, swaps, index, indexTime);
+
+	printf("Retrieval details:\n\n");
+
+	for (int i = 0; i < searchSize; ++i)
+	{
+		printRetrieval(searchData[i], positions[i]);
+	}
+
+	printSearchCounters(index);
+
+	if (filter->blocks != NULL)
+	{
+		long long numMisses = 0;
+		long long numFalsePositives = 0;
+		countFilterMisses(filter, searchData, positions, searchSize, &numMisses, &numFalsePositives);
+		printBloomFilter(filter, filterTime, numMisses, numFalsePositives);
+	}
+
+	printExecutionTimes(inputFile, inputLoad, searchLoad, storeResult, phases, searchResult);
+}
+
+//copies one array into another array
+//source: pointer to the array that is copied
+//destination: pointer to the array that is copied into
+//size: the number of elements to be copied
+void copyArray(int* source, int* destination, int size)
+{
+	for (int i = 0; i < size; ++i)
+	{
+		destination[i] = source[i];
+	}
+}
+
+//the data of the measured sorting
+typedef struct SortBench SortBench;
+struct SortBench
+{
+	int* inputData; //the unsorted input array
+	int* sortedData; //the array that is sorted, the input array is copied into it before every sort
+	int size; //the size of the arrays
+	SortEngine engine; //the algorithm that sorts the data
+	int numThreads; //the number of threads sorting the data
+	long long comparisons; //the number of comparisons, or of passes, of the last sort
+	long long swaps; //the number of swaps, or of moved values, of the last sort
+	SortPhaseTimes phases; //the times of the phases of the parallel sort, added up over all the sorts
+};
+
+//copies the unsorted input array into the array that is sorted, the preparation of every measured sort
+//context: pointer to the SortBench
+//returns: 0
+int benchSortSetup(void* context)
+{
+	SortBench* bench = (SortBench*)context;
+	copyArray(bench->inputData, bench->sortedData, bench->size);
+
+	return 0;
+}
+
+//sorts the data once, the operation measured as the storage phase
+//context: pointer to the SortBench
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int benchSort(void* context)
+{
+	SortBench* bench = (SortBench*)context;
+	if (parallelSort(bench->engine, bench->sortedData, bench->size, bench->numThreads, &bench->comparisons, &bench->swaps, &bench->phases) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+//the data of the measured retrieval
+typedef struct SearchBench SearchBench;
+struct SearchBench
+{
+	SearchIndex* index; //pointer to the index over the sorted array
+	const BloomFilter* filter; //pointer to the Bloom filter in front of the searches, without blocks if there is none
+	int* searchData; //the values to search for
+	int searchSize; //the number of values to search for
+	int* positions; //the positions where the values were found are saved here
+};
+
+//searches for all the values, the operation measured as the retrieval phase
+//the merge engine searches them in one sweep, the other engines one by one, the values the filter rejects are not searched
+//context: pointer to the SearchBench
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int benchSearch(void* context)
+{
+	SearchBench* bench = (SearchBench*)context;
+	if (searchFilteredBatch(bench->index, bench->filter, bench->searchData, bench->searchSize, bench->positions) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+//appends the measured times of the sorting and the retrieval to the report file
+//options: pointer to the settings of the benchmark with the report file
+//inputFile: the path to the input file, NULL if the sorted array was mapped from a snapshot
+//inputSize: the size of the sorted array
+//searchSize: the number of searched values
+//sortEngine: the algorithm that sorted the data
+//numThreads: the number of threads that sorted the data
+//searchEngine: the algorithm that searched the sorted array
+//results: array of the results of the sorting and the retrieval
+//filterBits: the number of bits per value of the Bloom filter in front of the searches, 0 without a filter
+//returns: 0 on success, -1 if the report could not be written
+int writeSortedReport(BenchOptions* options, char* inputFile, int inputSize, long long searchSize, SortEngine sortEngine, int numThreads,
+	SearchEngine searchEngine, BenchResult* results, int filterBits)
+{
+	char filter[24] = "";
+	if (filterBits > 0)
+	{
+		snprintf(filter, sizeof(filter), "-bloom%d", filterBits);
+	}
+
+	char method[96];
+	if (numThreads > 1)
+	{
+		snprintf(method, sizeof(method), "%s-%s-%dthreads%s", sortEngineName(sortEngine), searchEngineName(searchEngine), numThreads, filter);
+	}
+	else
+	{
+		snprintf(method, sizeof(method), "%s-%s%s", sortEngineName(sortEngine), searchEngineName(searchEngine), filter);
+	}
+
+	BenchRun run = { "sorted", method, inputFile != NULL ? inputFile : "snapshot", inputSize, 0, searchSize };
+
+	return writeBenchReport(options, &run, results, 2);
+}
+
+//searches for the values of the search file while the file is being read and prints every result as it is found
+//the file is read in chunks by a second thread, so reading the next chunk overlaps with searching the current one,
+//and the memory used doesn't depend on the number of values in the file
+//index: pointer to the index over the sorted array, the counters of the engines that keep them are updated
+//filter: pointer to the Bloom filter in front of the searches, without blocks if there is none
+//searchFile: the path to the search file, "-" reads the standard input
+//numSearched: the number of searched values is saved here
+//numFound: the number of found values is saved here
+//searchLoad: pointer to the structure where the statistics of the loading are saved, the time covers the whole streaming
+//perfCounters: whether the hardware counters run while searching
+//searchResult: pointer to where the time of one search, averaged over all of them, and the counts of the hardware events per search are saved
+//numMisses: the number of values that were not found is saved here, counted only with a filter
+//numFalsePositives: the number of those values that the filter passed is saved here
+//returns: 0 on success, -1 if the file could not be read
+int streamSearch(SearchIndex* index, const BloomFilter* filter, char* searchFile, long long* numSearched, long long* numFound, LoadStats* searchLoad,
+	int perfCounters, BenchResult* searchResult, long long* numMisses, long long* numFalsePositives)
+{
+	*numSearched = 0;
+	*numFound = 0;
+	*numMisses = 0;
+	*numFalsePositives = 0;
+
+	int* positions = (int*)malloc(sizeof(int) * PIPELINE_CHUNK_SIZE);
+	if (positions == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	ChunkPipeline pipeline;
+	if (openChunkPipeline(&pipeline, searchFile) == -1)
+	{
+		printf("Error: cannot open file %s!\n", searchFile);
+		free(positions);
+		return -1;
+	}
+
+	//only the searches are timed, the chunks are read in the meantime
+	double totalTime = 0.0;
+	PerfCounters counters;
+	if (perfCounters)
+	{
+		openPerfCounters(&counters);
+	}
+	int* values;
+	int count;
+	while ((count = nextChunk(&pipeline, &values)) > 0)
+	{
+		SearchBench bench = { index, filter, values, count, positions };
+		if (perfCounters)
+		{
+			startPerfCounters(&counters);
+		}
+		double start = benchNow();
+		int result = benchSearch(&bench);
+		totalTime += benchNow() - start;
+		if (perfCounters)
+		{
+			stopPerfCounters(&counters);
+		}
+		if (result == -1)
+		{
+			break;
+		}
+		countSearchProbes(index, filter, values, count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			printRetrieval(values[i], positions[i]);
+			if (positions[i] != -1)
+			{
+				(*numFound)++;
+			}
+		}
+		if (filter->blocks != NULL)
+		{
+			countFilterMisses(filter, values, positions, count, numMisses, numFalsePositives);
+		}
+
+		*numSearched += count;
+	}
+
+	closeChunkPipeline(&pipeline, searchLoad);
+	PerfCounts counts;
+	if (perfCounters)
+	{
+		readPerfCounters(&counters, &counts);
+		closePerfCounters(&counters);
+	}
+	free(positions);
+
+	if (count == -1)
+	{
+		printf("Error: cannot read file %s!\n", searchFile);
+		return -1;
+	}
+	if (count > 0)
+	{
+		//the search of a chunk failed
+		return -1;
+	}
+	if (*numSearched == 0)
+	{
+		printf("Error: No retrieval data loaded from file %s!\n", searchFile);
+		return -1;
+	}
+
+	singleBenchResult(searchResult, "retrieve", totalTime / *numSearched, *numSearched);
+	if (perfCounters)
+	{
+		searchResult->counts = counts;
+		scalePerfCounts(&searchResult->counts, (double)*numSearched);
+	}
+
+	return 0;
+}
+
+//the structure the server searches
+typedef struct SortedServer SortedServer;
+struct SortedServer
+{
+	SearchIndex* index; //pointer to the index over the sorted array
+	const BloomFilter* filter; //pointer to the Bloom filter in front of the searches, without blocks if there is none
+	long long numMisses; //the number of searched values that were not found, counted with a filter
+	long long numFalsePositives; //the number of those values that the filter passed
+};
+
+//searches for a batch of values received by the server with one batched call, behind the Bloom filter if there is one,
+//whose false positives among the values that were not found are counted afterwards like for a streamed search
+//context: pointer to the SortedServer
+//keys: pointer to the values to search for
+//count: the number of values, at most SERVER_MAX_BATCH
+//positions: pointer to an array of count ints where the index of every value in the sorted array is saved, -1 if it is not found
+//returns: the number of values found, -1 if it was not possible to allocate the memory
+int serveLookup(void* context, const int* keys, int count, int* positions)
+{
+	SortedServer* sortedServer = (SortedServer*)context;
+	if (searchFilteredBatch(sortedServer->index, sortedServer->filter, keys, count, positions) == -1)
+	{
+		return -1;
+	}
+	if (sortedServer->filter->blocks != NULL)
+	{
+		countFilterMisses(sortedServer->filter, keys, positions, count, &sortedServer->numMisses, &sortedServer->numFalsePositives);
+	}
+
+	int numFound = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		numFound += positions[i] != -1;
+	}
+
+	return numFound;
+}
+
+//answers the lookups of the clients of the server with the sorted array until the server is stopped,
+//after printing the header, the storage details and the time of the sorting, and prints the statistics of the server at the end
+//sortedServer: pointer to the structure the server searches, the counts of the filter are updated
+//serveAddress: the socket path, "-" for the standard input and output
+//inputFile: the path to the input file, NULL if the sorted array was mapped from a snapshot
+//inputSize: the size of the sorted array
+//engine: the algorithm that sorted the input data
+//comparisons: the number of comparisons performed by the sorting algorithm, or of passes for the radix sort
+//swaps: the number of swaps performed by the sorting algorithm, or of moved values for the radix sort
+//indexTime: the time in miliseconds that building the index took
+//filterTime: the time in miliseconds that building the Bloom filter took
+//inputLoad: pointer to the statistics of loading the input file
+//storeResult: pointer to the measured time of sorting, or of mapping the snapshot
+//phases: pointer to the average times of the phases of the parallel sort
+//returns: 0 on success, -1 if the server could not be opened or failed
+int serveSorted(SortedServer* sortedServer, char* serveAddress, char* inputFile, int inputSize, SortEngine engine, long long comparisons, long long swaps,
+	float indexTime, float filterTime, LoadStats* inputLoad, BenchResult* storeResult, SortPhaseTimes* phases)
+{
+	Server server;
+	if (openServer(&server, serveAddress) == -1)
+	{
+		return -1;
+	}
+
+	printStatsHeader(inputFile, NULL, inputSize, engine, sortedServer->index->engine);
+	printf("\n");
+	printStorageDetails(engine, comparisons, swaps, sortedServer->index, indexTime);
+	printf("Execution times:\n\n");
+	if (inputFile != NULL)
+	{
+		printLoadStats("input data", inputLoad);
+		printBenchResult("store data", storeResult, NULL);
+		if (phases->numThreads > 1)
+		{
+			printf("    Parallel sort with %d threads, average times of its phases:\n", phases->numThreads);
+			printf("    Time to sample the splitters: %f ms\n", phases->sampleTime);
+			printf("    Time to partition the data into buckets: %f ms\n", phases->partitionTime);
+			printf("    Time to sort the buckets: %f ms\n", phases->sortTime);
+		}
+	}
+	else
+	{
+		printBenchResult("store data", storeResult, "snapshot mapped and checked");
+	}
+	printf("\n");
+
+	int result = runServer(&server, serveLookup, sortedServer);
+	printServerStats(&server);
+	if (sortedServer->filter->blocks != NULL)
+	{
+		printBloomFilter(sortedServer->filter, filterTime, sortedServer->numMisses, sortedServer->numFalsePositives);
+	}
+	printf("\n================================\n\n");
+
+	closeServer(&server);
+
+	return result;
+}
+
+//optional command line settings, given after the two required arguments
+typedef struct Options Options;
+struct Options
+{
+	char* snapshotFile; //the snapshot of the sorted array that is mapped if it exists and written otherwise, NULL without a snapshot (--snapshot)
+	int verifySnapshot; //whether the checksum of the whole array is verified when a snapshot is mapped, 1 with --verify-snapshot
+	int stream; //whether the search file is streamed in chunks and every result is printed as it is found, 1 with --stream
+	SortEngine sortEngine; //the algorithm that sorts the input data (--sort)
+	int numThreads; //the number of threads sorting the input data (--threads)
+	SearchEngine searchEngine; //the algorithm that searches the sorted array (--search)
+	int filterBits; //the number of bits per value of the Bloom filter in front of the searches, 0 without a filter (--filter)
+	char* serveAddress; //the socket path, or "-" for the standard input and output, the sorted array is served at instead of searching the search file, NULL without a server (--serve)
+	BenchOptions bench; //the settings of the benchmark of the sorting and retrieval (--warmup, --trials, --report, --report-format)
+};
+
+//parses the optional arguments
+//argc: the number of arguments
+//argv: the arguments, the options start after the two required arguments
+//options: pointer to the structure where the settings are saved, options that are not given keep their default values
+//returns: 0 on success, -1 if an option is unknown or has no value
+int parseOptions(int argc, char* argv[], Options* options)
+{
+	options->snapshotFile = NULL;
+	options->verifySnapshot = 0;
+	options->stream = 0;
+	options->sortEngine = SORT_SELECTION;
+	options->numThreads = 1;
+	options->searchEngine = SEARCH_BINARY;
+	options->filterBits = 0;
+	options->serveAddress = NULL;
+	initBenchOptions(&options->bench);
+
+	for (int i = 3; i < argc; ++i)
+	{
+		//options without a value
+		if (strcmp(argv[i], "--stream") == 0)
+		{
+			options->stream = 1;
+			continue;
+		}
+		if (strcmp(argv[i], "--verify-snapshot") == 0)
+		{
+			options->verifySnapshot = 1;
+			continue;
+		}
+
+		//the filter takes the number of bits per item if the next argument isn't an option, BLOOM_DEFAULT_BITS otherwise
+		if (strcmp(argv[i], "--filter") == 0)
+		{
+			options->filterBits = BLOOM_DEFAULT_BITS;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				options->filterBits = atoi(argv[++i]);
+				if (options->filterBits < 1 || options->filterBits > 64)
+				{
+					printf("Error: the number of bits of the filter per item must be from 1 to 64!\n");
+					return -1;
+				}
+			}
+			continue;
+		}
+
+		//the options of the benchmark
+		int parsed = parseBenchOption(argc, argv, &i, &options->bench);
+		if (parsed == -1)
+		{
+			return -1;
+		}
+		if (parsed == 1)
+		{
+			continue;
+		}
+
+		//all the other options take a value
+		if (i + 1 >= argc)
+		{
+			printf("Error: option %s requires a value!\n", argv[i]);
+			return -1;
+		}
+
+		if (strcmp(argv[i], "--snapshot") == 0)
+		{
+			options->snapshotFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threads") == 0)
+		{
+			options->numThreads = atoi(argv[++i]);
+			if (options->numThreads < 1 || options->numThreads > MAX_SORT_THREADS)
+			{
+				printf("Error: the number of threads must be from 1 to %d!\n", MAX_SORT_THREADS);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--serve") == 0)
+		{
+			options->serveAddress = argv[++i];
+		}
+		else if (strcmp(argv[i], "--search") == 0)
+		{
+			++i;
+			if (strcmp(argv[i], "binary") == 0)
+			{
+				options->searchEngine = SEARCH_BINARY;
+			}
+			else if (strcmp(argv[i], "branchless") == 0)
+			{
+				options->searchEngine = SEARCH_BRANCHLESS;
+			}
+			else if (strcmp(argv[i], "eytzinger") == 0)
+			{
+				options->searchEngine = SEARCH_EYTZINGER;
+			}
+			else if (strcmp(argv[i], "stree") == 0)
+			{
+				options->searchEngine = SEARCH_STREE;
+			}
+			else if (strcmp(argv[i], "merge") == 0)
+			{
+				options->searchEngine = SEARCH_MERGE;
+			}
+			else if (strcmp(argv[i], "interpolation") == 0)
+			{
+				options->searchEngine = SEARCH_INTERPOLATION;
+			}
+			else if (strcmp(argv[i], "learned") == 0)
+			{
+				options->searchEngine = SEARCH_LEARNED;
+			}
+			else
+			{
+				printf("Error: unknown search engine %s!\n", argv[i]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--sort") == 0)
+		{
+			++i;
+			if (strcmp(argv[i], "selection") == 0)
+			{
+				options->sortEngine = SORT_SELECTION;
+			}
+			else if (strcmp(argv[i], "radix") == 0)
+			{
+				options->sortEngine = SORT_RADIX;
+			}
+			else if (strcmp(argv[i], "introsort") == 0)
+			{
+				options->sortEngine = SORT_INTROSORT;
+			}
+			else if (strcmp(argv[i], "pdqsort") == 0)
+			{
+				options->sortEngine = SORT_PDQSORT;
+			}
+			else
+			{
+				printf("Error: unknown sort engine %s!\n", argv[i]);
+				return -1;
+			}
+		}
+		else
+		{
+			printf("Error: unknown option %s!\n", argv[i]);
+			return -1;
+		}
+	}
+
+	//the server answers the lookups of its clients instead of searching the search file
+	if (options->serveAddress != NULL && options->stream)
+	{
+		printf("Error: --serve can't be used with --stream!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+//fills the configuration values of a snapshot of the sorted array
+//config: array of SNAPSHOT_NUM_VALUES values where the configuration is saved
+//engine: the algorithm that sorted the array, its counters are saved in the snapshot
+//inputFile: the path to the input file, its size and modification time identify the sorted data
+//returns: 0 on success, -1 if the input file doesn't exist
+int sortedSnapshotConfig(unsigned long long* config, SortEngine engine, char* inputFile)
+{
+	memset(config, 0, SNAPSHOT_NUM_VALUES * sizeof(unsigned long long));
+	config[0] = sizeof(int);
+	config[1] = (unsigned long long)engine;
+
+	return snapshotInputIdentity(inputFile, &config[2]);
+}
+
+//writes a snapshot of the sorted array
+//fileName: the path to the snapshot file
+//sortedData: pointer to the sorted array
+//size: the size of the sorted array
+//engine: the algorithm that sorted the array
+//comparisons: the number of comparisons the sorting performed
+//swaps: the number of swaps the sorting performed
+//inputFile: the path to the input file the array was read from
+//returns: 0 on success, -1 if the snapshot could not be written
+int saveSortedSnapshot(char* fileName, int* sortedData, int size, SortEngine engine, long long comparisons, long long swaps, char* inputFile)
+{
+	unsigned long long config[SNAPSHOT_NUM_VALUES];
+	if (sortedSnapshotConfig(config, engine, inputFile) == -1)
+	{
+		return -1;
+	}
+
+	unsigned long long metadata[SNAPSHOT_NUM_VALUES] = { 0 };
+	metadata[0] = (unsigned long long)size;
+	metadata[1] = (unsigned long long)comparisons;
+	metadata[2] = (unsigned long long)swaps;
+
+	if (writeSnapshot(fileName, SNAPSHOT_SORTED_ARRAY, config, metadata, sortedData, (size_t)size * sizeof(int)) == -1)
+	{
+		printf("Error: cannot write snapshot %s!\n", fileName);
+		return -1;
+	}
+
+	return 0;
+}
+
+//maps a snapshot of the sorted array instead of sorting the input data
+//snapshot: pointer to the snapshot
+//fileName: the path to the snapshot file
+//size: the size of the sorted array is saved here
+//engine: the algorithm the array must have been sorted with
+//comparisons: the number of comparisons the sorting performed is saved here
+//swaps: the number of swaps the sorting performed is saved here
+//inputFile: the path to the input file, it must be unchanged since the snapshot was built, but it isn't read
+//verifyPayload: 1 to verify the checksum of the whole array, 0 to check only the header
+//returns: pointer to the sorted array in the mapped file, NULL if the snapshot could not be mapped or is invalid
+const int* loadSortedSnapshot(Snapshot* snapshot, char* fileName, SortEngine engine, int* size, long long* comparisons, long long* swaps,
+	char* inputFile, int verifyPayload)
+{
+	unsigned long long config[SNAPSHOT_NUM_VALUES];
+	if (sortedSnapshotConfig(config, engine, inputFile) == -1)
+	{
+		return NULL;
+	}
+
+	if (openSnapshot(snapshot, fileName, SNAPSHOT_SORTED_ARRAY, config, verifyPayload) == -1)
+	{
+		return NULL;
+	}
+
+	const SnapshotHeader* header = snapshot->header;
+	if (header->metadata[0] == 0 || header->metadata[0] > 0x7fffffff || header->metadata[0] * sizeof(int) != header->payloadSize)
+	{
+		closeSnapshot(snapshot);
+		printf("Error: snapshot %s has an invalid size!\n", fileName);
+		return NULL;
+	}
+
+	*size = (int)header->metadata[0];
+	*comparisons = (long long)header->metadata[1];
+	*swaps = (long long)header->metadata[2];
+
+	return (const int*)snapshot->payload;
+}
+
+int main(int argc, char* argv[])
+{
+	//check the number of arguments
+	if (argc < 3)
+	{
+		//wrong number of arguments
+		printf("Error: 2 arguments required!\n");
+		return -1;
+	}
+
+	//read the optional settings
+	Options options;
+	if (parseOptions(argc, argv, &options) == -1)
+	{
+		return -1;
+	}
+
+	//an existing snapshot replaces the input data
+	int useSnapshot = options.snapshotFile != NULL && snapshotExists(options.snapshotFile);
+
+	//the input array is allocated when the input file is read
+	int* inputData = NULL;
+
+	//try to allocate memory for the search array
+	int* searchData = (int*)malloc(sizeof(int) * MAX_SEARCH_SIZE);
+	if (searchData == NULL)
+	{
+		//unable to allocate memory, free memory and exit
+		printf("Error: couldn't allocate memory!\n");
+		return -1;
+	}
+
+	//try to read the data from the input files, with a snapshot only the search file is read
+	//a streamed search file is read while searching, and a server receives the values to search for from its clients
+	int inputSize = 0;
+	int searchSize = 0;
+	LoadStats inputLoad = { 0, 0, 0.0 };
+	LoadStats searchLoad = { 0, 0, 0.0 };
+	if (options.stream || options.serveAddress != NULL)
+	{
+		if (!useSnapshot)
+		{
+			inputSize = readAllData(argv[1], &inputData, &inputLoad);
+			if (inputSize == 0)
+			{
+				//nothing read from the input file, free memory and exit
+				printf("Error: No input data loaded from file %s!\n", argv[1]);
+				free(inputData);
+				free(searchData);
+				return -1;
+			}
+		}
+	}
+	else if (useSnapshot)
+	{
+		searchSize = readData(argv[2], searchData, MAX_SEARCH_SIZE, &searchLoad);
+		if (searchSize == 0)
+		{
+			//nothing read from the search file, free memory and exit
+			printf("Error: No retrieval data loaded from file %s!\n", argv[2]);
+			free(inputData);
+			free(searchData);
+			return -1;
+		}
+	}
+	else if (readInputs(argv[1], &inputData, &inputSize, argv[2], searchData, &searchSize, &inputLoad, &searchLoad) == -1)
+	{
+		//error while reading, free memory and exit
+		free(inputData);
+		free(searchData);
+		return -1;
+	}
+
+	//try to allocate memory for the sorted array, a mapped snapshot needs none
+	int* sortedData = useSnapshot ? NULL : (int*)malloc(sizeof(int) * inputSize);
+	if (!useSnapshot && sortedData == NULL)
+	{
+		//unable to allocate memory, free memory and exit
+		printf("Error: couldn't allocate memory!\n");
+		free(inputData);
+		free(searchData);
+		return -1;
+	}
+	
+	long long comparisons = 0;
+	long long swaps = 0;
+	BenchResult results[2]; //the results of the sorting and of the retrieval
+	SortPhaseTimes phases = { 1, 0.0, 0.0, 0.0 };
+	Snapshot snapshot;
+	const int* sortedArray = sortedData; //the sorted array that is searched, in the mapped snapshot if there is one
+	if (useSnapshot)
+	{
+		//map the snapshot once and measure the time it takes
+		double start = benchNow();
+		sortedArray = loadSortedSnapshot(&snapshot, options.snapshotFile, options.sortEngine, &inputSize, &comparisons, &swaps, argv[1],
+			options.verifySnapshot);
+		singleBenchResult(&results[0], "store", benchNow() - start, 1);
+		if (sortedArray == NULL)
+		{
+			free(inputData);
+			free(searchData);
+			return -1;
+		}
+	}
+	else
+	{
+		//sort the data, repeated by the benchmark harness for measuring its time, or once by a server, which reports that sort
+		//the original data is copied back before every sort, which is not timed
+		SortBench sortBench = { inputData, sortedData, inputSize, options.sortEngine, options.numThreads, 0, 0, { 1, 0.0, 0.0, 0.0 } };
+		int sortFailed;
+		if (options.serveAddress != NULL)
+		{
+			benchSortSetup(&sortBench);
+			double start = benchNow();
+			sortFailed = benchSort(&sortBench) == -1;
+			singleBenchResult(&results[0], "store", benchNow() - start, 1);
+		}
+		else
+		{
+			sortFailed = runBenchmark(&results[0], "store", benchSort, benchSortSetup, &sortBench, 1, &options.bench) == -1;
+		}
+		if (sortFailed)
+		{
+			free(inputData);
+			free(sortedData);
+			free(searchData);
+			return -1;
+		}
+		comparisons = sortBench.comparisons;
+		swaps = sortBench.swaps;
+
+		//the times of the phases are averaged over all the sorts
+		phases = sortBench.phases;
+		phases.sampleTime /= results[0].totalRuns;
+		phases.partitionTime /= results[0].totalRuns;
+		phases.sortTime /= results[0].totalRuns;
+
+		//write the snapshot of the sorted array for the next runs
+		if (options.snapshotFile != NULL && saveSortedSnapshot(options.snapshotFile, sortedData, inputSize, options.sortEngine, comparisons, swaps, argv[1]) == -1)
+		{
+			free(inputData);
+			free(sortedData);
+			free(searchData);
+			return -1;
+		}
+	}
+
+	//build the index of the search engine over the sorted array once
+	SearchIndex index;
+	double indexStart = wallTime();
+	if (buildSearchIndex(&index, options.searchEngine, sortedArray, inputSize) == -1)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		free(inputData);
+		free(sortedData);
+		free(searchData);
+		if (useSnapshot)
+		{
+			closeSnapshot(&snapshot);
+		}
+		return -1;
+	}
+	float indexTime = (float)(wallTime() - indexStart);
+
+	//build the Bloom filter in front of the searches, timed separately like the index
+	BloomFilter filter;
+	initBloomFilter(&filter);
+	float filterTime = 0.0f;
+	if (options.filterBits > 0)
+	{
+		double filterStart = wallTime();
+		if (buildSortedFilter(&filter, sortedArray, inputSize, options.filterBits) == -1)
+		{
+			printf("Error: couldn't allocate memory!\n");
+			free(inputData);
+			free(sortedData);
+			free(searchData);
+			deleteSearchIndex(&index);
+			if (useSnapshot)
+			{
+				closeSnapshot(&snapshot);
+			}
+			return -1;
+		}
+		filterTime = (float)(wallTime() - filterStart);
+	}
+
+	//answer the lookups of the clients with the sorted array until the server is stopped
+	if (options.serveAddress != NULL)
+	{
+		SortedServer sortedServer = { &index, &filter, 0, 0 };
+		int result = serveSorted(&sortedServer, options.serveAddress, useSnapshot ? NULL : argv[1], inputSize, options.sortEngine, comparisons, swaps,
+			indexTime, filterTime, &inputLoad, &results[0], &phases);
+
+		//free the memory
+		free(inputData);
+		free(sortedData);
+		free(searchData);
+		deleteSearchIndex(&index);
+		deleteBloomFilter(&filter);
+		if (useSnapshot)
+		{
+			closeSnapshot(&snapshot);
+		}
+
+		return result;
+	}
+	
+	//search for the streamed values once, printing the results as they are found
+	if (options.stream)
+	{
+		printStatsHeader(useSnapshot ? NULL : argv[1], argv[2], inputSize, options.sortEngine, options.searchEngine);
+		printf("\n");
+		printStorageDetails(options.sortEngine, comparisons, swaps, &index, indexTime);
+		printf("Retrieval details:\n\n");
+
+		long long numSearched;
+		long long numFound;
+		long long numMisses;
+		long long numFalsePositives;
+		int result = streamSearch(&index, &filter, argv[2], &numSearched, &numFound, &searchLoad, options.bench.perfCounters, &results[1],
+			&numMisses, &numFalsePositives);
+		if (result == 0)
+		{
+			printf("\nNumber of items searched: %lld\n", numSearched);
+			printf("Number of items found: %lld\n", numFound);
+			printSearchCounters(&index);
+			if (filter.blocks != NULL)
+			{
+				printBloomFilter(&filter, filterTime, numMisses, numFalsePositives);
+			}
+			printExecutionTimes(useSnapshot ? NULL : argv[1], &inputLoad, &searchLoad, &results[0], &phases, &results[1]);
+		}
+		if (result == 0 && options.bench.reportFile != NULL)
+		{
+			result = writeSortedReport(&options.bench, useSnapshot ? NULL : argv[1], inputSize, numSearched, options.sortEngine, phases.numThreads,
+				options.searchEngine, results, options.filterBits);
+		}
+
+		//free the memory
+		free(inputData);
+		free(sortedData);
+		free(searchData);
+		deleteSearchIndex(&index);
+		deleteBloomFilter(&filter);
+		if (useSnapshot)
+		{
+			closeSnapshot(&snapshot);
+		}
+
+		return result;
+	}
+
+	//try to allocate memory for the array of the indices where the corresponding search elements were found in the input array
+	int* positions = (int*)malloc(sizeof(int) * MAX_SEARCH_SIZE);
+	if (positions == NULL)
+	{
+		//unable to allocate memory, free memory and exit
+		printf("Error: couldn't allocate memory!\n");
+		free(inputData);
+		free(sortedData);
+		free(searchData);
+		deleteSearchIndex(&index);
+		deleteBloomFilter(&filter);
+		if (useSnapshot)
+		{
+			closeSnapshot(&snapshot);
+		}
+		return -1;
+	}
+
+	//search for all the values, repeated by the benchmark harness for measuring the time of one search
+	SearchBench searchBench = { &index, &filter, searchData, searchSize, positions };
+	if (runBenchmark(&results[1], "retrieve", benchSearch, NULL, &searchBench, searchSize, &options.bench) == -1)
+	{
+		free(inputData);
+		free(sortedData);
+		free(searchData);
+		free(positions);
+		deleteSearchIndex(&index);
+		deleteBloomFilter(&filter);
+		if (useSnapshot)
+		{
+			closeSnapshot(&snapshot);
+		}
+		return -1;
+	}
+	countSearchProbes(&index, &filter, searchData, searchSize);
+	
+	//print the stats
+	printStats(useSnapshot ? NULL : argv[1], argv[2], inputSize, searchData, searchSize, positions, options.sortEngine, comparisons, swaps, &index, indexTime, &inputLoad, &searchLoad, &results[0], &phases, &results[1], &filter, filterTime);
+
+	//append the measured times to the report
+	int result = 0;
+	if (options.bench.reportFile != NULL)
+	{
+		result = writeSortedReport(&options.bench, useSnapshot ? NULL : argv[1], inputSize, searchSize, options.sortEngine, phases.numThreads,
+			options.searchEngine, results, options.filterBits);
+	}
+
+	//free the memory
+	free(inputData);
+	free(sortedData);
+	free(searchData);
+	free(positions);
+	deleteSearchIndex(&index);
+	deleteBloomFilter(&filter);
+	if (useSnapshot)
+	{
+		closeSnapshot(&snapshot);
+	}
+
+	return result;
+}
@@ -0,0 +1,447 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+//the size sweep: generates workloads of growing size with the workload program and runs the hash and sorted programs on each of them,
+//the hash program once for every load factor of the table, and collects the store and retrieve times they report into one CSV file
+//every line of the CSV file is a line of the reports of the programs (see benchmark.h) preceded by the distribution of the stored values,
+//the hit ratio of the retrieval values and the load factor the hash table reached after storing (empty for the sorted program)
+
+#define MAX_SWEEP_VALUES 32 //the maximum number of sizes, distributions or load factors of a sweep
+#define MAX_PATH_LENGTH 4096 //the maximum length of the paths of the programs and of the files of the sweep
+#define MAX_REPORT_LINE 8192 //the maximum length of a line of a report
+const int MAX_SELECTION_SIZE = 100000; //selection sort is O(n^2), larger inputs are not sorted by it
+
+//the settings of the sweep
+typedef struct Sweep Sweep;
+struct Sweep
+{
+	char* outputFile; //the CSV file the results are written to
+	int sizes[MAX_SWEEP_VALUES]; //the numbers of stored values (--sizes)
+	int numSizes; //the number of sizes
+	char* distributions[MAX_SWEEP_VALUES]; //the distributions of the stored values, as the workload program takes them (--distributions)
+	int numDistributions; //the number of distributions
+	double loads[MAX_SWEEP_VALUES]; //the load factors of the hash table (--loads)
+	int numLoads; //the number of load factors
+	char* hitRatio; //the fraction of the retrieval values that are stored (--hit-ratio)
+	char* searchSize; //the number of retrieval values (--search-size)
+	char* hashEngine; //the engine of the hash program (--engine)
+	char* sortEngine; //the sort engine of the sorted program (--sort)
+	char* searchEngine; //the search engine of the sorted program (--search)
+	char* numWarmups; //the number of warm-up trials of the programs (--warmup)
+	char* numTrials; //the number of timed trials of the programs (--trials)
+	char* binDir; //the directory with the hash, sorted and workload programs (--bin-dir)
+	char* workDir; //the directory where the generated files are written (--work-dir)
+};
+
+//runs a program with its output discarded and waits for it to finish
+//argv: the path to the program and its arguments, terminated by NULL
+//returns: 0 if the program ran and returned 0, -1 otherwise
+int runProgram(char* argv[])
+{
+	fflush(stdout);
+
+	pid_t child = fork();
+	if (child == -1)
+	{
+		return -1;
+	}
+
+	if (child == 0)
+	{
+		int null = open("/dev/null", O_WRONLY);
+		if (null != -1)
+		{
+			dup2(null, STDOUT_FILENO);
+			close(null);
+		}
+		execv(argv[0], argv);
+		_exit(127);
+	}
+
+	int status;
+	if (waitpid(child, &status, 0) == -1)
+	{
+		return -1;
+	}
+
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+//reads the number of stored values and the size of the hash table from a line of a CSV report
+//line: the line, its columns start with the program, the method, the input file, the number of stored values and the size of the table
+//inputSize: the number of stored values is saved here
+//tableSize: the size of the hash table after storing is saved here, 0 for the sorted program
+//returns: 0 on success, -1 if the line doesn't start with these columns
+int reportSizes(const char* line, long long* inputSize, long long* tableSize)
+{
+	//neither the program nor the method has a comma
+	for (int i = 0; i < 2; ++i)
+	{
+		line = strchr(line, ',');
+		if (line == NULL)
+		{
+			return -1;
+		}
+		line++;
+	}
+
+	//the input file is quoted when it has a comma, with the quotes inside it doubled
+	if (*line == '"')
+	{
+		line++;
+		while (*line != '\0' && !(line[0] == '"' && line[1] != '"'))
+		{
+			line += line[0] == '"' ? 2 : 1;
+		}
+		if (*line == '\0')
+		{
+			return -1;
+		}
+		line++;
+	}
+	else
+	{
+		line = strchr(line, ',');
+		if (line == NULL)
+		{
+			return -1;
+		}
+	}
+
+	return sscanf(line, ",%lld,%lld", inputSize, tableSize) == 2 ? 0 : -1;
+}
+
+//appends the lines of a report to the output file, each preceded by the columns of the sweep, and deletes the report
+//the load factor column is the load the hash table reached, taken from the number of stored values and the size of the table of the line
+//reportFile: the path to the report written by a program
+//output: the output file
+//prefix: the distribution and the hit ratio, separated by a comma
+//headerWritten: pointer to whether the line of column names was written, it is written with the first report
+//returns: 0 on success, -1 if the report could not be read
+int appendReport(char* reportFile, FILE* output, char* prefix, int* headerWritten)
+{
+	FILE* report = fopen(reportFile, "r");
+	if (report == NULL)
+	{
+		printf("Error: cannot open report file %s!\n", reportFile);
+		return -1;
+	}
+
+	char line[MAX_REPORT_LINE];
+	int isHeader = 1;
+	while (fgets(line, sizeof(line), report) != NULL)
+	{
+		if (isHeader)
+		{
+			if (!*headerWritten)
+			{
+				fprintf(output, "distribution,hit_ratio,load_factor,%s", line);
+				*headerWritten = 1;
+			}
+			isHeader = 0;
+			continue;
+		}
+
+		long long inputSize;
+		long long tableSize;
+		if (reportSizes(line, &inputSize, &tableSize) == 0 && tableSize > 0)
+		{
+			fprintf(output, "%s,%.4g,%s", prefix, (double)inputSize / tableSize, line);
+		}
+		else
+		{
+			fprintf(output, "%s,,%s", prefix, line);
+		}
+	}
+
+	fclose(report);
+	remove(reportFile);
+	fflush(output);
+
+	return 0;
+}
+
+//splits a comma-separated list
+//list: the list, the commas are replaced by terminating characters
+//values: array of MAX_SWEEP_VALUES pointers where the values are saved
+//returns: the number of values, -1 if there are more than MAX_SWEEP_VALUES of them
+int splitList(char* list, char** values)
+{
+	int count = 0;
+	for (char* value = strtok(list, ","); value != NULL; value = strtok(NULL, ","))
+	{
+		if (count == MAX_SWEEP_VALUES)
+		{
+			printf("Error: a list may have at most %d values!\n", MAX_SWEEP_VALUES);
+			return -1;
+		}
+		values[count++] = value;
+	}
+
+	return count;
+}
+
+//parses the optional arguments
+//argc: the number of arguments
+//argv: the arguments, the options start after the required argument
+//sweep: pointer to the settings that are changed
+//returns: 0 on success, -1 if an option is unknown or has an invalid value
+int parseOptions(int argc, char* argv[], Sweep* sweep)
+{
+	static char defaultSizes[] = "10,100,1000,10000,100000,1000000,10000000,100000000";
+	static char defaultDistributions[] = "random,ascending,descending";
+	static char defaultLoads[] = "0.5,0.75,0.9";
+	char* sizes = defaultSizes;
+	char* distributions = defaultDistributions;
+	char* loads = defaultLoads;
+
+	sweep->hitRatio = "0.5";
+	sweep->searchSize = "1000";
+	sweep->hashEngine = "classic";
+	sweep->sortEngine = "pdqsort";
+	sweep->searchEngine = "binary";
+	sweep->numWarmups = "1";
+	sweep->numTrials = "5";
+	sweep->binDir = ".";
+	sweep->workDir = ".";
+
+	for (int i = 2; i < argc; ++i)
+	{
+		//all the options take a value
+		if (i + 1 >= argc)
+		{
+			printf("Error: option %s requires a value!\n", argv[i]);
+			return -1;
+		}
+
+		char* option = argv[i];
+		char* value = argv[++i];
+		if (strcmp(option, "--sizes") == 0)
+		{
+			sizes = value;
+		}
+		else if (strcmp(option, "--distributions") == 0)
+		{
+			distributions = value;
+		}
+		else if (strcmp(option, "--loads") == 0)
+		{
+			loads = value;
+		}
+		else if (strcmp(option, "--hit-ratio") == 0)
+		{
+			sweep->hitRatio = value;
+		}
+		else if (strcmp(option, "--search-size") == 0)
+		{
+			sweep->searchSize = value;
+		}
+		else if (strcmp(option, "--engine") == 0)
+		{
+			sweep->hashEngine = value;
+		}
+		else if (strcmp(option, "--sort") == 0)
+		{
+			sweep->sortEngine = value;
+		}
+		else if (strcmp(option, "--search") == 0)
+		{
+			sweep->searchEngine = value;
+		}
+		else if (strcmp(option, "--warmup") == 0)
+		{
+			sweep->numWarmups = value;
+		}
+		else if (strcmp(option, "--trials") == 0)
+		{
+			sweep->numTrials = value;
+		}
+		else if (strcmp(option, "--bin-dir") == 0)
+		{
+			sweep->binDir = value;
+		}
+		else if (strcmp(option, "--work-dir") == 0)
+		{
+			sweep->workDir = value;
+		}
+		else
+		{
+			printf("Error: unknown option %s!\n", option);
+			return -1;
+		}
+	}
+
+	char* values[MAX_SWEEP_VALUES];
+	sweep->numSizes = splitList(sizes, values);
+	for (int i = 0; i < sweep->numSizes; ++i)
+	{
+		sweep->sizes[i] = atoi(values[i]);
+		if (sweep->sizes[i] < 1)
+		{
+			printf("Error: sizes must be greater than 0!\n");
+			return -1;
+		}
+	}
+
+	sweep->numDistributions = splitList(distributions, sweep->distributions);
+
+	sweep->numLoads = splitList(loads, values);
+	for (int i = 0; i < sweep->numLoads; ++i)
+	{
+		sweep->loads[i] = atof(values[i]);
+		if (sweep->loads[i] <= 0.0 || sweep->loads[i] > 1.0)
+		{
+			printf("Error: load factors must be greater than 0 and at most 1!\n");
+			return -1;
+		}
+	}
+
+	if (sweep->numSizes <= 0 || sweep->numDistributions <= 0 || sweep->numLoads <= 0)
+	{
+		printf("Error: the lists of sizes, distributions and load factors must not be empty!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+//runs the programs on one workload and appends their results to the output file
+//sweep: pointer to the settings of the sweep
+//distribution: the distribution of the stored values
+//size: the number of stored values
+//output: the output file
+//headerWritten: pointer to whether the line of column names was written
+//returns: 0 on success, -1 if a program failed
+int runWorkload(Sweep* sweep, char* distribution, int size, FILE* output, int* headerWritten)
+{
+	char workloadProgram[MAX_PATH_LENGTH];
+	char hashProgram[MAX_PATH_LENGTH];
+	char sortedProgram[MAX_PATH_LENGTH];
+	char inputFile[MAX_PATH_LENGTH];
+	char searchFile[MAX_PATH_LENGTH];
+	char reportFile[MAX_PATH_LENGTH];
+	snprintf(workloadProgram, sizeof(workloadProgram), "%s/workload", sweep->binDir);
+	snprintf(hashProgram, sizeof(hashProgram), "%s/hash", sweep->binDir);
+	snprintf(sortedProgram, sizeof(sortedProgram), "%s/sorted", sweep->binDir);
+	snprintf(inputFile, sizeof(inputFile), "%s/sweep_input.txt", sweep->workDir);
+	snprintf(searchFile, sizeof(searchFile), "%s/sweep_find.txt", sweep->workDir);
+	snprintf(reportFile, sizeof(reportFile), "%s/sweep_report.csv", sweep->workDir);
+
+	char sizeText[16];
+	snprintf(sizeText, sizeof(sizeText), "%d", size);
+	remove(reportFile);
+
+	printf("%s data, %d values:", distribution, size);
+
+	char* workloadArgs[] = { workloadProgram, inputFile, searchFile, sizeText, "--distribution", distribution, "--hit-ratio", sweep->hitRatio,
+		"--search-size", sweep->searchSize, NULL };
+	if (runProgram(workloadArgs) == -1)
+	{
+		printf("\nError: %s failed!\n", workloadProgram);
+		return -1;
+	}
+
+	char prefix[MAX_PATH_LENGTH];
+	snprintf(prefix, sizeof(prefix), "%s,%s", distribution, sweep->hitRatio);
+	for (int i = 0; i < sweep->numLoads; ++i)
+	{
+		//the table is sized so that the stored values fill it to the load factor
+		double tableSize = ceil(size / sweep->loads[i]);
+		if (tableSize > 0x7fffffff)
+		{
+			printf(" hash table for load %.2f too large,", sweep->loads[i]);
+			continue;
+		}
+		char tableSizeText[16];
+		snprintf(tableSizeText, sizeof(tableSizeText), "%.0f", tableSize);
+
+		//the table must not grow before it reaches the load factor, so its maximum load is the load factor,
+		//or no cap at all for the classic engine, whose table grows only when its probe sequence finds no empty entry
+		char maxLoadText[16];
+		snprintf(maxLoadText, sizeof(maxLoadText), "%.4g", strcmp(sweep->hashEngine, "classic") == 0 ? 1.0 : sweep->loads[i]);
+
+		printf(" hash at load %.2f,", sweep->loads[i]);
+		char* hashArgs[] = { hashProgram, inputFile, searchFile, tableSizeText, "--engine", sweep->hashEngine, "--max-load", maxLoadText, "--no-collisions",
+			"--warmup", sweep->numWarmups, "--trials", sweep->numTrials, "--report", reportFile, NULL };
+		if (runProgram(hashArgs) == -1)
+		{
+			printf("\nError: %s failed!\n", hashProgram);
+			return -1;
+		}
+
+		if (appendReport(reportFile, output, prefix, headerWritten) == -1)
+		{
+			return -1;
+		}
+	}
+
+	if (strcmp(sweep->sortEngine, "selection") == 0 && size > MAX_SELECTION_SIZE)
+	{
+		printf(" sorted skipped (selection sort)\n");
+		return 0;
+	}
+
+	printf(" sorted\n");
+	char* sortedArgs[] = { sortedProgram, inputFile, searchFile, "--sort", sweep->sortEngine, "--search", sweep->searchEngine,
+		"--warmup", sweep->numWarmups, "--trials", sweep->numTrials, "--report", reportFile, NULL };
+	if (runProgram(sortedArgs) == -1)
+	{
+		printf("Error: %s failed!\n", sortedProgram);
+		return -1;
+	}
+
+	return appendReport(reportFile, output, prefix, headerWritten);
+}
+
+int main(int argc, char* argv[])
+{
+	//check the number of arguments
+	if (argc < 2)
+	{
+		printf("Error: 1 argument required!\n");
+		printf("Usage: %s <output CSV file> [options]\n", argv[0]);
+		return -1;
+	}
+
+	Sweep sweep;
+	sweep.outputFile = argv[1];
+	if (parseOptions(argc, argv, &sweep) == -1)
+	{
+		return -1;
+	}
+
+	FILE* output = fopen(sweep.outputFile, "w");
+	if (output == NULL)
+	{
+		printf("Error: cannot open file %s!\n", sweep.outputFile);
+		return -1;
+	}
+
+	int headerWritten = 0;
+	int result = 0;
+	for (int i = 0; i < sweep.numDistributions && result == 0; ++i)
+	{
+		for (int j = 0; j < sweep.numSizes && result == 0; ++j)
+		{
+			result = runWorkload(&sweep, sweep.distributions[i], sweep.sizes[j], output, &headerWritten);
+		}
+	}
+
+	if (fclose(output) != 0)
+	{
+		printf("Error: cannot write file %s!\n", sweep.outputFile);
+		return -1;
+	}
+
+	if (result == 0)
+	{
+		printf("Results written to %s\n", sweep.outputFile);
+	}
+
+	return result;
+}
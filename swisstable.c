@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "hashpolicy.h"
+#include "swisstable.h"
+
+const int CACHE_LINE_SIZE = 64; //the alignment of the arrays of control bytes and keys
+
+unsigned int swissHash(int key)
+{
+	return hashMurmur(key);
+}
+
+//computes the bit mask of the slots of a group whose control byte equals the given byte
+//group: pointer to the control bytes of the group
+//tag: the control byte to look for
+//returns: bit i is set if the control byte of slot i of the group equals the tag
+static inline unsigned int matchByte(const signed char* group, signed char tag)
+{
+#if defined(__AVX2__)
+	__m256i control = _mm256_loadu_si256((const __m256i*)group);
+	return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(control, _mm256_set1_epi8(tag)));
+#elif defined(__SSE2__)
+	__m128i control = _mm_loadu_si128((const __m128i*)group);
+	return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(tag)));
+#else
+	unsigned int mask = 0;
+	for (int i = 0; i < SWISS_GROUP_SIZE; ++i)
+	{
+		mask |= (unsigned int)(group[i] == tag) << i;
+	}
+	return mask;
+#endif
+}
+
+//computes the bit mask of the empty slots of a group
+//empty slots are the only ones whose control byte has the highest bit set, so the mask is just the sign bits
+//group: pointer to the control bytes of the group
+//returns: bit i is set if slot i of the group is empty
+static inline unsigned int matchEmpty(const signed char* group)
+{
+#if defined(__AVX2__)
+	return (unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)group));
+#elif defined(__SSE2__)
+	return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+	return matchByte(group, SWISS_EMPTY);
+#endif
+}
+
+//allocates memory aligned to a cache line
+//bytes: the number of bytes to allocate
+//returns: pointer to the memory, NULL if it was not possible to allocate it
+static void* allocateAligned(size_t bytes)
+{
+	//aligned_alloc requires the size to be a multiple of the alignment
+	bytes = (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+	return aligned_alloc(CACHE_LINE_SIZE, bytes);
+}
+
+//allocates the arrays of a swiss table with the given number of slots and marks all the slots as empty
+//table: pointer to the swiss table, its arrays are replaced without being freed
+//size: the number of slots
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+static int allocateSlots(SwissTable* table, int size)
+{
+	signed char* control = (signed char*)allocateAligned((size_t)size);
+	int* keys = (int*)allocateAligned((size_t)size * sizeof(int));
+	if (control == NULL || keys == NULL)
+	{
+		free(control);
+		free(keys);
+		return -1;
+	}
+
+	memset(control, SWISS_EMPTY, (size_t)size);
+
+	table->control = control;
+	table->keys = keys;
+	table->size = size;
+
+	return 0;
+}
+
+//places a key into the first empty slot of its probe sequence
+//the groups are probed in the triangular sequence g, g+1, g+3, g+6, ... which visits every group of a power of two table
+//table: pointer to the swiss table, it must have an empty slot
+//key: the key to place
+//numGroupCollisions: the number of full groups probed past is added here
+//returns: the index of the slot where the key was placed
+static int placeKey(SwissTable* table, int key, long long* numGroupCollisions)
+{
+	unsigned int h = swissHash(key);
+	unsigned int groupMask = (unsigned int)(table->size / SWISS_GROUP_SIZE) - 1;
+	unsigned int group = h & groupMask;
+
+	for (unsigned int probe = 1; ; ++probe)
+	{
+		unsigned int empty = matchEmpty(table->control + group * SWISS_GROUP_SIZE);
+		if (empty != 0)
+		{
+			int index = (int)(group * SWISS_GROUP_SIZE) + __builtin_ctz(empty);
+			table->control[index] = (signed char)(h >> 25);
+			table->keys[index] = key;
+			return index;
+		}
+
+		(*numGroupCollisions)++;
+		group = (group + probe) & groupMask;
+	}
+}
+
+//doubles the number of slots of the swiss table and places all the keys again
+//table: pointer to the swiss table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+static int growSwiss(SwissTable* table)
+{
+	if (table->size > 0x7fffffff / 2)
+	{
+		return -1;
+	}
+
+	SwissTable old = *table;
+	if (allocateSlots(table, 2 * old.size) == -1)
+	{
+		return -1;
+	}
+
+	//collisions while moving the keys are not counted, they were counted when the keys were inserted
+	long long ignored = 0;
+	for (int i = 0; i < old.size; ++i)
+	{
+		if (old.control[i] != SWISS_EMPTY)
+		{
+			placeKey(table, old.keys[i], &ignored);
+		}
+	}
+
+	free(old.control);
+	free(old.keys);
+	table->numGrowths++;
+
+	return 0;
+}
+
+int initSwiss(SwissTable* table, int size, double maxLoad)
+{
+	//round the size up to a power of two that holds at least one group
+	int roundedSize = SWISS_GROUP_SIZE;
+	while (roundedSize < size && roundedSize <= 0x7fffffff / 2)
+	{
+		roundedSize *= 2;
+	}
+
+	table->control = NULL;
+	table->keys = NULL;
+	table->numOccupied = 0;
+	table->initialSize = roundedSize;
+	table->maxLoad = maxLoad < 0.875 ? maxLoad : 0.875;
+	table->numGrowths = 0;
+	table->numGroupCollisions = 0;
+
+	return allocateSlots(table, roundedSize);
+}
+
+int resetSwiss(SwissTable* table)
+{
+	table->numOccupied = 0;
+	table->numGrowths = 0;
+	table->numGroupCollisions = 0;
+
+	//if the table grew, go back to the initial size
+	if (table->size != table->initialSize)
+	{
+		free(table->control);
+		free(table->keys);
+		table->control = NULL;
+		table->keys = NULL;
+		table->size = 0;
+
+		return allocateSlots(table, table->initialSize);
+	}
+
+	memset(table->control, SWISS_EMPTY, (size_t)table->size);
+
+	return 0;
+}
+
+int insertSwiss(SwissTable* table, int key)
+{
+	//grow the table if the insert would exceed the maximum load factor
+	if (table->numOccupied + 1 > table->maxLoad * table->size && growSwiss(table) == -1)
+	{
+		return -1;
+	}
+
+	table->numOccupied++;
+
+	return placeKey(table, key, &table->numGroupCollisions);
+}
+
+int searchSwiss(const SwissTable* table, int key)
+{
+	return searchSwissHashed(table, key, swissHash(key));
+}
+
+void prefetchSwiss(const SwissTable* table, unsigned int hash)
+{
+	unsigned int group = hash & ((unsigned int)(table->size / SWISS_GROUP_SIZE) - 1);
+
+	__builtin_prefetch(table->control + group * SWISS_GROUP_SIZE);
+
+	//the keys of a group of 32 slots span two cache lines, and the matching key can be in either of them
+	const char* keys = (const char*)(table->keys + group * SWISS_GROUP_SIZE);
+	for (int offset = 0; offset < SWISS_GROUP_SIZE * (int)sizeof(int); offset += CACHE_LINE_SIZE)
+	{
+		__builtin_prefetch(keys + offset);
+	}
+}
+
+int searchSwissHashed(const SwissTable* table, int key, unsigned int hash)
+{
+	signed char tag = (signed char)(hash >> 25);
+	unsigned int groupMask = (unsigned int)(table->size / SWISS_GROUP_SIZE) - 1;
+	unsigned int group = hash & groupMask;
+
+	for (unsigned int probe = 1; probe <= groupMask + 1; ++probe)
+	{
+		const signed char* control = table->control + group * SWISS_GROUP_SIZE;
+
+		//compare the keys only in the slots whose tag matches
+		for (unsigned int match = matchByte(control, tag); match != 0; match &= match - 1)
+		{
+			int index = (int)(group * SWISS_GROUP_SIZE) + __builtin_ctz(match);
+			if (table->keys[index] == key)
+			{
+				return index;
+			}
+		}
+
+		//the key would have been placed into this group if it was in the table
+		if (matchEmpty(control) != 0)
+		{
+			return -1;
+		}
+
+		group = (group + probe) & groupMask;
+	}
+
+	return -1;
+}
+
+void deleteSwiss(SwissTable* table)
+{
+	free(table->control);
+	free(table->keys);
+	table->control = NULL;
+	table->keys = NULL;
+	table->size = 0;
+	table->numOccupied = 0;
+}
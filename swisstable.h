@@ -0,0 +1,81 @@
+#ifndef SWISSTABLE_H
+#define SWISSTABLE_H
+
+//hash table with a swiss table layout: a dense array of one control byte per slot and a separate array of keys
+//the control byte of a slot is either SWISS_EMPTY or 7 tag bits taken from the hash of the key stored in the slot
+//the slots are divided into groups, the control bytes of a whole group are compared with the searched tag at once using SSE2 or AVX2,
+//so a lookup usually reads one line of control bytes and the line holding the matching key, and a miss ends at the first group that has an empty slot
+//the keys of a group fill one cache line with SSE2 and two with AVX2
+
+//the number of slots in a group, i.e. the number of control bytes compared at once
+#if defined(__AVX2__)
+#define SWISS_GROUP_SIZE 32
+#else
+#define SWISS_GROUP_SIZE 16
+#endif
+
+//the control byte of an empty slot, the only control byte with the highest bit set
+#define SWISS_EMPTY ((signed char)0x80)
+
+//the swiss table
+typedef struct SwissTable SwissTable;
+struct SwissTable
+{
+	signed char* control; //array of control bytes, one per slot
+	int* keys; //array of keys, one per slot
+	int size; //the number of slots, a power of two and a multiple of SWISS_GROUP_SIZE
+	int numOccupied; //the number of slots that are occupied
+	int initialSize; //the number of slots when the table is (re)created
+	double maxLoad; //the maximum allowed ratio of occupied slots to the number of slots
+	int numGrowths; //the number of times the table has grown since it was (re)created
+	long long numGroupCollisions; //the number of full groups that inserts had to probe past
+};
+
+//initializes an empty swiss table
+//table: pointer to the swiss table
+//size: the requested number of slots, it is rounded up to a power of two and to at least one group
+//maxLoad: the maximum allowed ratio of occupied slots to the number of slots, it is capped at 7/8
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int initSwiss(SwissTable* table, int size, double maxLoad);
+
+//empties the swiss table and shrinks it back to its initial number of slots
+//table: pointer to the swiss table
+//returns: 0 on success, -1 if it was not possible to allocate the memory
+int resetSwiss(SwissTable* table);
+
+//inserts a key into the swiss table, the table doubles its number of slots when the maximum load factor would be exceeded
+//table: pointer to the swiss table
+//key: the key to insert
+//returns: the index of the slot where the key was inserted, -1 if it was not possible to allocate the memory
+int insertSwiss(SwissTable* table, int key);
+
+//searches for a key in the swiss table
+//table: pointer to the swiss table
+//key: the key to search for
+//returns: the index of the slot where the key was found, -1 if it was not found
+int searchSwiss(const SwissTable* table, int key);
+
+//computes the hash of a key, the low bits select the first group of the probe sequence and the highest 7 bits are the tag
+//it mixes all the bits of the key (murmur3 finalizer), so sequential and strided keys spread over the groups
+//key: the key to hash
+//returns: the hash of the key
+unsigned int swissHash(int key);
+
+//prefetches the control bytes and all the cache lines of keys of the first group of a probe sequence
+//batched lookups call it for many keys before searching for any of them, so that the cache misses overlap
+//table: pointer to the swiss table
+//hash: the hash of the key, computed by swissHash
+void prefetchSwiss(const SwissTable* table, unsigned int hash);
+
+//searches for a key whose hash was already computed by swissHash
+//table: pointer to the swiss table
+//key: the key to search for
+//hash: the hash of the key
+//returns: the index of the slot where the key was found, -1 if it was not found
+int searchSwissHashed(const SwissTable* table, int key, unsigned int hash);
+
+//frees the dynamically allocated memory associated with the swiss table
+//table: pointer to the swiss table
+void deleteSwiss(SwissTable* table);
+
+#endif
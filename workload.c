@@ -0,0 +1,587 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+//generator of input and retrieval files for both programs:
+//the input file holds the stored values in one of several distributions, the retrieval file a mix of values that are stored (hits)
+//and values that are not (misses) in a given ratio
+//the stored values are drawn from a set of distinct ascending keys with gaps of at least 2 between them,
+//so the key after any of them (or after the last key of a cluster) is never stored and makes a miss
+
+#define WRITE_BUFFER_SIZE (1 << 20) //the size of the buffer the values are formatted into before they are written
+#define MAX_SEARCH_VALUES 100000000 //the maximum number of values of the retrieval file
+const int MAX_WORKLOAD_SIZE = 0x7fffffff / 4; //the maximum number of stored values, the keys with their gaps must fit into an int
+const int DEFAULT_SEARCH_SIZE = 1000; //the default number of values of the retrieval file, the programs search at most 1000 of them
+const double DEFAULT_HIT_RATIO = 0.5; //the default fraction of the retrieval values that are stored
+const double DEFAULT_ZIPF_EXPONENT = 0.99; //the default exponent of the zipfian distribution
+const int DEFAULT_CLUSTER_SIZE = 64; //the default number of consecutive keys of a cluster
+
+//the distributions of the stored values
+typedef enum Distribution Distribution;
+enum Distribution
+{
+	DISTRIBUTION_RANDOM, //distinct keys in random order
+	DISTRIBUTION_ASCENDING, //distinct keys sorted ascending
+	DISTRIBUTION_DESCENDING, //distinct keys sorted descending
+	DISTRIBUTION_ZIPF, //keys drawn with repetition, the key of rank k with a probability proportional to 1 / k^exponent
+	DISTRIBUTION_CLUSTERED //distinct keys in random order that come in runs of consecutive integers
+};
+
+//the settings of the generated workload
+typedef struct Workload Workload;
+struct Workload
+{
+	Distribution distribution; //the distribution of the stored values (--distribution)
+	int size; //the number of stored values
+	int searchSize; //the number of values of the retrieval file (--search-size)
+	double hitRatio; //the fraction of the retrieval values that are stored (--hit-ratio)
+	double zipfExponent; //the exponent of the zipfian distribution (--zipf-exponent)
+	int clusterSize; //the number of consecutive keys of a cluster of the clustered distribution (--cluster-size)
+	unsigned long long seed; //the seed of the random number generator (--seed)
+};
+
+//the state of a zipfian sampler by rejection-inversion (Hörmann and Derflinger), it needs no table of the probabilities
+typedef struct ZipfSampler ZipfSampler;
+struct ZipfSampler
+{
+	int numElements; //the number of ranks, the samples are from 1 to numElements
+	double exponent; //the exponent of the distribution
+	double hIntegralX1; //the integral of the hat function at 1.5, minus 1
+	double hIntegralN; //the integral of the hat function at numElements + 0.5
+	double s; //the distance from a sample within which it is accepted without a test
+};
+
+//writer of integers to a text file, one per line, through a buffer
+typedef struct ValueWriter ValueWriter;
+struct ValueWriter
+{
+	FILE* file; //the file being written
+	char* buffer; //the buffer the values are formatted into
+	size_t length; //the number of characters in the buffer
+	int error; //1 if writing the file failed
+};
+
+//advances a xorshift64* random number generator
+//state: pointer to the state of the generator, not 0
+//returns: the next random number
+unsigned long long nextRandom(unsigned long long* state)
+{
+	unsigned long long x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+
+	return x * 0x2545F4914F6CDD1Dull;
+}
+
+//draws a random number below a bound
+//state: pointer to the state of the generator
+//bound: the bound, greater than 0
+//returns: the random number, from 0 to bound - 1
+unsigned int randomBelow(unsigned long long* state, unsigned int bound)
+{
+	return (unsigned int)(((nextRandom(state) >> 32) * bound) >> 32);
+}
+
+//draws a random number between 0 and 1
+//state: pointer to the state of the generator
+//returns: the random number, at least 0 and less than 1
+double randomUnit(unsigned long long* state)
+{
+	return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//shuffles an array into a random order (Fisher-Yates)
+//values: pointer to the array
+//size: the size of the array
+//state: pointer to the state of the random number generator
+void shuffle(int* values, int size, unsigned long long* state)
+{
+	for (int i = size - 1; i > 0; --i)
+	{
+		int j = (int)randomBelow(state, (unsigned int)i + 1);
+		int value = values[i];
+		values[i] = values[j];
+		values[j] = value;
+	}
+}
+
+//compares two integers for sorting with qsort
+//a: pointer to the first integer
+//b: pointer to the second integer
+//returns: a negative number, zero or a positive number if the first integer is smaller, equal or greater
+int compareInts(const void* a, const void* b)
+{
+	int x = *(const int*)a;
+	int y = *(const int*)b;
+
+	return (x > y) - (x < y);
+}
+
+//log(1 + x) / x, with its series close to 0
+//x: the argument, greater than -1
+//returns: the value of the function
+double helper1(double x)
+{
+	return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+//(exp(x) - 1) / x, with its series close to 0
+//x: the argument
+//returns: the value of the function
+double helper2(double x)
+{
+	return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+
+//the hat function of the zipfian sampler, x^-exponent
+//sampler: pointer to the sampler
+//x: the argument
+//returns: the value of the function
+double zipfH(const ZipfSampler* sampler, double x)
+{
+	return exp(-sampler->exponent * log(x));
+}
+
+//the integral of the hat function of the zipfian sampler
+//sampler: pointer to the sampler
+//x: the argument
+//returns: the value of the integral
+double zipfHIntegral(const ZipfSampler* sampler, double x)
+{
+	double logX = log(x);
+
+	return helper2((1.0 - sampler->exponent) * logX) * logX;
+}
+
+//the inverse of the integral of the hat function of the zipfian sampler
+//sampler: pointer to the sampler
+//x: the value of the integral
+//returns: the argument of the integral
+double zipfHIntegralInverse(const ZipfSampler* sampler, double x)
+{
+	double t = x * (1.0 - sampler->exponent);
+	if (t < -1.0)
+	{
+		t = -1.0;
+	}
+
+	return exp(helper1(t) * x);
+}
+
+//initializes a zipfian sampler
+//sampler: pointer to the sampler
+//numElements: the number of ranks
+//exponent: the exponent of the distribution, greater than 0
+void initZipfSampler(ZipfSampler* sampler, int numElements, double exponent)
+{
+	sampler->numElements = numElements;
+	sampler->exponent = exponent;
+	sampler->hIntegralX1 = zipfHIntegral(sampler, 1.5) - 1.0;
+	sampler->hIntegralN = zipfHIntegral(sampler, numElements + 0.5);
+	sampler->s = 2.0 - zipfHIntegralInverse(sampler, zipfHIntegral(sampler, 2.5) - zipfH(sampler, 2.0));
+}
+
+//draws a rank from the zipfian distribution
+//sampler: pointer to the sampler
+//state: pointer to the state of the random number generator
+//returns: the rank, from 1 to the number of ranks
+int sampleZipf(const ZipfSampler* sampler, unsigned long long* state)
+{
+	while (1)
+	{
+		double u = sampler->hIntegralN + randomUnit(state) * (sampler->hIntegralX1 - sampler->hIntegralN);
+		double x = zipfHIntegralInverse(sampler, u);
+		int k = (int)(x + 0.5);
+		k = k < 1 ? 1 : k > sampler->numElements ? sampler->numElements : k;
+
+		if (k - x <= sampler->s || u >= zipfHIntegral(sampler, k + 0.5) - zipfH(sampler, k))
+		{
+			return k;
+		}
+	}
+}
+
+//fills an array with distinct ascending keys with gaps of at least 2 between them, spread over the non-negative ints
+//in the clustered distribution the keys come in runs of consecutive integers instead, and only the runs have gaps between them
+//keys: pointer to the array
+//workload: pointer to the settings of the workload
+//state: pointer to the state of the random number generator
+void generateKeys(int* keys, const Workload* workload, unsigned long long* state)
+{
+	int clusterSize = workload->distribution == DISTRIBUTION_CLUSTERED ? workload->clusterSize : 1;
+	long long numGaps = (workload->size + clusterSize - 1) / clusterSize;
+
+	//the gaps are drawn from 2 to 2 * averageGap - 2, so they average averageGap and the keys end below INT_MAX
+	long long averageGap = (0x7fffffffLL - workload->size) / numGaps;
+	unsigned int gapRange = averageGap > 2 ? (unsigned int)(2 * averageGap - 3) : 1;
+
+	long long key = randomBelow(state, (unsigned int)averageGap);
+	for (int i = 0; i < workload->size; ++i)
+	{
+		keys[i] = (int)key;
+		key += i % clusterSize == clusterSize - 1 ? 2 + randomBelow(state, gapRange) : 1;
+	}
+}
+
+//draws the index of an ascending key whose successor is not a key, the successor is a miss
+//workload: pointer to the settings of the workload
+//state: pointer to the state of the random number generator
+//returns: the index of the key
+int missIndex(const Workload* workload, unsigned long long* state)
+{
+	if (workload->distribution != DISTRIBUTION_CLUSTERED)
+	{
+		return (int)randomBelow(state, (unsigned int)workload->size);
+	}
+
+	//the last key of a random cluster
+	int numClusters = (workload->size + workload->clusterSize - 1) / workload->clusterSize;
+	int last = (int)randomBelow(state, (unsigned int)numClusters) * workload->clusterSize + workload->clusterSize - 1;
+
+	return last < workload->size ? last : workload->size - 1;
+}
+
+//initializes a writer of integers
+//writer: pointer to the writer
+//fileName: the path to the file
+//returns: 0 on success, -1 if the file could not be opened or the memory could not be allocated
+int openValueWriter(ValueWriter* writer, const char* fileName)
+{
+	writer->length = 0;
+	writer->error = 0;
+	writer->buffer = (char*)malloc(WRITE_BUFFER_SIZE);
+	writer->file = fopen(fileName, "wb");
+	if (writer->buffer == NULL || writer->file == NULL)
+	{
+		free(writer->buffer);
+		if (writer->file != NULL)
+		{
+			fclose(writer->file);
+		}
+		return -1;
+	}
+
+	return 0;
+}
+
+//writes the buffer of a writer into its file
+//writer: pointer to the writer
+void flushValueWriter(ValueWriter* writer)
+{
+	if (writer->length > 0 && fwrite(writer->buffer, 1, writer->length, writer->file) != writer->length)
+	{
+		writer->error = 1;
+	}
+	writer->length = 0;
+}
+
+//writes an integer and a line break
+//writer: pointer to the writer
+//value: the integer
+void writeValue(ValueWriter* writer, int value)
+{
+	//an int has at most 11 characters with its sign
+	if (writer->length + 12 > WRITE_BUFFER_SIZE)
+	{
+		flushValueWriter(writer);
+	}
+
+	char digits[11];
+	int numDigits = 0;
+	unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+	do
+	{
+		digits[numDigits++] = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	}
+	while (magnitude != 0);
+
+	if (value < 0)
+	{
+		writer->buffer[writer->length++] = '-';
+	}
+	while (numDigits > 0)
+	{
+		writer->buffer[writer->length++] = digits[--numDigits];
+	}
+	writer->buffer[writer->length++] = '\n';
+}
+
+//writes the rest of the buffer and closes the file
+//writer: pointer to the writer
+//returns: 0 on success, -1 if writing the file failed
+int closeValueWriter(ValueWriter* writer)
+{
+	flushValueWriter(writer);
+	writer->error |= fclose(writer->file) != 0;
+	free(writer->buffer);
+
+	return writer->error ? -1 : 0;
+}
+
+//generates the input and retrieval files of a workload
+//inputFile: the path to the input file
+//searchFile: the path to the retrieval file
+//workload: pointer to the settings of the workload
+//numHits: the number of retrieval values that are stored is saved here
+//returns: 0 on success, -1 if the memory could not be allocated or a file could not be written
+int generateWorkload(char* inputFile, char* searchFile, const Workload* workload, int* numHits)
+{
+	unsigned long long state = workload->seed != 0 ? workload->seed : 1;
+
+	int* keys = (int*)malloc(sizeof(int) * (size_t)workload->size);
+	int* searchValues = (int*)malloc(sizeof(int) * (size_t)workload->searchSize);
+	if (keys == NULL || searchValues == NULL)
+	{
+		printf("Error: couldn't allocate memory!\n");
+		free(keys);
+		free(searchValues);
+		return -1;
+	}
+
+	generateKeys(keys, workload, &state);
+
+	ZipfSampler sampler;
+	initZipfSampler(&sampler, workload->size, workload->zipfExponent);
+
+	//the misses are drawn while the keys are still ascending
+	*numHits = (int)(workload->searchSize * workload->hitRatio + 0.5);
+	for (int i = *numHits; i < workload->searchSize; ++i)
+	{
+		searchValues[i] = keys[missIndex(workload, &state)] + 1;
+	}
+
+	//the zipfian keys are shuffled before they are ranked, so that the frequent keys are not all small ones
+	if (workload->distribution != DISTRIBUTION_ASCENDING && workload->distribution != DISTRIBUTION_DESCENDING)
+	{
+		shuffle(keys, workload->size, &state);
+	}
+
+	//the hits are the values at random positions of the input file, so they follow its distribution, the positions are replaced
+	//by their values while the file is written
+	for (int i = 0; i < *numHits; ++i)
+	{
+		searchValues[i] = (int)randomBelow(&state, (unsigned int)workload->size);
+	}
+	qsort(searchValues, *numHits, sizeof(int), compareInts);
+	int nextHit = 0;
+
+	ValueWriter writer;
+	if (openValueWriter(&writer, inputFile) == -1)
+	{
+		printf("Error: cannot open file %s!\n", inputFile);
+		free(keys);
+		free(searchValues);
+		return -1;
+	}
+	for (int i = 0; i < workload->size; ++i)
+	{
+		int value;
+		switch (workload->distribution)
+		{
+		case DISTRIBUTION_DESCENDING:
+			value = keys[workload->size - 1 - i];
+			break;
+		case DISTRIBUTION_ZIPF:
+			value = keys[sampleZipf(&sampler, &state) - 1];
+			break;
+		default:
+			value = keys[i];
+			break;
+		}
+		writeValue(&writer, value);
+
+		while (nextHit < *numHits && searchValues[nextHit] == i)
+		{
+			searchValues[nextHit++] = value;
+		}
+	}
+	int failed = closeValueWriter(&writer) == -1;
+
+	//the hits and misses are mixed
+	shuffle(searchValues, workload->searchSize, &state);
+
+	if (!failed && openValueWriter(&writer, searchFile) == -1)
+	{
+		printf("Error: cannot open file %s!\n", searchFile);
+		free(keys);
+		free(searchValues);
+		return -1;
+	}
+	for (int i = 0; !failed && i < workload->searchSize; ++i)
+	{
+		writeValue(&writer, searchValues[i]);
+	}
+	failed = failed || closeValueWriter(&writer) == -1;
+
+	free(keys);
+	free(searchValues);
+
+	if (failed)
+	{
+		printf("Error: cannot write the workload files!\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+//returns the name of a distribution as it is given on the command line
+//distribution: the distribution
+//returns: the name of the distribution
+const char* distributionName(Distribution distribution)
+{
+	switch (distribution)
+	{
+	case DISTRIBUTION_ASCENDING:
+		return "ascending";
+	case DISTRIBUTION_DESCENDING:
+		return "descending";
+	case DISTRIBUTION_ZIPF:
+		return "zipf";
+	case DISTRIBUTION_CLUSTERED:
+		return "clustered";
+	default:
+		return "random";
+	}
+}
+
+//parses the optional arguments
+//argc: the number of arguments
+//argv: the arguments, the options start after the three required arguments
+//workload: pointer to the settings that are changed
+//returns: 0 on success, -1 if an option is unknown or has an invalid value
+int parseOptions(int argc, char* argv[], Workload* workload)
+{
+	workload->distribution = DISTRIBUTION_RANDOM;
+	workload->searchSize = DEFAULT_SEARCH_SIZE;
+	workload->hitRatio = DEFAULT_HIT_RATIO;
+	workload->zipfExponent = DEFAULT_ZIPF_EXPONENT;
+	workload->clusterSize = DEFAULT_CLUSTER_SIZE;
+	workload->seed = 1;
+
+	for (int i = 4; i < argc; ++i)
+	{
+		//all the options take a value
+		if (i + 1 >= argc)
+		{
+			printf("Error: option %s requires a value!\n", argv[i]);
+			return -1;
+		}
+
+		if (strcmp(argv[i], "--distribution") == 0)
+		{
+			++i;
+			if (strcmp(argv[i], "random") == 0)
+			{
+				workload->distribution = DISTRIBUTION_RANDOM;
+			}
+			else if (strcmp(argv[i], "ascending") == 0)
+			{
+				workload->distribution = DISTRIBUTION_ASCENDING;
+			}
+			else if (strcmp(argv[i], "descending") == 0)
+			{
+				workload->distribution = DISTRIBUTION_DESCENDING;
+			}
+			else if (strcmp(argv[i], "zipf") == 0)
+			{
+				workload->distribution = DISTRIBUTION_ZIPF;
+			}
+			else if (strcmp(argv[i], "clustered") == 0)
+			{
+				workload->distribution = DISTRIBUTION_CLUSTERED;
+			}
+			else
+			{
+				printf("Error: unknown distribution %s!\n", argv[i]);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--search-size") == 0)
+		{
+			workload->searchSize = atoi(argv[++i]);
+			if (workload->searchSize < 1 || workload->searchSize > MAX_SEARCH_VALUES)
+			{
+				printf("Error: the number of retrieval values must be from 1 to %d!\n", MAX_SEARCH_VALUES);
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--hit-ratio") == 0)
+		{
+			workload->hitRatio = atof(argv[++i]);
+			if (workload->hitRatio < 0.0 || workload->hitRatio > 1.0)
+			{
+				printf("Error: the hit ratio must be from 0 to 1!\n");
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--zipf-exponent") == 0)
+		{
+			workload->zipfExponent = atof(argv[++i]);
+			if (workload->zipfExponent <= 0.0)
+			{
+				printf("Error: the zipf exponent must be greater than 0!\n");
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--cluster-size") == 0)
+		{
+			workload->clusterSize = atoi(argv[++i]);
+			if (workload->clusterSize < 1)
+			{
+				printf("Error: the cluster size must be greater than 0!\n");
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "--seed") == 0)
+		{
+			workload->seed = strtoull(argv[++i], NULL, 10);
+		}
+		else
+		{
+			printf("Error: unknown option %s!\n", argv[i]);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	//check the number of arguments
+	if (argc < 4)
+	{
+		printf("Error: 3 arguments required!\n");
+		printf("Usage: %s <input file> <retrieval file> <number of stored values> [options]\n", argv[0]);
+		return -1;
+	}
+
+	Workload workload;
+	if (parseOptions(argc, argv, &workload) == -1)
+	{
+		return -1;
+	}
+
+	workload.size = atoi(argv[3]);
+	if (workload.size < 1 || workload.size > MAX_WORKLOAD_SIZE)
+	{
+		printf("Error: the number of stored values must be from 1 to %d!\n", MAX_WORKLOAD_SIZE);
+		return -1;
+	}
+
+	int numHits;
+	if (generateWorkload(argv[1], argv[2], &workload, &numHits) == -1)
+	{
+		return -1;
+	}
+
+	printf("Generated %d %s values into %s and %d retrieval values (%d stored, %d not stored) into %s\n", workload.size,
+		distributionName(workload.distribution), argv[1], workload.searchSize, numHits, workload.searchSize - numHits, argv[2]);
+
+	return 0;
+}